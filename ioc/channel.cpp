@@ -8,11 +8,15 @@
  */
 
 #include <string>
+#include <unordered_map>
 
 #include <dbAccess.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
 
 #include "channel.h"
 #include "dbentry.h"
+#include "qsrvpvt.h"
 #include "utilpvt.h"
 
 #ifndef PVLINK_STRINGSZ
@@ -21,6 +25,81 @@
 
 namespace pvxs {
 namespace ioc {
+
+namespace {
+struct SharedChannels {
+    struct Entry {
+        std::weak_ptr<dbChannel> chan;
+        const char *form = nullptr;
+    };
+    epicsMutex lock;
+    // guarded by lock.  Only filter-free channels
+    std::unordered_map<std::string, Entry> byName;
+} *sharedChannels;
+
+void sharedChannelsInit()
+{
+    sharedChannels = new SharedChannels;
+}
+} // namespace
+
+Channel Channel::shared(const std::string& name)
+{
+    threadOnce<&sharedChannelsInit>();
+    auto& gbl = *sharedChannels;
+    {
+        epicsGuard<epicsMutex> G(gbl.lock);
+        auto it(gbl.byName.find(name));
+        if(it!=gbl.byName.end()) {
+            Channel ret;
+            ret.chan = it->second.chan.lock();
+            ret.form = it->second.form;
+            if(ret)
+                return ret;
+        }
+    }
+
+    // parse and open outside of lock
+    Channel ret(name);
+    if(ellCount(&ret.chan->filters))
+        return ret; // may hold per-channel filter state.  Not shared
+
+    // dbChannelDelete() when the last user is done
+    std::shared_ptr<dbChannel> inner(std::move(ret.chan));
+    ret.chan.reset(inner.get(), [inner, name](dbChannel*) {
+        auto& gbl = *sharedChannels;
+        epicsGuard<epicsMutex> G(gbl.lock);
+        auto it(gbl.byName.find(name));
+        if(it!=gbl.byName.end() && it->second.chan.expired())
+            gbl.byName.erase(it);
+        // inner (the dbChannel) released with this deleter
+    });
+
+    epicsGuard<epicsMutex> G(gbl.lock);
+    auto& ent = gbl.byName[name];
+    if(auto other = ent.chan.lock()) {
+        // raced with another caller.  Use the first
+        Channel first;
+        first.chan = std::move(other);
+        first.form = ent.form;
+        return first;
+    }
+    ent.chan = ret.chan;
+    ent.form = ret.form;
+    return ret;
+}
+
+long testqsrvSharedChannelUsers(const char* name)
+{
+    threadOnce<&sharedChannelsInit>();
+    auto& gbl = *sharedChannels;
+    epicsGuard<epicsMutex> G(gbl.lock);
+    auto it(gbl.byName.find(name));
+    if(it==gbl.byName.end())
+        return 0;
+    return it->second.chan.use_count();
+}
+
 /**
  * Construct a group channel from a given db channel name
  *
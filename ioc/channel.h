@@ -50,6 +50,14 @@ public:
         :Channel(name.c_str())
     {}
 
+    /** Open, or re-use, a dbChannel.
+     *
+     * Channels without server side filters hold no per-channel state,
+     * and so one is shared by all callers using the same name.
+     * Names with filters always open a new dbChannel.
+     */
+    static Channel shared(const std::string& name);
+
     Channel& operator=(const Channel&) = default;
     Channel& operator=(Channel&&) = default;
 
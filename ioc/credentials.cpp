@@ -26,7 +26,13 @@ namespace ioc {
 Credentials::Credentials(const server::ClientCredentials& clientCredentials) {
     // Extract host name part (or whole thing if no colon present)
     auto pos = clientCredentials.peer.find_first_of(':');
-    host = clientCredentials.peer.substr(0, pos);
+    if (clientCredentials.peer.compare(0, 5u, "unix:") == 0) {
+        // local (AF_UNIX) socket is always the same host.
+        // The account is that of the peer process.  cf. server::ClientCredentials
+        host = "127.0.0.1";
+    } else {
+        host = clientCredentials.peer.substr(0, pos);
+    }
 
     // "ca" style credentials
     if (clientCredentials.method == "ca") {
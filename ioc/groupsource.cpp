@@ -10,6 +10,7 @@
 #include <string>
 
 #include <dbEvent.h>
+#include <epicsGuard.h>
 #include <dbChannel.h>
 #include <special.h>
 
@@ -132,10 +133,12 @@ void GroupSource::show(std::ostream& outputStream) {
  * @param groupSubscriptionCtx the group subscription context
  */
 void GroupSource::onDisableSubscription(const std::shared_ptr<GroupSourceSubscriptionCtx>& groupSubscriptionCtx) {
+    SubscriptionCache::remove(&groupSubscriptionCtx->group, groupSubscriptionCtx.get());
     for (auto& fieldSubscriptionCtx: groupSubscriptionCtx->fieldSubscriptionContexts) {
         fieldSubscriptionCtx.pValueEventSubscription.disable();
         fieldSubscriptionCtx.pPropertiesEventSubscription.disable();
     }
+    epicsGuard<epicsMutex> G(groupSubscriptionCtx->eventLock);
     groupSubscriptionCtx->eventsEnabled = false;
 }
 
@@ -168,13 +171,14 @@ void GroupSource::onOp(Group& group,
             ->onPut([&group, securityCache](std::unique_ptr<server::ExecOp>&& putOperation, Value&& value) {
                 if (!securityCache->done) {
                     // First time we call put we need to initialise the security cache
+                    auto& cred = putOperation->credentials();
                     securityCache->securityClients.resize(group.fields.size());
-                    securityCache->credentials.reset(new Credentials(*putOperation->credentials()));
+                    securityCache->credentials = SecurityClientCache::credentials(cred);
                     auto fieldIndex = 0u;
                     for (auto& field: group.fields) {
                         if (field.value) {
-                            securityCache->securityClients[fieldIndex]
-                                    .update(field.value, *securityCache->credentials);
+                            securityCache->securityClients[fieldIndex] = SecurityClientCache::client(cred,
+                                    *securityCache->credentials, field.value);
                         }
                         fieldIndex++;
                     }
@@ -243,13 +247,29 @@ void subscriptionPost(GroupSourceSubscriptionCtx *pGroupCtx)
  * @param groupSubscriptionCtx the group subscription context containing the field event subscriptions to start
  */
 void GroupSource::onStartSubscription(const std::shared_ptr<GroupSourceSubscriptionCtx>& groupSubscriptionCtx) {
-    groupSubscriptionCtx->eventsEnabled = true;
+    {
+        epicsGuard<epicsMutex> G(groupSubscriptionCtx->eventLock);
+        groupSubscriptionCtx->eventsEnabled = true;
+    }
     for (auto& fieldSubscriptionCtx: groupSubscriptionCtx->fieldSubscriptionContexts) {
         fieldSubscriptionCtx.pValueEventSubscription.enable();
         fieldSubscriptionCtx.pPropertiesEventSubscription.enable();
     }
-    // maybe post initial here in pathological case with no +channel.  (eg. all const)
-    subscriptionPost(groupSubscriptionCtx.get());
+    {
+        // maybe post initial here in pathological case with no +channel.  (eg. all const)
+        epicsGuard<epicsMutex> G(groupSubscriptionCtx->eventLock);
+        subscriptionPost(groupSubscriptionCtx.get());
+    }
+    // an update through a filter (eg. dbnd) may lag the record
+    bool cacheable = true;
+    for (auto& field: groupSubscriptionCtx->group.fields) {
+        for (auto chan : {&field.value, &field.properties}) {
+            if (*chan && ellCount(&(*chan)->filters))
+                cacheable = false;
+        }
+    }
+    if (cacheable)
+        SubscriptionCache::add(&groupSubscriptionCtx->group, groupSubscriptionCtx.get());
 }
 
 /**
@@ -263,11 +283,16 @@ void subscriptionValueCallback(void* userArg, dbChannel* pChannel,
                                int, struct db_field_log* pDbFieldLog) noexcept {
     try {
         auto fieldSubscriptionCtx = (FieldSubscriptionCtx*)userArg;
+        // Find the group subscription context from the field subscription context
+        auto& pGroupCtx = fieldSubscriptionCtx->pGroupCtx;
+
+        // currentValue may also be read by a GET.  cf. SubscriptionCache
+        epicsGuard<epicsMutex> E(pGroupCtx->eventLock);
+
         auto first = !fieldSubscriptionCtx->hadValueEvent;
         fieldSubscriptionCtx->hadValueEvent = true;
+        pGroupCtx->lastEvent = monotonicNS();
 
-        // Find the group subscription context from the field subscription context
-        auto& pGroupCtx = fieldSubscriptionCtx->pGroupCtx;
         // Also find the field
         auto& field = *fieldSubscriptionCtx->field;
         auto& currentValue = pGroupCtx->currentValue;
@@ -312,8 +337,11 @@ void subscriptionPropertiesCallback(void* userArg, dbChannel* pChannel,
                                     int, struct db_field_log* pDbFieldLog) noexcept {
     try {
         auto subscriptionContext = (FieldSubscriptionCtx*)userArg;
+        epicsGuard<epicsMutex> E(subscriptionContext->pGroupCtx->eventLock);
+
         bool first = subscriptionContext->hadPropertyEvent;
         subscriptionContext->hadPropertyEvent = true;
+        subscriptionContext->pGroupCtx->lastEvent = monotonicNS();
 
         auto& field(*subscriptionContext->field);
 
@@ -431,6 +459,20 @@ bool getGroupField(const Field& field, Value valueTarget, const std::string& gro
  * @param getOperation the current executing operation
  */
 void GroupSource::get(Group& group, const std::unique_ptr<server::ExecOp>& getOperation) {
+    uint64_t maxAge;
+    bool cache = SubscriptionCache::wanted(getOperation->pvRequest(), maxAge);
+    for (auto& field: group.fields) {
+        if (cache && field.value && SubscriptionCache::hasDeadband(field.value))
+            cache = false;
+    }
+    if (cache) {
+        if (auto cached = SubscriptionCache::snapshot(&group, maxAge)) {
+            getOperation->reply(cached);
+            return;
+        }
+        // no recently updated subscription.  fall back to reading the records
+    }
+
     bool atomic = group.atomicPutGet;
     getOperation->pvRequest()["record._options.atomic"].as(atomic);
 
@@ -497,7 +539,7 @@ void GroupSource::get(Group& group, const std::unique_ptr<server::ExecOp>& getOp
 static
 bool putGroupField(const Value& value,
                    const Field& field,
-                   const SecurityClient& securityClient,
+                   const std::shared_ptr<const SecurityClient>& securityClient,
                    const GroupSecurityCache& groupSecurityCache) {
     // find the leaf node that the field refers to in the given value
     auto leafNode = field.findIn(value);
@@ -505,7 +547,7 @@ bool putGroupField(const Value& value,
 
     // If the field references a valid part of the given value then we can send it to the database
     if (marked) {
-        IOCSource::doFieldPreProcessing(securityClient); // pre-process field
+        IOCSource::doFieldPreProcessing(*securityClient); // pre-process field
         IOCSource::put(field.value, leafNode, field.info);
     }
     if (marked || field.info.type==MappingInfo::Proc) {
@@ -542,7 +584,7 @@ void GroupSource::putGroup(Group& group, std::unique_ptr<server::ExecOp>& putOpe
             if (dbChannel* pDbChannel = field.value) {
                 IOCSource::doPreProcessing(pDbChannel,
                         securityLoggers[fieldIndex], *groupSecurityCache.credentials,
-                        groupSecurityCache.securityClients[fieldIndex]);
+                        *groupSecurityCache.securityClients[fieldIndex]);
                 if (dbChannelFinalFieldType(pDbChannel) >= DBF_INLINK
                         && dbChannelFinalFieldType(pDbChannel) <= DBF_FWDLINK) {
                     throw std::runtime_error("Links not supported for put");
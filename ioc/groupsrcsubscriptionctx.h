@@ -13,6 +13,8 @@
 #include <map>
 #include <vector>
 
+#include <epicsGuard.h>
+
 #include <pvxs/source.h>
 
 #include "dbeventcontextdeleter.h"
@@ -24,7 +26,7 @@
 namespace pvxs {
 namespace ioc {
 
-class GroupSourceSubscriptionCtx {
+class GroupSourceSubscriptionCtx : public CachingSubscription {
 public:
     Group& group;
     epicsMutex eventLock{};
@@ -44,6 +46,16 @@ public:
     }
     ~GroupSourceSubscriptionCtx() {
         assert(!eventsEnabled); // check for mis-matched onStartSubscription()/onDisableSubscription()
+        SubscriptionCache::remove(&group, this);
+    }
+
+    Value snapshot(uint64_t maxAge) override final {
+        epicsGuard<epicsMutex> G(eventLock);
+        if (!eventsEnabled || !eventsPrimed || !fresh(maxAge))
+            return Value();
+        auto ret(currentValue.clone());
+        ret.mark();
+        return ret;
     }
 
 };
@@ -31,6 +31,7 @@
 #include <pvxs/source.h>
 
 #include "iocshcommand.h"
+#include "securityclient.h"
 #include "utilpvt.h"
 #include "qsrvpvt.h"
 
@@ -108,6 +109,7 @@ void pvxsExitBeforeIocShutdown(void*) noexcept
             assert(!pvxServer->srv);
             srv.stop();
             IOCGroupConfigCleanup();
+            SecurityClientCache::clear();
             log_debug_printf(_logname, "Stopped Server%s", "\n");
         }
     } catch(std::exception& e) {
@@ -244,6 +246,20 @@ void pvxrefshow() {
     }
 }
 
+void pvxlockshow(int zero) {
+    auto locks(impl::lockProfileSnapshot(zero));
+    if(locks.empty())
+        printf("Lock profiling disabled.  Set $PVXS_LOCK_PROFILE=YES before starting the IOC.\n");
+    for(auto& pair : locks) {
+        printf("%s\tacquired=%llu contended=%llu\n\twait: %s\n\thold: %s\n",
+               pair.first.c_str(),
+               (unsigned long long)pair.second.acquisitions,
+               (unsigned long long)pair.second.contended,
+               std::string(SB()<<pair.second.wait).c_str(),
+               std::string(SB()<<pair.second.hold).c_str());
+    }
+}
+
 struct RefTrack {
     epicsMutex lock;
     std::map<std::string, size_t> refs;
@@ -468,6 +484,9 @@ void pvxsBaseRegistrar() noexcept {
                        "Save the current set of instance counters for reference by later pvxrefdiff.\n").implementation<&pvxrefsave>();
         IOCShCommand<>("pvxrefdiff",
                        "Show different of current instance counts with those when pvxrefsave was called.\n").implementation<&pvxrefdiff>();
+        IOCShCommand<int>("pvxlockshow", "[zero]",
+                          "Show contention statistics of internal locks.\n"
+                          "Requires $PVXS_LOCK_PROFILE=YES.  Non-zero argument resets counters.\n").implementation<&pvxlockshow>();
 
         // Initialise the PVXS Server
         initialisePvxsServer();
@@ -44,6 +44,20 @@ static inline void resetGroups() {}
 #  define USE_PREPARE_CLEANUP_HOOKS
 #endif
 
+// test utility.  Number of users of the dbChannel shared for this name,
+// or zero if none.  cf. Channel::shared()
+PVXS_IOC_API
+long testqsrvSharedChannelUsers(const char* name);
+
+// test utility.  Number of GETs answered from an active subscription.  cf. SubscriptionCache
+PVXS_IOC_API
+long testqsrvGetCacheHits();
+
+// test utility.  Number of security clients found in, and added to, the per-connection cache.
+// cf. SecurityClientCache
+PVXS_IOC_API
+void testqsrvSecurityCacheCounts(long& hits, long& misses);
+
 #ifdef USE_PVA_LINKS
 // test utilities for PVA links
 
@@ -7,16 +7,168 @@
  *
  */
 
+#include <algorithm>
+#include <map>
+
 #include <dbCommon.h>
 #include <dbBase.h>
 #include <asLib.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
 
 #include "securityclient.h"
+#include "qsrvpvt.h"
 
 namespace pvxs {
 namespace ioc {
 
-void SecurityClient::update(dbChannel* ch, Credentials& cred) {
+namespace {
+
+typedef epicsGuard<epicsMutex> Guard;
+
+// Limit on security clients cached for one connection.
+// When exceeded, the connection's clients are discarded and re-created as needed.
+constexpr size_t maxConnClients = 1024u;
+
+struct ConnSecurity {
+    std::shared_ptr<const Credentials> credentials;
+    // keyed by record (ASMEMBERPVT) and field access level
+    std::map<std::pair<ASMEMBERPVT, int>, std::shared_ptr<const SecurityClient>> clients;
+};
+
+typedef std::map<std::weak_ptr<const server::ClientCredentials>, ConnSecurity,
+                 std::owner_less<std::weak_ptr<const server::ClientCredentials>>> conns_t;
+
+struct SecurityCacheGbl {
+    epicsMutex lock;
+    // guarded by lock
+    conns_t conns;
+    // pasbase when entries were created.  Changes when an ACF is (re)loaded
+    const void* asbase = nullptr;
+    // sweep closed connections when conns grows to this size
+    size_t sweepAt = 16u;
+    // security clients found in, and added to, the cache
+    long hits = 0, misses = 0;
+} *securityCacheGbl;
+
+void securityCacheInit()
+{
+    securityCacheGbl = new SecurityCacheGbl;
+}
+
+/* Find, or create, entry for a connection.  Call with lock held.
+ * Entries to be destroyed are moved to junk, to be released after unlock
+ * as asRemoveClient() takes the asLib lock.
+ */
+ConnSecurity& findConn(Guard& G, const std::shared_ptr<const server::ClientCredentials>& cred, conns_t& junk)
+{
+    auto& gbl = *securityCacheGbl;
+    G.assertIdenticalMutex(gbl.lock);
+
+    auto base = (const void*)pasbase;
+    if(base!=gbl.asbase) {
+        junk.swap(gbl.conns);
+        gbl.asbase = base;
+    }
+
+    std::weak_ptr<const server::ClientCredentials> key(cred);
+    auto it(gbl.conns.find(key));
+    if(it!=gbl.conns.end())
+        return it->second;
+
+    if(gbl.conns.size() >= gbl.sweepAt) {
+        for(auto it(gbl.conns.begin()); it!=gbl.conns.end();) {
+            if(it->first.expired()) {
+                junk.emplace(it->first, std::move(it->second));
+                it = gbl.conns.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        gbl.sweepAt = std::max(size_t(16u), 2u*gbl.conns.size());
+    }
+
+    return gbl.conns[key];
+}
+
+} // namespace
+
+std::shared_ptr<const Credentials>
+SecurityClientCache::credentials(const std::shared_ptr<const server::ClientCredentials>& cred) {
+    threadOnce<&securityCacheInit>();
+    auto& gbl = *securityCacheGbl;
+    {
+        conns_t junk;
+        Guard G(gbl.lock);
+        auto& conn = findConn(G, cred, junk);
+        if(conn.credentials)
+            return conn.credentials;
+    }
+
+    // may wait for a roles lookup, so without lock
+    std::shared_ptr<const Credentials> ret(std::make_shared<Credentials>(*cred));
+
+    conns_t junk;
+    Guard G(gbl.lock);
+    auto& conn = findConn(G, cred, junk);
+    if(!conn.credentials)
+        conn.credentials = ret;
+    return conn.credentials;
+}
+
+std::shared_ptr<const SecurityClient>
+SecurityClientCache::client(const std::shared_ptr<const server::ClientCredentials>& cred,
+                            const Credentials& credentials, dbChannel* ch) {
+    threadOnce<&securityCacheInit>();
+    auto& gbl = *securityCacheGbl;
+    auto key(std::make_pair(dbChannelRecord(ch)->asp, int(dbChannelFldDes(ch)->as_level)));
+    {
+        conns_t junk;
+        Guard G(gbl.lock);
+        auto& conn = findConn(G, cred, junk);
+        auto it(conn.clients.find(key));
+        if(it!=conn.clients.end()) {
+            gbl.hits++;
+            return it->second;
+        }
+    }
+
+    auto ret(std::make_shared<SecurityClient>());
+    ret->update(ch, credentials);
+
+    conns_t junk;
+    decltype(ConnSecurity::clients) junkClients;
+    Guard G(gbl.lock);
+    auto& conn = findConn(G, cred, junk);
+    if(conn.clients.size() >= maxConnClients)
+        junkClients.swap(conn.clients);
+    auto& ent = conn.clients[key];
+    if(!ent) {
+        ent = ret;
+        gbl.misses++;
+    } else {
+        gbl.hits++; // lost a race with another put
+    }
+    return ent;
+}
+
+void testqsrvSecurityCacheCounts(long& hits, long& misses) {
+    threadOnce<&securityCacheInit>();
+    auto& gbl = *securityCacheGbl;
+    Guard G(gbl.lock);
+    hits = gbl.hits;
+    misses = gbl.misses;
+}
+
+void SecurityClientCache::clear() {
+    threadOnce<&securityCacheInit>();
+    auto& gbl = *securityCacheGbl;
+    conns_t junk;
+    Guard G(gbl.lock);
+    junk.swap(gbl.conns);
+}
+
+void SecurityClient::update(dbChannel* ch, const Credentials& cred) {
     SecurityClient temp;
     temp.cli.resize(cred.cred.size(), nullptr);
 
@@ -10,6 +10,7 @@
 #ifndef PVXS_SECURITYCLIENT_H
 #define PVXS_SECURITYCLIENT_H
 
+#include <memory>
 #include <vector>
 #include <asLib.h>
 #include <dbChannel.h>
@@ -26,10 +27,26 @@ class SecurityClient {
 public:
 	std::vector<ASCLIENTPVT> cli;
 	~SecurityClient();
-	void update(dbChannel* ch, Credentials& cred);
+	void update(dbChannel* ch, const Credentials& cred);
 	bool canWrite() const;
 };
 
+/**
+ * Credentials and security clients shared by all put operations of one client connection.
+ *
+ * Saves a roles lookup and asAddClient() for each new put operation.
+ * Connections are identified by their server::ClientCredentials, which are replaced
+ * if a client changes its credentials.  All entries are discarded when the access
+ * security configuration is (re)loaded.
+ */
+class SecurityClientCache {
+public:
+	static std::shared_ptr<const Credentials> credentials(const std::shared_ptr<const server::ClientCredentials>& cred);
+	static std::shared_ptr<const SecurityClient> client(const std::shared_ptr<const server::ClientCredentials>& cred,
+			const Credentials& credentials, dbChannel* ch);
+	static void clear();
+};
+
 /**
  * Security objects that can be controlled
  */
@@ -44,8 +61,8 @@ public:
  */
 class GroupSecurityCache : public SecurityControlObject {
 public:
-	std::vector<SecurityClient> securityClients;
-	std::unique_ptr<Credentials> credentials;
+	std::vector<std::shared_ptr<const SecurityClient>> securityClients;
+	std::shared_ptr<const Credentials> credentials;
     INST_COUNTER(GroupSecurityCache);
 };
 
@@ -54,8 +71,8 @@ public:
  */
 class SingleSecurityCache : public SecurityControlObject {
 public:
-	SecurityClient securityClient;
-	std::unique_ptr<Credentials> credentials;
+	std::shared_ptr<const SecurityClient> securityClient;
+	std::shared_ptr<const Credentials> credentials;
 };
 
 /**
@@ -21,6 +21,7 @@
 #include <pvxs/nt.h>
 #include <pvxs/source.h>
 #include <dbNotify.h>
+#include <epicsGuard.h>
 
 #include "dbentry.h"
 #include "dberrormessage.h"
@@ -45,10 +46,16 @@ DEFINE_INST_COUNTER(SingleInfo);
 namespace {
 
 void subscriptionCallback(SingleSourceSubscriptionCtx* subscriptionContext,
+                          bool SingleSourceSubscriptionCtx::* hadEvent,
                           UpdateType::type change,
                           dbChannel* pChannel,
                           struct db_field_log* pDbFieldLog) noexcept {
     try {
+        // currentValue may also be read by a GET.  cf. SubscriptionCache
+        epicsGuard<epicsMutex> G(subscriptionContext->eventLock);
+        subscriptionContext->*hadEvent = true;
+        subscriptionContext->lastEvent = monotonicNS();
+
         // Get the current value of this subscription
         // We simply merge new field changes onto this value as events occur
         auto currentValue = subscriptionContext->currentValue;
@@ -74,7 +81,6 @@ void subscriptionCallback(SingleSourceSubscriptionCtx* subscriptionContext,
 void subscriptionValueCallback(void* userArg, struct dbChannel* pChannel,
                                int, struct db_field_log* pDbFieldLog) noexcept {
     auto subscriptionContext = (SingleSourceSubscriptionCtx*)userArg;
-    subscriptionContext->hadValueEvent = true;
     auto change = UpdateType::type(UpdateType::Value | UpdateType::Alarm);
 #if EPICS_VERSION_INT >= VERSION_INT(7, 0, 6, 0)
     if(pDbFieldLog) {
@@ -82,14 +88,15 @@ void subscriptionValueCallback(void* userArg, struct dbChannel* pChannel,
         change = UpdateType::type(pDbFieldLog->mask & UpdateType::Everything);
     }
 #endif
-    subscriptionCallback(subscriptionContext, change, pChannel, pDbFieldLog);
+    subscriptionCallback(subscriptionContext, &SingleSourceSubscriptionCtx::hadValueEvent,
+                         change, pChannel, pDbFieldLog);
 }
 
 void subscriptionPropertiesCallback(void* userArg, struct dbChannel* pChannel, int,
                                     struct db_field_log* pDbFieldLog) noexcept {
     auto subscriptionContext = (SingleSourceSubscriptionCtx*)userArg;
-    subscriptionContext->hadPropertyEvent = true;
-    subscriptionCallback(subscriptionContext, UpdateType::Property, pChannel, pDbFieldLog);
+    subscriptionCallback(subscriptionContext, &SingleSourceSubscriptionCtx::hadPropertyEvent,
+                         UpdateType::Property, pChannel, pDbFieldLog);
 }
 
 /**
@@ -130,6 +137,10 @@ void onSubscribe(const std::shared_ptr<SingleSourceSubscriptionCtx>& subscriptio
     if(!dbe)
         dbe = DBE_VALUE | DBE_ALARM;
 
+    // an update through a filter (eg. dbnd) may lag the record
+    subscriptionContext->cacheable = (dbe & DBE_VALUE)
+            && !ellCount(&subscriptionContext->info->chan->filters);
+
     // inform peer of data type and acquire control of the subscription queue
     subscriptionContext->subscriptionControl = subscriptionOperation->connect(subscriptionContext->currentValue);
 
@@ -156,13 +167,21 @@ void onSubscribe(const std::shared_ptr<SingleSourceSubscriptionCtx>& subscriptio
     // If all goes well, Set up handlers for start and stop monitoring events
     // The subscription context is being kept alive because it is being bound into some internal storage by onStart
     subscriptionContext->subscriptionControl->onStart([subscriptionContext](bool isStarting) {
+        dbChannel* key = subscriptionContext->info->chan;
         if (isStarting) {
-            subscriptionContext->eventsEnabled = true;
+            {
+                epicsGuard<epicsMutex> G(subscriptionContext->eventLock);
+                subscriptionContext->eventsEnabled = true;
+            }
             subscriptionContext->pValueEventSubscription.enable();
             subscriptionContext->pPropertiesEventSubscription.enable();
+            if (subscriptionContext->cacheable)
+                SubscriptionCache::add(key, subscriptionContext.get());
         } else {
+            SubscriptionCache::remove(key, subscriptionContext.get());
             subscriptionContext->pValueEventSubscription.disable();
             subscriptionContext->pPropertiesEventSubscription.disable();
+            epicsGuard<epicsMutex> G(subscriptionContext->eventLock);
             subscriptionContext->eventsEnabled = false;
         }
     });
@@ -267,6 +286,16 @@ void singleGet(const SingleInfo& info,
                const Value& valuePrototype) {
     auto& pDbChannel(info.chan);
     try {
+        uint64_t maxAge;
+        if (SubscriptionCache::wanted(getOperation->pvRequest(), maxAge)
+                && !SubscriptionCache::hasDeadband(pDbChannel.get())) {
+            if (auto cached = SubscriptionCache::snapshot(pDbChannel.get(), maxAge)) {
+                getOperation->reply(cached);
+                return;
+            }
+            // no recently updated subscription.  fall back to reading the record
+        }
+
         auto returnValue = valuePrototype.cloneEmpty();
         // TODO: MappingInfo::nsecMask
         IOCSource::initialize(returnValue, info, pDbChannel);
@@ -316,8 +345,10 @@ void onOp(const std::shared_ptr<SingleInfo>& sInfo, const Value& valuePrototype,
                 try {
                     dbChannel* pDbChannel = sInfo->chan;
                     if (!putOperationCache->done) {
-                        putOperationCache->credentials.reset(new Credentials(*putOperation->credentials()));
-                        putOperationCache->securityClient.update(pDbChannel, *putOperationCache->credentials);
+                        auto& cred = putOperation->credentials();
+                        putOperationCache->credentials = SecurityClientCache::credentials(cred);
+                        putOperationCache->securityClient = SecurityClientCache::client(cred,
+                                *putOperationCache->credentials, pDbChannel);
                         putOperationCache->notify.usrPvt = putOperationCache.get();
                         putOperationCache->notify.chan = pDbChannel;
                         putOperationCache->notify.putCallback = putCallback;
@@ -337,8 +368,8 @@ void onOp(const std::shared_ptr<SingleInfo>& sInfo, const Value& valuePrototype,
                     IOCSource::doPreProcessing(pDbChannel,
                             securityLogger,
                             *putOperationCache->credentials,
-                            putOperationCache->securityClient); // pre-process
-                    IOCSource::doFieldPreProcessing(putOperationCache->securityClient); // pre-process field
+                            *putOperationCache->securityClient); // pre-process
+                    IOCSource::doFieldPreProcessing(*putOperationCache->securityClient); // pre-process field
                     if (putOperationCache->doWait) {
                         putOperationCache->valueToSet = value;
                         // TODO prevent concurrent put with callbacks (notifyBusy)
@@ -409,7 +440,7 @@ void SingleSource::onCreate(std::unique_ptr<server::ChannelControl>&& channelCon
     auto sourceName(channelControl->name().c_str());
     Channel pDbChannel;
     try {
-        pDbChannel = Channel(sourceName);
+        pDbChannel = Channel::shared(channelControl->name());
     }  catch (std::exception& e) {
         log_debug_printf(_logname, "Ignore requested channel '%s' : %s\n", sourceName, e.what());
         return;
@@ -7,6 +7,8 @@
  *
  */
 
+#include <epicsGuard.h>
+
 #include "singlesrcsubscriptionctx.h"
 #include "utilpvt.h"
 
@@ -21,8 +23,17 @@ DEFINE_INST_COUNTER(SingleSourceSubscriptionCtx);
  * @param dbChannelSharedPtr pointer to the db channel to use to construct the single source subscription context
  */
 SingleSourceSubscriptionCtx::SingleSourceSubscriptionCtx(const std::shared_ptr<SingleInfo> &sInfo)
-    :pPropertiesChannel(dbChannelName(sInfo->chan))
+    :pPropertiesChannel(Channel::shared(dbChannelName(sInfo->chan)))
     ,info(sInfo)
 {}
+
+Value SingleSourceSubscriptionCtx::snapshot(uint64_t maxAge) {
+    epicsGuard<epicsMutex> G(eventLock);
+    if (!eventsEnabled || !hadValueEvent || !hadPropertyEvent || !fresh(maxAge))
+        return Value();
+    auto ret(currentValue.clone());
+    ret.mark();
+    return ret;
+}
 } // iocs
 } // pvxs
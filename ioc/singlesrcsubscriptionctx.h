@@ -32,12 +32,13 @@ struct SingleInfo : public MappingInfo {
 /**
  * A subscription context
  */
-class SingleSourceSubscriptionCtx : public SubscriptionCtx {
+class SingleSourceSubscriptionCtx : public SubscriptionCtx, public CachingSubscription {
 
 public:
     explicit SingleSourceSubscriptionCtx(const std::shared_ptr<SingleInfo>& sInfo);
 
     // extra dbChannel* to have a distinct state for any server side filters.  (eg. decimate)
+    // Without filters, the same dbChannel as info->chan.
     const Channel pPropertiesChannel;
 
     // This is used to store the current value.  Each subscription event simply merges
@@ -47,13 +48,18 @@ public:
     epicsMutex eventLock{};
     std::unique_ptr<server::MonitorControlOp> subscriptionControl{};
     bool eventsEnabled = false;
+    // May answer GETs.  Subscribed for DBE_VALUE through a channel without filters.
+    bool cacheable = false;
     INST_COUNTER(SingleSourceSubscriptionCtx);
 
     ~SingleSourceSubscriptionCtx() {
         assert(!eventsEnabled);
+        SubscriptionCache::remove(info->chan.get(), this);
         // must db_cancel_event() before ~MonitorControlOp
         cancel();
     }
+
+    Value snapshot(uint64_t maxAge) override final;
 };
 
 } // ioc
@@ -0,0 +1,158 @@
+/*
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dbAccess.h>
+#include <dbStaticLib.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
+#include <epicsString.h>
+
+#include "dbentry.h"
+#include "qsrvpvt.h"
+#include "subscriptionctx.h"
+#include "utilpvt.h"
+
+namespace pvxs {
+namespace ioc {
+
+namespace {
+struct SubscriptionCacheGbl {
+    epicsMutex lock;
+    // guarded by lock
+    std::map<const void*, std::vector<CachingSubscription*>> active;
+    // GETs answered from a subscription
+    long hits = 0;
+    // default for GET without record._options.cache
+    bool byDefault = false;
+    // default for GET without record._options.cacheAge.  seconds
+    double maxAge = 1.0;
+} *subscriptionCacheGbl;
+
+void subscriptionCacheInit()
+{
+    subscriptionCacheGbl = new SubscriptionCacheGbl;
+    auto env = getenv("PVXS_QSRV_GET_CACHE");
+    subscriptionCacheGbl->byDefault = env && (epicsStrCaseCmp(env, "YES")==0 || strcmp(env, "1")==0);
+    if(auto env = getenv("PVXS_QSRV_GET_CACHE_AGE")) {
+        try {
+            subscriptionCacheGbl->maxAge = parseTo<double>(env);
+        }catch(std::exception& e){
+            fprintf(stderr, "Ignore invalid PVXS_QSRV_GET_CACHE_AGE=\"%s\" : %s\n", env, e.what());
+        }
+    }
+}
+} // namespace
+
+void SubscriptionCache::add(const void* key, CachingSubscription* sub)
+{
+    threadOnce<&subscriptionCacheInit>();
+    auto& gbl = *subscriptionCacheGbl;
+    epicsGuard<epicsMutex> G(gbl.lock);
+    auto& subs = gbl.active[key];
+    if(std::find(subs.begin(), subs.end(), sub)==subs.end())
+        subs.push_back(sub);
+}
+
+void SubscriptionCache::remove(const void* key, CachingSubscription* sub)
+{
+    threadOnce<&subscriptionCacheInit>();
+    auto& gbl = *subscriptionCacheGbl;
+    epicsGuard<epicsMutex> G(gbl.lock);
+    auto it(gbl.active.find(key));
+    if(it==gbl.active.end())
+        return;
+    auto& subs = it->second;
+    subs.erase(std::remove(subs.begin(), subs.end(), sub), subs.end());
+    if(subs.empty())
+        gbl.active.erase(it);
+}
+
+Value SubscriptionCache::snapshot(const void* key, uint64_t maxAge)
+{
+    threadOnce<&subscriptionCacheInit>();
+    auto& gbl = *subscriptionCacheGbl;
+    // lock order: registry lock, then subscription eventLock
+    epicsGuard<epicsMutex> G(gbl.lock);
+    auto it(gbl.active.find(key));
+    if(it!=gbl.active.end()) {
+        for(auto sub : it->second) {
+            if(auto ret = sub->snapshot(maxAge)) {
+                gbl.hits++;
+                return ret;
+            }
+        }
+    }
+    return Value();
+}
+
+bool SubscriptionCache::wanted(const Value& pvRequest, uint64_t& maxAge)
+{
+    threadOnce<&subscriptionCacheInit>();
+    bool ret = subscriptionCacheGbl->byDefault;
+    pvRequest["record._options.cache"].as(ret);
+
+    double age = subscriptionCacheGbl->maxAge;
+    pvRequest["record._options.cacheAge"].as(age);
+    maxAge = age > 0.0 ? uint64_t(age*1e9) : 0u;
+
+    return ret && maxAge;
+}
+
+namespace {
+// positive numeric field.  eg. ai MDEL is DBF_DOUBLE, longin MDEL is DBF_LONG, int64in MDEL is DBF_INT64.
+// A negative deadband posts on every process.
+bool positive(const DBENTRY* ent)
+{
+    auto pfield = ent->pfield;
+    switch(ent->pflddes->field_type) {
+#define CASE(DBF, T) case DBF: return *static_cast<const T*>(pfield) > 0
+    CASE(DBF_CHAR, epicsInt8);
+    CASE(DBF_UCHAR, epicsUInt8);
+    CASE(DBF_SHORT, epicsInt16);
+    CASE(DBF_USHORT, epicsUInt16);
+    CASE(DBF_LONG, epicsInt32);
+    CASE(DBF_ULONG, epicsUInt32);
+#ifdef DBR_INT64
+    CASE(DBF_INT64, epicsInt64);
+    CASE(DBF_UINT64, epicsUInt64);
+#endif
+    CASE(DBF_FLOAT, epicsFloat32);
+    CASE(DBF_DOUBLE, epicsFloat64);
+#undef CASE
+    default:
+        return false;
+    }
+}
+} // namespace
+
+bool SubscriptionCache::hasDeadband(dbChannel* chan)
+{
+    DBEntry ent(dbChannelRecord(chan));
+    for(auto name : {"MDEL", "ADEL"}) {
+        if(!dbFindField(ent, name) && positive(ent))
+            return true;
+    }
+    return false;
+}
+
+long testqsrvGetCacheHits()
+{
+    threadOnce<&subscriptionCacheInit>();
+    auto& gbl = *subscriptionCacheGbl;
+    epicsGuard<epicsMutex> G(gbl.lock);
+    return gbl.hits;
+}
+
+} // ioc
+} // pvxs
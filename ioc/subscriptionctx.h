@@ -16,8 +16,11 @@
 
 #include <dbEvent.h>
 
+#include <pvxs/data.h>
+
 #include "channel.h"
 #include "dbeventcontextdeleter.h"
+#include "utilpvt.h"
 
 namespace pvxs {
 namespace ioc {
@@ -61,6 +64,49 @@ public:
     }
 };
 
+/**
+ * A subscription whose most recent update may be used to answer a GET.
+ */
+class CachingSubscription {
+public:
+    // monotonicNS() of the most recent update.  Guarded by the subscription eventLock
+    uint64_t lastEvent = 0u;
+
+    virtual ~CachingSubscription() = default;
+    //! Copy of the accumulated subscription value, with all fields marked.
+    //! Empty if the initial updates have not yet arrived,
+    //! or if the most recent update is not within maxAge nanoseconds.
+    virtual Value snapshot(uint64_t maxAge) =0;
+
+protected:
+    bool fresh(uint64_t maxAge) const {
+        return monotonicNS() - lastEvent < maxAge;
+    }
+};
+
+/**
+ * Registry of active subscriptions, by dbChannel* (single PV) or Group*.
+ *
+ * A GET which requests "record._options.cache" (or all GETs when $PVXS_QSRV_GET_CACHE=YES)
+ * is answered from an active subscription, when one exists, instead of reading
+ * the database with record(s) locked.  Only if that subscription was updated within
+ * "record._options.cacheAge" seconds (default $PVXS_QSRV_GET_CACHE_AGE or 1.0).
+ */
+class SubscriptionCache {
+public:
+    static void add(const void* key, CachingSubscription* sub);
+    static void remove(const void* key, CachingSubscription* sub);
+    //! Snapshot of some active subscription through key, updated within maxAge nanoseconds.
+    //! Empty if none.
+    static Value snapshot(const void* key, uint64_t maxAge);
+    //! Whether a GET with this pvRequest may be answered from a subscription,
+    //! updated within maxAge nanoseconds.
+    static bool wanted(const Value& pvRequest, uint64_t& maxAge);
+    //! Whether the record of this channel only posts value changes exceeding a deadband (MDEL or ADEL).
+    //! A subscription may then lag the record.
+    static bool hasDeadband(dbChannel* chan);
+};
+
 /**
  * A subscription context
  */
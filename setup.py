@@ -529,6 +529,7 @@ def define_DSOS(self):
         'unittest.cpp',
         'util.cpp',
         'osgroups.cpp',
+        'rolecache.cpp',
         'sharedarray.cpp',
         'bitmask.cpp',
         'type.cpp',
@@ -537,10 +538,13 @@ def define_DSOS(self):
         'pvrequest.cpp',
         'dataencode.cpp',
         'nt.cpp',
+        'lz4.cpp',
         'evhelper.cpp',
         'udp_collector.cpp',
         'config.cpp',
         'conn.cpp',
+        'shm.cpp',
+        'zip.cpp',
         'server.cpp',
         'serverconn.cpp',
         'serverchan.cpp',
@@ -549,6 +553,7 @@ def define_DSOS(self):
         'servermon.cpp',
         'serversource.cpp',
         'sharedpv.cpp',
+        'serverproxy.cpp',
         'client.cpp',
         'clientreq.cpp',
         'clientconn.cpp',
@@ -591,6 +596,7 @@ def define_DSOS(self):
         "ioc/singlesource.cpp",
         "ioc/singlesourcehooks.cpp",
         "ioc/singlesrcsubscriptionctx.cpp",
+        "ioc/subscriptioncache.cpp",
         "ioc/typeutils.cpp",
         "ioc/pvalink_channel.cpp",
         "ioc/pvalink.cpp",
@@ -109,6 +109,7 @@ Channel::Channel(const std::shared_ptr<ContextImpl>& context, const std::string&
     :context(context)
     ,name(name)
     ,cid(cid)
+    ,searchStart(monotonicNS())
 {}
 
 Channel::~Channel()
@@ -186,6 +187,7 @@ void Channel::disconnect(const std::shared_ptr<Channel>& self)
 
     state = Channel::Searching;
     sid = 0xdeadbeef; // spoil
+    searchStart = monotonicNS();
 
     auto conns(connectors); // copy list
 
@@ -492,15 +494,26 @@ Report Context::report(bool zero) const
                 schan.name = chan->name;
                 schan.tx = chan->statTx;
                 schan.rx = chan->statRx;
+                schan.timing = chan->timing;
 
                 if(zero) {
                     chan->statTx = chan->statRx = 0u;
+                    chan->timing.clear();
                 }
             }
         }
 
     });
 
+    for(auto loop : {&pvt->impl->tcp_loop, &pvt->impl->manager.loop()}) {
+        Report::Loop sloop;
+        sloop.name = loop->name();
+        if(loop->stats(sloop.callbacks, sloop.stalls, zero))
+            ret.loops.push_back(std::move(sloop));
+    }
+
+    impl::lockProfileReport(ret, zero);
+
     return ret;
 }
 
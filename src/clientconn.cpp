@@ -20,7 +20,7 @@ Connection::Connection(const std::shared_ptr<ContextImpl>& context,
                        const SockAddr& peerAddr,
                        bool reconn)
     :ConnBase (true, context->effective.sendBE(),
-               nullptr,
+               ConnBev(),
                peerAddr)
     ,context(context)
     ,echoTimer(__FILE__, __LINE__,
@@ -62,16 +62,14 @@ void Connection::startConnecting()
 {
     assert(!this->bev);
 
-    decltype(this->bev) bev(__FILE__, __LINE__,
-                bufferevent_socket_new(context->tcp_loop.base, -1,
-                                       BEV_OPT_CLOSE_ON_FREE|BEV_OPT_DEFER_CALLBACKS));
+    auto bev(ConnBev::create(context->tcp_loop, -1));
 
     bufferevent_setcb(bev.get(), &bevReadS, nullptr, &bevEventS, this);
 
     timeval tmo(totv(context->effective.tcpTimeout));
     bufferevent_set_timeouts(bev.get(), &tmo, &tmo);
 
-    if(bufferevent_socket_connect(bev.get(), const_cast<sockaddr*>(&peerAddr->sa), peerAddr.size())) {
+    if(bev.connect(peerAddr, tmo)) {
         // non-blocking connect() failed immediately.
         // try to defer notification.
         state = Disconnected;
@@ -134,6 +132,13 @@ void Connection::sendDestroyRequest(uint32_t sid, uint32_t ioid)
     }
     enqueueTxBody(CMD_DESTROY_REQUEST);
 
+    if(shm) {
+        // an in-flight reply may still reference shared memory blocks
+        auto it = opByIOID.find(ioid);
+        if(it!=opByIOID.end() && it->second.prototype)
+            shmDrain[ioid] = it->second.prototype;
+    }
+
 }
 
 void Connection::bevEvent(short events)
@@ -144,9 +149,9 @@ void Connection::bevEvent(short events)
     if(bev && (events&BEV_EVENT_CONNECTED)) {
         log_debug_printf(io, "Connected to %s\n", peerName.c_str());
 
-        {
+        if(peerAddr.family()!=AF_UNIX) {
             // after async connect() to avoid winsock specific race.
-            auto fd(bufferevent_getfd(bev.get()));
+            auto fd(bev.fd());
             int opt = 1;
             if(setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, (char*)&opt, sizeof(opt))<0) {
                 auto err(SOCKERRNO);
@@ -227,6 +232,8 @@ void Connection::handle_CONNECTION_VALIDATION()
     from_wire(M, nauth);
 
     std::string selected;
+    bool shmOffered = false;
+    bool zipOffered = false;
 
     /* Server list given in reverse order of priority.
      * Old pvAccess* was missing a "break" when looping,
@@ -240,6 +247,12 @@ void Connection::handle_CONNECTION_VALIDATION()
 
         if(method=="ca" || (method=="anonymous" && selected!="ca"))
             selected = method;
+        else if(method=="x-pvxs-shm")
+            shmOffered = true;
+        else if(method=="x-pvxs-zip")
+            zipOffered = true;
+        else if(method=="x-pvxs-pipeline")
+            execPipeline = true;
     }
 
     if(!M.good()) {
@@ -301,6 +314,80 @@ void Connection::handle_CONNECTION_VALIDATION()
             to_wire_full(R, cred);
     }
     enqueueTxBody(CMD_CONNECTION_VALIDATION);
+
+    if(shmOffered && peerAddr.family()==AF_UNIX) {
+        log_debug_printf(io, "Server %s offers shared memory\n", peerName.c_str());
+        {
+            EvOutBuf R(sendBE, txBody.get());
+            to_wire(R, uint8_t(ShmSegment::ShmRequest));
+        }
+        enqueueTxBody(CMD_PVXS_SHM);
+    }
+
+    if(zipOffered && !zipRx) {
+        log_debug_printf(io, "Server %s offers compression\n", peerName.c_str());
+        // ready before server may begin compressing
+        zipRx.reset(new ZipDecoder);
+        {
+            EvOutBuf R(sendBE, txBody.get());
+            to_wire(R, uint8_t(ZipEncoder::ZipRequest));
+        }
+        enqueueTxBody(CMD_PVXS_ZIP);
+    }
+}
+
+void Connection::handle_PVXS_SHM()
+{
+    EvInBuf M(peerBE, segBuf.get(), 16);
+
+    uint8_t op = 0xff;
+    std::string path;
+    uint64_t size = 0u;
+    uint32_t ioid = 0u;
+    from_wire(M, op);
+    if(op==ShmSegment::ShmOffer) {
+        from_wire(M, path);
+        from_wire(M, size);
+    } else if(op==ShmSegment::ShmDestroyed) {
+        from_wire(M, ioid);
+    }
+
+    if(!M.good()) {
+        log_err_printf(io, "%s:%d Server %s sends invalid PVXS_SHM.  Disconnect...\n",
+                       M.file(), M.line(), peerName.c_str());
+        bev.reset();
+        return;
+
+    } else if(op==ShmSegment::ShmDestroyed) {
+        // no further replies with this IOID
+        shmDrain.erase(ioid);
+        return;
+
+    } else if(op!=ShmSegment::ShmOffer || shm || size > size_t(-1)) {
+        log_debug_printf(io, "Server %s ignore PVXS_SHM %u\n", peerName.c_str(), op);
+        return;
+    }
+
+    // only map a segment created by the process at the other end of this socket.
+    int64_t pid, uid;
+    if(!evsocket::peer_credentials(bev.fd(), pid, uid)) {
+        log_debug_printf(io, "Server %s unknown credentials, ignore PVXS_SHM\n", peerName.c_str());
+        return;
+    }
+
+    // on failure, continue without
+    shm = ShmSegment::open(path, size_t(size), pid, uid);
+    if(!shm)
+        return;
+
+    log_debug_printf(io, "Server %s shared memory %s\n", peerName.c_str(), path.c_str());
+
+    (void)evbuffer_drain(txBody.get(), evbuffer_get_length(txBody.get()));
+    {
+        EvOutBuf R(sendBE, txBody.get());
+        to_wire(R, uint8_t(ShmSegment::ShmAccept));
+    }
+    enqueueTxBody(CMD_PVXS_SHM);
 }
 
 void Connection::handle_CONNECTION_VALIDATED()
@@ -394,6 +481,11 @@ void Connection::handle_CREATE_CHANNEL()
         chan->state = Channel::Active;
         chan->sid = sid;
 
+        if(chan->searchStart) {
+            chan->timing.connect.sample(monotonicNS() - chan->searchStart);
+            chan->searchStart = 0u;
+        }
+
         chanBySID[sid] = chan;
 
         log_debug_printf(io, "Server %s active channel to '%s' %u:%u\n", peerName.c_str(),
@@ -50,6 +50,7 @@ bool Discovery::_cancel(bool implicit) {
 // unused for this special case
 void Discovery::_reExecGet(std::function<void (Result &&)> &&resultcb) {}
 void Discovery::_reExecPut(const Value &arg, std::function<void (Result &&)> &&resultcb) {}
+void Discovery::_reExecRPC(const Value &arg, std::function<void (Result &&)> &&resultcb) {}
 void Discovery::createOp() {}
 void Discovery::disconnected(const std::shared_ptr<OperationBase> &self) {}
 
@@ -3,6 +3,9 @@
  * pvxs is distributed subject to a Software License Agreement found
  * in file LICENSE that is included with this distribution.
  */
+#include <deque>
+#include <vector>
+
 #include <epicsAssert.h>
 
 #include <pvxs/log.h>
@@ -121,6 +124,7 @@ struct GPROp : public OperationBase
     Result result;
     bool getOput = false;
     bool autoExec = true;
+    uint64_t execSent = 0u; // monotonicNS() when EXEC sent
 
     enum state_t : uint8_t {
         Connecting, // waiting for an active Channel
@@ -132,6 +136,22 @@ struct GPROp : public OperationBase
         Done,
     } state = Connecting;
 
+    // Requests from reExec*() when !autoExec.  cf. maxPipelineExec
+    struct Request {
+        state_t kind; // GetOPut or Exec
+        Value arg;    // PUT or RPC argument
+        std::function<void(Result&&)> done;
+        uint64_t sent = 0u; // monotonicNS()
+    };
+    std::deque<Request> queued;   // not yet sent
+    std::deque<Request> inflight; // sent, awaiting reply.  front() determines state
+
+    // GET sharing.  cf. GetBuilder::coalesce()
+    bool coalesce = false;
+    std::string coalesceKey; // printed pvRequest
+    // identical GETs which joined this one.  Not in Channel::pending or opByIOID
+    std::vector<std::weak_ptr<GPROp>> followers;
+
     INST_COUNTER(GPROp);
 
     GPROp(operation_t op, const evbase& loop)
@@ -156,6 +176,8 @@ struct GPROp : public OperationBase
     }
 
     void notify() {
+        if(!followers.empty())
+            notifyFollowers();
         try {
             if(done)
                 done(std::move(result));
@@ -170,15 +192,90 @@ struct GPROp : public OperationBase
         }
     }
 
+    // deliver a copy of our result to each follower
+    void notifyFollowers()
+    {
+        auto todo(std::move(followers));
+        for(auto& wfollower : todo) {
+            auto follower(wfollower.lock());
+            if(!follower || follower->state==Done)
+                continue;
+
+            if(result.error()) {
+                follower->result = result;
+            } else {
+                follower->result = Result(result().clone(), result.peerName());
+            }
+            follower->state = Done;
+            follower->notify();
+        }
+    }
+
+    // another GET with this pvRequest may join until EXEC is sent.
+    // So a joined result always reflects a read made after the joiner was created.
+    bool canLead(const std::string& key) const
+    {
+        return coalesce && (state==Connecting || state==Creating) && coalesceKey==key;
+    }
+
+    static
+    std::shared_ptr<GPROp> findLeader(const Channel& chan, const std::string& key)
+    {
+        auto check = [&key](const std::shared_ptr<OperationBase>& op) -> std::shared_ptr<GPROp> {
+            if(op && op->op==Get) {
+                auto gpr(std::static_pointer_cast<GPROp>(op));
+                if(gpr->canLead(key))
+                    return gpr;
+            }
+            return nullptr;
+        };
+
+        for(auto& wop : chan.pending) {
+            if(auto leader = check(wop.lock()))
+                return leader;
+        }
+        for(auto& pair : chan.opByIOID) {
+            if(auto leader = check(pair.second->handle.lock()))
+                return leader;
+        }
+        return nullptr;
+    }
+
+    // cancelled before completion.  First remaining follower becomes leader of any others
+    void handoff()
+    {
+        auto todo(std::move(followers));
+        std::shared_ptr<GPROp> next;
+        for(auto& wfollower : todo) {
+            auto follower(wfollower.lock());
+            if(!follower || follower->state!=Connecting)
+                continue;
+
+            if(!next) {
+                next = std::move(follower);
+            } else {
+                next->followers.push_back(follower);
+            }
+        }
+
+        if(next) {
+            next->chan->pending.push_back(next);
+            next->chan->createOperations();
+        }
+    }
+
     virtual bool cancel() override final
     {
         decltype (done) junk;
         decltype (onInit) junkI;
+        decltype (queued) junkQ, junkF;
         bool ret = false;
-        (void)loop.tryCall([this, &junk, &junkI, &ret](){
+        (void)loop.tryCall([this, &junk, &junkI, &junkQ, &junkF, &ret](){
             ret = _cancel(false);
             junk = std::move(done);
             junkI = std::move(onInit);
+            junkQ = std::move(queued);
+            junkF = std::move(inflight);
             // leave opByIOID for GC
         });
         return ret;
@@ -200,6 +297,8 @@ struct GPROp : public OperationBase
         }
         bool ret = state!=Done;
         state = Done;
+        if(!followers.empty())
+            handoff();
         return ret;
     }
 
@@ -215,23 +314,80 @@ struct GPROp : public OperationBase
                 cb(std::move(ret));
                 return;
             }
-            if(self->state!=Idle)
+            if(self->state==Done)
                 return;
 
-            if(self->op==RPC) {
-                self->arg = std::move(a);
+            Request req;
+            req.kind = self->op==Put && !put ? GetOPut : Exec;
+            if(put)
+                req.arg = std::move(a);
+            req.done = std::move(cb);
+            self->queued.push_back(std::move(req));
 
-            } else if(put && self->op==Put) {
-                self->builder = [a](Value&&) noexcept -> Value {
-                    // caller should be passing a Value of the correct prototype
-                    // given through onInit().
-                    return a;
-                };
+            self->pump();
+        });
+    }
+
+    // send queued requests.  Several when the server supports pipelining
+    void pump()
+    {
+        while(!queued.empty()) {
+            if(state==Idle) {
+                // send first
+            } else if((state==GetOPut || state==Exec) && !inflight.empty()
+                      && chan->conn->execPipeline && inflight.size() < maxPipelineExec) {
+                // send another
+            } else {
+                break;
             }
-            self->done = std::move(cb);
 
-            self->_reExec(put);
-        });
+            inflight.push_back(std::move(queued.front()));
+            queued.pop_front();
+            sendExec(inflight.back());
+            state = inflight.front().kind;
+        }
+    }
+
+    void sendExec(Request& req)
+    {
+        auto& conn = chan->conn;
+        {
+            (void)evbuffer_drain(conn->txBody.get(), evbuffer_get_length(conn->txBody.get()));
+
+            EvOutBuf R(conn->sendBE, conn->txBody.get());
+
+            to_wire(R, chan->sid);
+            to_wire(R, ioid);
+            if(req.kind==GPROp::GetOPut) {
+                to_wire(R, uint8_t(0x40));
+
+            } else {
+                to_wire(R, uint8_t(0x00));
+                if(op==Put) {
+                    to_wire_valid(R, req.arg);
+
+                } else if(op==RPC) {
+                    to_wire(R, Value::Helper::desc(req.arg));
+                    if(req.arg)
+                        to_wire_full(R, req.arg);
+                }
+            }
+        }
+        req.sent = execSent = monotonicNS();
+        chan->statTx += conn->enqueueTxBody((pva_app_msg_t)op);
+    }
+
+    // reply to inflight.front() received, and result set
+    void completeExec()
+    {
+        auto req(std::move(inflight.front()));
+        inflight.pop_front();
+        state = inflight.empty() ? Idle : inflight.front().kind;
+
+        done = std::move(req.done);
+        notify();
+
+        pump();
     }
 
     void _reExecGet(std::function<void(client::Result&&)>&& resultcb) override final
@@ -251,6 +407,13 @@ struct GPROp : public OperationBase
         }
         _reExecImpl(true, arg, std::move(resultcb));
     }
+    void _reExecRPC(const Value& arg, std::function<void(client::Result&&)>&& resultcb) override final
+    {
+        if(op!=RPC)
+            throw std::logic_error("reExecRPC() only meaningful for .rpc()");
+
+        _reExecImpl(true, arg, std::move(resultcb));
+    }
 
     void _reExec(bool put)
     {
@@ -300,6 +463,7 @@ struct GPROp : public OperationBase
                 to_wire(R, uint8_t(0x40));
 
             } else if(state==GPROp::Exec) {
+                execSent = monotonicNS();
                 to_wire(R, uint8_t(0x00));
                 if(op==Put) {
                     to_wire_valid(R, temp);
@@ -364,12 +528,35 @@ struct GPROp : public OperationBase
         if(state==Connecting || state==Done) {
             // noop
 
-        } else if(state==Exec && op!=Get && !autoExec) {
-            // can't restart as server side-effects may occur
-            state = Done;
-            result = Result(std::make_exception_ptr(Disconnect()));
+        } else if(!autoExec && !inflight.empty()) {
+            bool effects = false;
+            for(auto& req : inflight)
+                effects |= req.kind==Exec && op!=Get;
 
-            notify();
+            if(effects) {
+                // can't restart as server side-effects may occur
+                state = Done;
+
+                auto reqs(std::move(inflight));
+                for(auto& req : queued)
+                    reqs.push_back(std::move(req));
+                queued.clear();
+
+                for(auto& req : reqs) {
+                    done = std::move(req.done);
+                    result = Result(std::make_exception_ptr(Disconnect()));
+                    notify();
+                }
+
+            } else {
+                // only GETs, which will be re-sent after reconnect
+                while(!inflight.empty()) {
+                    queued.push_front(std::move(inflight.back()));
+                    inflight.pop_back();
+                }
+                chan->pending.push_back(self);
+                state = Connecting;
+            }
 
         } else if(state==Creating || state==Idle || state==GetOPut || state==Exec) {
             // return to pending
@@ -393,6 +580,7 @@ void Connection::handle_GPR(pva_app_msg_t cmd)
 {
     auto rxlen = 8u + evbuffer_get_length(segBuf.get());
     EvInBuf M(peerBE, segBuf.get(), 16);
+    M.shm = shm.get();
 
     uint32_t ioid;
     uint8_t subcmd=0;
@@ -429,7 +617,15 @@ void Connection::handle_GPR(pva_app_msg_t cmd)
             info = &it->second;
 
         } else {
-            if(cmd!=CMD_RPC && !init) {
+            auto drain = shmDrain.find(ioid);
+            if(drain!=shmDrain.end() && !init && (cmd==CMD_GET || (cmd==CMD_PUT && get)) && sts.isSuccess()) {
+                // cancelled.  decode anyway to release any shared memory blocks.
+                auto junk(drain->second.cloneEmpty());
+                from_wire_valid(M, rxRegistry, junk);
+                if(!M.good())
+                    rxRegistryDirty = true;
+
+            } else if(cmd!=CMD_RPC && !init) {
                 rxRegistryDirty = true;
             }
 
@@ -494,12 +690,20 @@ void Connection::handle_GPR(pva_app_msg_t cmd)
     }
 
     gpr->chan->statRx += rxlen;
+    if(gpr->state==GPROp::Exec)
+        gpr->chan->timing.rtt.sample(monotonicNS() - (gpr->inflight.empty() ? gpr->execSent
+                                                                            : gpr->inflight.front().sent));
 
     // advance operation state
 
     decltype (gpr->state) prev = gpr->state;
 
-    if(!sts.isSuccess()) {
+    if(!sts.isSuccess() && !gpr->inflight.empty()) {
+        gpr->result = Result(std::make_exception_ptr(RemoteError(sts.msg)));
+        gpr->completeExec();
+        return;
+
+    } else if(!sts.isSuccess()) {
         gpr->result = Result(std::make_exception_ptr(RemoteError(sts.msg)));
         gpr->state = gpr->state==GPROp::Creating || gpr->autoExec ? GPROp::Done : GPROp::Idle;
 
@@ -522,6 +726,8 @@ void Connection::handle_GPR(pva_app_msg_t cmd)
 
         if(gpr->state==GPROp::Idle && gpr->autoExec)
             gpr->_reExec(!gpr->getOput);
+        else if(gpr->state==GPROp::Idle)
+            gpr->pump();
         // reply may now be sent, or deferred
         return;
 
@@ -535,9 +741,8 @@ void Connection::handle_GPR(pva_app_msg_t cmd)
 
         } else {
             // deliver get result
-            gpr->state = GPROp::Idle;
             gpr->result = Result(std::move(data), peerName);
-            gpr->notify();
+            gpr->completeExec();
             return;
         }
 
@@ -546,8 +751,7 @@ void Connection::handle_GPR(pva_app_msg_t cmd)
         gpr->result = Result(std::move(data), peerName);
 
         if(!gpr->autoExec) {
-            gpr->state = GPROp::Idle;
-            gpr->notify();
+            gpr->completeExec();
             return;
         }
         gpr->state = GPROp::Done;
@@ -598,6 +802,14 @@ std::shared_ptr<Operation> gpr_setup(const std::shared_ptr<ContextImpl>& context
         try {
             internal->chan = Channel::build(context, name, server);
 
+            if(internal->coalesce) {
+                if(auto leader = GPROp::findLeader(*internal->chan, internal->coalesceKey)) {
+                    log_debug_printf(setup, "Channel '%s' GET joins pending GET\n", name.c_str());
+                    leader->followers.push_back(internal);
+                    return;
+                }
+            }
+
             internal->chan->pending.push_back(internal);
             internal->chan->createOperations();
         }catch(...){
@@ -618,9 +830,13 @@ std::shared_ptr<Operation> GetBuilder::_exec_get()
     auto context(ctx->impl->shared_from_this());
 
     auto op(std::make_shared<GPROp>(Operation::Get, context->tcp_loop));
+    // a follower would never see onInit(), or be able to reExec()
+    op->coalesce = _coalesce && _autoexec && !_onInit;
     op->setDone(std::move(_result), std::move(_onInit));
     op->autoExec = _autoexec;
     op->pvRequest = _buildReq();
+    if(op->coalesce)
+        op->coalesceKey = (SB()<<op->pvRequest).str();
 
     return gpr_setup(context, _name, _server, std::move(op), _syncCancel);
 }
@@ -659,8 +875,6 @@ std::shared_ptr<Operation> RPCBuilder::exec()
 {
     if(!ctx)
         throw std::logic_error("NULL Builder");
-    if(!_autoexec)
-        throw std::logic_error("autoExec(false) not possible for rpc()");
 
     auto context(ctx->impl->shared_from_this());
 
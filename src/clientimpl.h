@@ -64,7 +64,7 @@ struct OperationBase : public Operation
 
 struct RequestFL {
     const size_t limit;
-    epicsMutex lock;
+    ProfiledMutex lock{"RequestFL"};
     std::vector<Value> unused;
 
     explicit RequestFL(size_t limit) :limit(limit) {}
@@ -91,6 +91,8 @@ struct Connection final : public ConnBase, public std::enable_shared_from_this<C
 
     bool ready = false;
     bool nameserver = false;
+    // server queues pipelined EXEC.  cf. maxPipelineExec
+    bool execPipeline = false;
 
     // channels to be created on this Connection in state==Connecting
     std::map<uint32_t, std::weak_ptr<Channel>> pending;
@@ -100,6 +102,8 @@ struct Connection final : public ConnBase, public std::enable_shared_from_this<C
 
     // entries always have matching entry in a Channel::opByIOID
     std::map<uint32_t, RequestInfo> opByIOID;
+    // type of operations cancelled with shared memory in use.  cf. ShmSegment::ShmDestroyed
+    std::map<uint32_t, Value> shmDrain;
 
     uint32_t nextIOID = 0x10002000u;
 
@@ -144,6 +148,8 @@ public:
     CASE(GET_FIELD);
 
     CASE(MESSAGE);
+
+    CASE(PVXS_SHM);
 #undef CASE
 
     void handle_GPR(pva_app_msg_t cmd);
@@ -209,6 +215,9 @@ struct Channel {
     std::list<ConnectImpl*> connectors;
 
     size_t statTx{}, statRx{};
+    Report::Timing timing;
+    // monotonicNS() when state became Searching, or zero after connect timing recorded.
+    uint64_t searchStart;
 
     INST_COUNTER(Channel);
 
@@ -240,6 +249,7 @@ private:
     // unused for this special case
     virtual void _reExecGet(std::function<void (Result &&)> &&resultcb) override final;
     virtual void _reExecPut(const Value &arg, std::function<void (Result &&)> &&resultcb) override final;
+    virtual void _reExecRPC(const Value &arg, std::function<void (Result &&)> &&resultcb) override final;
     virtual void createOp() override final;
     virtual void disconnected(const std::shared_ptr<OperationBase> &self) override final;
 };
@@ -71,6 +71,7 @@ struct InfoOp : public OperationBase
     // not meaningful for GET_FIELD operation
     void _reExecGet(std::function<void(client::Result&&)>&& resultcb) override final {}
     void _reExecPut(const Value& arg, std::function<void(client::Result&&)>&& resultcb) override final {}
+    void _reExecRPC(const Value& arg, std::function<void(client::Result&&)>&& resultcb) override final {}
 
     virtual void createOp() override final
     {
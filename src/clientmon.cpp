@@ -16,7 +16,7 @@
 namespace pvxs {
 namespace client {
 
-typedef epicsGuard<epicsMutex> Guard;
+typedef epicsGuard<ProfiledMutex> Guard;
 
 DEFINE_LOGGER(monevt, "pvxs.client.monitor");
 DEFINE_LOGGER(io, "pvxs.client.io");
@@ -50,6 +50,7 @@ struct SubscriptionImpl final : public OperationBase, public Subscription
 
     // only access from loop
     mutable std::weak_ptr<Subscription>     external_internal; // 'self' wrapped to be returned by shared_from_this()
+    uint64_t lastArrival = 0u; // monotonicNS() of previous update
 
     enum state_t : uint8_t {
         Connecting, // waiting for an active Channel
@@ -59,7 +60,7 @@ struct SubscriptionImpl final : public OperationBase, public Subscription
         Done,       // Finished or error
     } state = Connecting;
 
-    mutable epicsMutex lock;
+    mutable ProfiledMutex lock{"Subscription"};
 
     // guarded by lock
 
@@ -69,6 +70,7 @@ struct SubscriptionImpl final : public OperationBase, public Subscription
     size_t nSrvSquash =0u;
     size_t nCliSquash =0u;
     size_t queueMax =0u;
+    TimeHistogram interArrival, decode;
     // user code has seen pop()==nullptr
     bool needNotify = true;
     bool ackPending = false; // ackTick scheduled
@@ -151,8 +153,12 @@ struct SubscriptionImpl final : public OperationBase, public Subscription
         ret.nSrvSquash = nSrvSquash;
         ret.nCliSquash = nCliSquash;
         ret.nQueue = queue.size();
+        ret.interArrival = interArrival;
+        ret.decode = decode;
         if(reset) {
             nSrvSquash = nCliSquash = queueMax = 0u;
+            interArrival.clear();
+            decode.clear();
         }
     }
 
@@ -318,6 +324,7 @@ struct SubscriptionImpl final : public OperationBase, public Subscription
     // an artifact of using OperationBase for convenience
     void _reExecGet(std::function<void(client::Result&&)>&& resultcb) override final {}
     void _reExecPut(const Value& arg, std::function<void(client::Result&&)>&& resultcb) override final {}
+    void _reExecRPC(const Value& arg, std::function<void(client::Result&&)>&& resultcb) override final {}
 
     virtual void createOp() override final
     {
@@ -465,6 +472,7 @@ void Connection::handle_MONITOR()
 {
     auto rxlen = 8u + evbuffer_get_length(segBuf.get());
     EvInBuf M(peerBE, segBuf.get(), 16);
+    M.shm = shm.get();
 
     uint32_t ioid=0;
     uint8_t subcmd=0;
@@ -483,13 +491,22 @@ void Connection::handle_MONITOR()
 
     RequestInfo* info=nullptr;
     bool servSquash = false;
+    uint64_t arrival = 0u, decodeTime = 0u;
     if(M.good()) {
         auto it = opByIOID.find(ioid);
         if(it!=opByIOID.end()) {
             info = &it->second;
 
         } else {
-            if(!init) {
+            auto drain = shmDrain.find(ioid);
+            if(drain!=shmDrain.end() && !init && sts.isSuccess() && !M.empty()) {
+                // cancelled.  decode anyway to release any shared memory blocks.
+                auto junk(drain->second.cloneEmpty());
+                from_wire_valid(M, rxRegistry, junk);
+                if(!M.good())
+                    rxRegistryDirty = true;
+
+            } else if(!init) {
                 rxRegistryDirty = true;
             }
 
@@ -545,10 +562,15 @@ void Connection::handle_MONITOR()
 
                 Value::Helper::set_desc(data, desc);
             }
+            auto decodeStart(monotonicNS());
+
             from_wire_valid(M, rxRegistry, data);
 
             cache_sync(info->prototype, data);
 
+            arrival = monotonicNS();
+            decodeTime = arrival - decodeStart;
+
             BitMask overrun;
             from_wire(M, overrun);
             for(auto i : range(overrun.wsize())) {
@@ -605,6 +627,16 @@ void Connection::handle_MONITOR()
 
     mon->chan->statRx += rxlen;
 
+    uint64_t interval = 0u;
+    if(arrival) {
+        if(mon->lastArrival) {
+            interval = arrival - mon->lastArrival;
+            mon->chan->timing.interArrival.sample(interval);
+        }
+        mon->lastArrival = arrival;
+        mon->chan->timing.decode.sample(decodeTime);
+    }
+
     Entry update;
 
     if(!sts.isSuccess()) {
@@ -718,19 +750,24 @@ void Connection::handle_MONITOR()
             notify = mon->wantToNotify();
         if(servSquash)
             mon->nSrvSquash++;
+        if(arrival) {
+            if(interval)
+                mon->interArrival.sample(interval);
+            mon->decode.sample(decodeTime);
+        }
     } // release mon->lock
 
     if(mon->state==SubscriptionImpl::Done || final) {
         mon->state=SubscriptionImpl::Done;
 
+        if(!final)
+            sendDestroyRequest(mon->chan->sid, ioid);
+
         opByIOID.erase(ioid);
         mon->chan->opByIOID.erase(ioid);
 
         if(mon->pipeline)
             (void)event_del(mon->ackTick.get());
-
-        if(!final)
-            sendDestroyRequest(mon->chan->sid, ioid);
     }
 
     if(notify)
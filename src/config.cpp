@@ -35,6 +35,12 @@ SockEndpoint::SockEndpoint(const char* ep, uint16_t defport)
     // <IP46>,<ttl#>
     // <IP46>@ifacename
     // <IP46>,<ttl#>@ifacename
+    // unix:/path
+    if(strncmp(ep, "unix:", 5u)==0) {
+        addr.setAddress(ep);
+        return;
+    }
+
     auto comma = strchr(ep, ',');
     auto at = strchr(ep, '@');
 
@@ -226,6 +232,21 @@ void parse_timeout(double& dest, const std::string& name, const std::string& val
     }
 }
 
+void parse_double(double& dest, const std::string& name, const std::string& val)
+{
+    try {
+        auto temp = parseTo<double>(val);
+
+        if(!std::isfinite(temp) || temp<0.0)
+            throw std::out_of_range("Out of range");
+
+        dest = temp;
+    } catch(std::exception& e) {
+        log_err_printf(config, "%s invalid double value : '%s'\n",
+                       name.c_str(), val.c_str());
+    }
+}
+
 struct PickOne {
     const std::map<std::string, std::string>& defs;
     bool useenv;
@@ -433,6 +454,46 @@ void _fromDefs(Config& self, const std::map<std::string, std::string>& defs, boo
     if(pickone({"EPICS_PVA_CONN_TMO"})) {
         parse_timeout(self.tcpTimeout, pickone.name, pickone.val);
     }
+
+    if(pickone({"PVXS_SERVER_LATENCY_STATS"})) {
+        parse_bool(self.latencyStats, pickone.name, pickone.val);
+    }
+
+    if(pickone({"PVXS_SERVER_STATS_PV"})) {
+        self.statsPV = pickone.val;
+    }
+
+    if(pickone({"PVXS_SERVER_STATS_PERIOD"})) {
+        parse_double(self.statsPeriod, pickone.name, pickone.val);
+    }
+
+    if(pickone({"PVXS_SERVER_SHM_SIZE"})) {
+        try {
+            self.shmSize = parseTo<uint64_t>(pickone.val);
+        }catch(std::exception& e) {
+            log_err_printf(serversetup, "%s invalid integer : %s", pickone.name.c_str(), e.what());
+        }
+    }
+
+    if(pickone({"PVXS_SERVER_UNIX_PATH"})) {
+        self.unixPath = pickone.val;
+    }
+
+    if(pickone({"PVXS_SERVER_COMPRESS_THRESHOLD"})) {
+        try {
+            self.compressThreshold = parseTo<uint64_t>(pickone.val);
+        }catch(std::exception& e) {
+            log_err_printf(serversetup, "%s invalid integer : %s", pickone.name.c_str(), e.what());
+        }
+    }
+
+    if(pickone({"PVXS_SERVER_COMPRESS_BUDGET"})) {
+        parse_double(self.compressBudget, pickone.name, pickone.val);
+    }
+
+    if(pickone({"PVXS_SERVER_SEARCH_REPLY_HOLD"})) {
+        parse_double(self.searchReplyHold, pickone.name, pickone.val);
+    }
 }
 
 Config& Config::applyEnv()
@@ -479,6 +540,14 @@ void Config::updateDefs(defs_t& defs) const
     defs["EPICS_PVA_INTF_ADDR_LIST"] = defs["EPICS_PVAS_INTF_ADDR_LIST"]   = join_addr(interfaces);
     defs["EPICS_PVAS_IGNORE_ADDR_LIST"]   = join_addr(ignoreAddrs);
     defs["EPICS_PVA_CONN_TMO"] = SB()<<tcpTimeout/tmoScale;
+    defs["PVXS_SERVER_LATENCY_STATS"] = latencyStats ? "YES" : "NO";
+    defs["PVXS_SERVER_STATS_PV"] = statsPV;
+    defs["PVXS_SERVER_STATS_PERIOD"] = SB()<<statsPeriod;
+    defs["PVXS_SERVER_SHM_SIZE"] = SB()<<shmSize;
+    defs["PVXS_SERVER_UNIX_PATH"] = unixPath;
+    defs["PVXS_SERVER_COMPRESS_THRESHOLD"] = SB()<<compressThreshold;
+    defs["PVXS_SERVER_COMPRESS_BUDGET"] = SB()<<compressBudget;
+    defs["PVXS_SERVER_SEARCH_REPLY_HOLD"] = SB()<<searchReplyHold;
 }
 
 void Config::expand()
@@ -525,6 +594,18 @@ void Config::expand()
 
     enforceTimeout(tcpTimeout);
 
+    if(!std::isfinite(statsPeriod) || statsPeriod<=0.0)
+        statsPeriod = 5.0;
+    else if(statsPeriod < 0.1)
+        statsPeriod = 0.1;
+
+    if(!std::isfinite(compressBudget) || compressBudget<=0.0 || compressBudget>1.0)
+        compressBudget = 0.1;
+
+    if(!std::isfinite(searchReplyHold) || searchReplyHold<0.0)
+        searchReplyHold = 0.0;
+    else if(searchReplyHold > 0.1)
+        searchReplyHold = 0.1;
 }
 
 std::ostream& operator<<(std::ostream& strm, const Config& conf)
@@ -533,11 +614,15 @@ std::ostream& operator<<(std::ostream& strm, const Config& conf)
     conf.updateDefs(defs);
 
     for(const auto& pair : defs) {
-        // only print the server variant
+        // only print the server variant, and PVXS specific options
         static const char prefix[] = "EPICS_PVAS_";
-        if(pair.first.size() >= sizeof(prefix)-1u && strncmp(pair.first.c_str(),
-                                                             prefix,
-                                                             sizeof(prefix)-1u)==0)
+        static const char xprefix[] = "PVXS_SERVER_";
+        if((pair.first.size() >= sizeof(prefix)-1u && strncmp(pair.first.c_str(),
+                                                              prefix,
+                                                              sizeof(prefix)-1u)==0)
+                || (pair.first.size() >= sizeof(xprefix)-1u && strncmp(pair.first.c_str(),
+                                                                       xprefix,
+                                                                       sizeof(xprefix)-1u)==0))
             strm<<indent{}<<pair.first<<'='<<pair.second<<'\n';
     }
     return strm;
@@ -10,6 +10,7 @@
 
 #include <pvxs/log.h>
 #include "conn.h"
+#include "iouring.h"
 
 DEFINE_LOGGER(connsetup, "pvxs.tcp.setup");
 DEFINE_LOGGER(connio, "pvxs.tcp.io");
@@ -26,9 +27,51 @@ namespace impl {
 static
 constexpr size_t tcp_readahead_mult = 2u;
 
-ConnBase::ConnBase(bool isClient, bool sendBE, bufferevent* bev, const SockAddr& peerAddr)
+ConnBev::~ConnBev()
+{
+    reset();
+}
+
+ConnBev ConnBev::create(const evbase& loop, evutil_socket_t sock)
+{
+    ConnBev ret;
+    if(auto ring = loop.uring()) {
+        ret.io = UringConn::create(ring, sock, ret.bev);
+    } else {
+        ret.bev = evbufferevent(__FILE__, __LINE__,
+                                bufferevent_socket_new(loop.base, sock, BEV_OPT_CLOSE_ON_FREE|BEV_OPT_DEFER_CALLBACKS));
+    }
+    return ret;
+}
+
+void ConnBev::reset()
+{
+    // free our end of the pair before the other
+    bev.reset();
+    if(io) {
+        io->close();
+        io.reset();
+    }
+}
+
+evutil_socket_t ConnBev::fd() const
+{
+    if(io)
+        return io->fd();
+    return bev ? bufferevent_getfd(bev.get()) : evutil_socket_t(-1);
+}
+
+int ConnBev::connect(const SockAddr& peer, const timeval& timeout)
+{
+    if(io)
+        return io->connect(&peer->sa, peer.size(), timeout);
+    return bufferevent_socket_connect(bev.get(), const_cast<sockaddr*>(&peer->sa), peer.size());
+}
+
+ConnBase::ConnBase(bool isClient, bool sendBE, ConnBev&& bev, const SockAddr& peerAddr,
+                   const std::string& peerName)
     :peerAddr(peerAddr)
-    ,peerName(peerAddr.tostring())
+    ,peerName(peerName.empty() ? peerAddr.tostring() : peerName)
     ,isClient(isClient)
     ,sendBE(sendBE)
     ,peerBE(true) // arbitrary choice, default should be overwritten before use
@@ -40,8 +83,7 @@ ConnBase::ConnBase(bool isClient, bool sendBE, bufferevent* bev, const SockAddr&
     ,state(Holdoff)
 {
     if(bev) { // true for server connection.  client will call connect() shortly
-        decltype(this->bev) temp(__FILE__, __LINE__, bev);
-        connect(std::move(temp));
+        connect(std::move(bev));
     }
 }
 
@@ -52,13 +94,13 @@ const char* ConnBase::peerLabel() const
     return isClient ? "Server" : "Client";
 }
 
-void ConnBase::connect(ev_owned_ptr<bufferevent> &&bev)
+void ConnBase::connect(ConnBev &&bev)
 {
     if(!bev)
         throw BAD_ALLOC();
     assert(!this->bev && state==Holdoff);
 
-    readahead = evsocket::get_buffer_size(bufferevent_getfd(bev.get()), false);
+    readahead = evsocket::get_buffer_size(bev.fd(), false);
 
 #if LIBEVENT_VERSION_NUMBER >= 0x02010000
     // allow to drain OS socket buffer in a single read
@@ -90,6 +132,28 @@ size_t ConnBase::enqueueTxBody(pva_app_msg_t cmd)
 {
     auto blen = evbuffer_get_length(txBody.get());
     auto tx = bufferevent_get_output(bev.get());
+
+    if(zipTx && blen >= zipTx->threshold && blen <= 0xffffffffu) {
+        auto body = evbuffer_pullup(txBody.get(), -1);
+        if(body && zipTx->encode(zipScratch, body, blen)) {
+            {
+                EvOutBuf R(sendBE, tx, 13u);
+                to_wire(R, Header{CMD_PVXS_ZIPPED,
+                                  uint8_t(isClient ? 0u : pva_flags::Server),
+                                  uint32_t(5u + zipScratch.size())});
+                to_wire(R, uint8_t(cmd));
+                to_wire(R, uint32_t(blen));
+                if(!R.good())
+                    throw BAD_ALLOC();
+            }
+            if(evbuffer_add(tx, zipScratch.data(), zipScratch.size()))
+                throw BAD_ALLOC();
+            (void)evbuffer_drain(txBody.get(), blen);
+            statTx += 13u + zipScratch.size();
+            return 13u + zipScratch.size();
+        }
+    }
+
     to_evbuf(tx, Header{cmd,
                         uint8_t(isClient ? 0u : pva_flags::Server),
                         uint32_t(blen)},
@@ -121,8 +185,36 @@ size_t ConnBase::enqueueTxBody(pva_app_msg_t cmd)
     CASE(GET_FIELD);
 
     CASE(MESSAGE);
+
+    CASE(PVXS_SHM);
+    CASE(PVXS_ZIP);
 #undef CASE
 
+void ConnBase::unzip()
+{
+    uint8_t cmd = 0u;
+    uint32_t nout = 0u;
+    {
+        EvInBuf M(peerBE, segBuf.get(), 16);
+        from_wire(M, cmd);
+        from_wire(M, nout);
+        if(!M.good() || !zipRx || cmd==CMD_PVXS_ZIPPED)
+            throw std::runtime_error("Invalid, or unexpected, PVXS_ZIPPED");
+    }
+
+    auto nin = evbuffer_get_length(segBuf.get());
+    auto in = evbuffer_pullup(segBuf.get(), -1);
+    if(!in && nin)
+        throw BAD_ALLOC();
+
+    auto out = zipRx->decode(in, nin, nout);
+
+    (void)evbuffer_drain(segBuf.get(), nin);
+    if(evbuffer_add(segBuf.get(), out, nout))
+        throw BAD_ALLOC();
+    segCmd = cmd;
+}
+
 void ConnBase::bevEvent(short events)
 {
     if(events&(BEV_EVENT_EOF|BEV_EVENT_ERROR|BEV_EVENT_TIMEOUT)) {
@@ -246,6 +338,9 @@ void ConnBase::bevRead()
 
             // ready to process segBuf
             try {
+                if(segCmd==CMD_PVXS_ZIPPED)
+                    unzip();
+
                 switch(segCmd) {
                 default:
                     log_debug_printf(connio, "%s %s Ignore unexpected command 0x%02x\n", peerLabel(), peerName.c_str(), segCmd);
@@ -272,6 +367,9 @@ void ConnBase::bevRead()
                     CASE(GET_FIELD);
 
                     CASE(MESSAGE);
+
+                    CASE(PVXS_SHM);
+                    CASE(PVXS_ZIP);
     #undef CASE
                 }
             }catch(std::exception& e){
@@ -308,6 +406,7 @@ void ConnBase::bevEventS(struct bufferevent *bev, short events, void *ptr)
 {
     auto conn = static_cast<ConnBase*>(ptr)->self_from_this();
     try {
+        LoopTimer T("bev event", conn->peerName.c_str());
         conn->bevEvent(events);
     }catch(std::exception& e){
         log_exc_printf(connsetup, "%s %s Unhandled error in bev event callback: %s\n", conn->peerLabel(), conn->peerName.c_str(), e.what());
@@ -319,6 +418,7 @@ void ConnBase::bevReadS(struct bufferevent *bev, void *ptr)
 {
     auto conn = static_cast<ConnBase*>(ptr)->self_from_this();
     try {
+        LoopTimer T("bev read", conn->peerName.c_str());
         conn->bevRead();
     }catch(std::exception& e){
         log_exc_printf(connsetup, "%s %s Unhandled error in bev read callback: %s\n", conn->peerLabel(), conn->peerName.c_str(), e.what());
@@ -330,6 +430,7 @@ void ConnBase::bevWriteS(struct bufferevent *bev, void *ptr)
 {
     auto conn = static_cast<ConnBase*>(ptr)->self_from_this();
     try {
+        LoopTimer T("bev write", conn->peerName.c_str());
         conn->bevWrite();
     }catch(std::exception& e){
         log_exc_printf(connsetup, "%s %s Unhandled error in bev write callback: %s\n", conn->peerLabel(), conn->peerName.c_str(), e.what());
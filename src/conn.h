@@ -9,16 +9,57 @@
 #include "evhelper.h"
 #include "dataimpl.h"
 #include "utilpvt.h"
+#include "zip.h"
 
 namespace pvxs {
 namespace impl {
 
+/* Pipelined GET/PUT/RPC EXEC.  (pvxs extension)
+ *   - Server includes "x-pvxs-pipeline" in its CONNECTION_VALIDATION auth list (ignored by others)
+ *   - Server queues an EXEC received while a previous EXEC of the same operation is in progress.
+ *     Replies are sent in the order received.
+ *   - Client may then send up to this many EXECs before receiving the first reply.
+ */
+constexpr size_t maxPipelineExec = 16u;
+
+struct UringConn;
+
+/* The bufferevent of a connection.  A socket bufferevent,
+ * or with $PVXS_EVENT_BACKEND=io_uring, one end of a pair.  cf. iouring.h
+ */
+struct ConnBev {
+    ConnBev() = default;
+    ConnBev(ConnBev&&) = default;
+    ConnBev& operator=(ConnBev&& o) {
+        reset();
+        bev = std::move(o.bev);
+        io = std::move(o.io);
+        return *this;
+    }
+    ~ConnBev();
+
+    //! New connection on an accepted socket, or with sock==-1 to connect() later.
+    static ConnBev create(const evbase& loop, evutil_socket_t sock);
+
+    bufferevent* get() const { return bev.get(); }
+    explicit operator bool() const { return bool(bev); }
+    void reset();
+
+    evutil_socket_t fd() const;
+    //! As bufferevent_socket_connect().  timeout applies only to io_uring.  cf. bufferevent_set_timeouts()
+    int connect(const SockAddr& peer, const timeval& timeout);
+
+private:
+    evbufferevent bev;
+    std::shared_ptr<UringConn> io;
+};
+
 struct ConnBase
 {
     const SockAddr peerAddr;
     const std::string peerName;
 protected:
-    evbufferevent bev;
+    ConnBev bev;
 public:
     TypeStore rxRegistry;
     /* Flag if some received delta could not be decoded due to
@@ -40,6 +81,13 @@ public:
     uint8_t segCmd;
     evbuf segBuf, txBody;
 
+    // when negotiated, used to transfer large arrays
+    std::shared_ptr<ShmSegment> shm;
+    // when negotiated, compress (server) or expand (client) message bodies
+    std::unique_ptr<ZipEncoder> zipTx;
+    std::unique_ptr<ZipDecoder> zipRx;
+    std::vector<uint8_t> zipScratch;
+
     size_t statTx{}, statRx{};
     size_t readahead{};
 
@@ -50,7 +98,9 @@ public:
         Disconnected,
     } state;
 
-    ConnBase(bool isClient, bool sendBE, bufferevent* bev, const SockAddr& peerAddr);
+    // peerName defaults to peerAddr.tostring()
+    ConnBase(bool isClient, bool sendBE, ConnBev&& bev, const SockAddr& peerAddr,
+             const std::string& peerName = std::string());
     ConnBase(const ConnBase&) = delete;
     ConnBase& operator=(const ConnBase&) = delete;
     virtual ~ConnBase();
@@ -61,7 +111,7 @@ public:
 
     bufferevent* connection() { return bev.get(); }
 
-    void connect(ev_owned_ptr<bufferevent>&& bev);
+    void connect(ConnBev&& bev);
     void disconnect();
 
 protected:
@@ -86,8 +136,14 @@ protected:
     CASE(GET_FIELD);
 
     CASE(MESSAGE);
+
+    CASE(PVXS_SHM);
+    CASE(PVXS_ZIP);
 #undef CASE
 
+    // replace CMD_PVXS_ZIPPED in segBuf with original
+    void unzip();
+
     virtual std::shared_ptr<ConnBase> self_from_this() =0;
     virtual void cleanup() =0;
     virtual void bevEvent(short events);
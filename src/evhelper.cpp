@@ -25,17 +25,19 @@
 #include <epicsString.h>
 #include <epicsThread.h>
 #include <epicsExit.h>
+#include <epicsStdlib.h>
 #include <epicsMutex.h>
 #include <epicsGuard.h>
 #include <dbDefs.h>
 #include <ellLib.h>
 
 #include "evhelper.h"
+#include "iouring.h"
 #include "pvaproto.h"
 #include "utilpvt.h"
 #include <pvxs/log.h>
 
-typedef epicsGuard<epicsMutex> Guard;
+typedef epicsGuard<pvxs::impl::ProfiledMutex> Guard;
 
 // EvInBuf prefers to extract slices of this length from a backing buffer
 static constexpr
@@ -47,14 +49,54 @@ DEFINE_LOGGER(logerr, "pvxs.loop");
 DEFINE_LOGGER(logtimer, "pvxs.timer");
 DEFINE_LOGGER(logiface, "pvxs.iface");
 DEFINE_LOGGER(logsock, "pvxs.sock");
+DEFINE_LOGGER(logstall, "pvxs.loop.stall");
 
 namespace mdetail {
 VFunctor0::~VFunctor0() {}
 }
 
+// evbase::Pvt* of the current worker thread
+static
+epicsThreadPrivateId currentLoop;
+
+uint64_t LoopTimer::threshold;
+
+// $PVXS_EVENT_BACKEND
+static std::string evMethod;
+static bool evUring;
+
 static
 void evthread_init()
 {
+    currentLoop = epicsThreadPrivateCreate();
+
+    if(auto env = getenv("PVXS_EVENT_BACKEND")) {
+        std::string supported;
+        for(auto m = event_get_supported_methods(); m && *m; m++) {
+            if(strcmp(env, *m)==0)
+                evMethod = env;
+            supported += ' ';
+            supported += *m;
+        }
+        if(strcmp(env, "io_uring")==0) {
+            // connection I/O only.  cf. evbase::uring()
+            evUring = true;
+        } else if(evMethod.empty() && env[0]!='\0') {
+            log_warn_printf(logerr, "PVXS_EVENT_BACKEND=%s not supported, using default.  Supported:%s io_uring\n",
+                            env, supported.c_str());
+        }
+    }
+
+    if(auto env = getenv("PVXS_LOOP_STALL_THRESHOLD")) {
+        double thres = 0.0;
+        if(epicsParseDouble(env, &thres, nullptr) || thres<0.0) {
+            log_warn_printf(logstall, "PVXS_LOOP_STALL_THRESHOLD=%s ignoring invalid\n", env);
+        } else {
+            LoopTimer::threshold = uint64_t(thres*1e9);
+            log_info_printf(logstall, "Loop stall threshold %f sec.\n", thres);
+        }
+    }
+
 #if defined(EVTHREAD_USE_WINDOWS_THREADS_IMPLEMENTED)
     evthread_use_windows_threads();
 
@@ -133,17 +175,30 @@ struct evbase::Pvt final : public epicsThreadRunable
     evevent keepalive;
     evevent dowork;
     epicsEvent start_sync;
-    epicsMutex lock;
+    ProfiledMutex lock{"evbase"};
 
     epicsThread worker;
     bool running = true;
 
+    const std::string name;
+
+    // stall detection.  Only when LoopTimer::threshold is non-zero.
+    bool timing = false; // worker only.  true while a LoopTimer is active
+    ProfiledMutex statsLock{"evbase.stats"};
+    TimeHistogram callbacks;
+    uint64_t nstalls = 0u;
+
+    // worker only.  cf. evbase::uring()
+    std::shared_ptr<IOURing> uring;
+    bool uringFailed = false;
+
     INST_COUNTER(evbase);
 
     Pvt(const std::string& name, unsigned prio)
         :worker(*this, name.c_str(),
                 epicsThreadGetStackSize(epicsThreadStackBig),
                 prio)
+        ,name(name)
     {
         threadOnce<&evthread_init>();
 
@@ -172,6 +227,7 @@ struct evbase::Pvt final : public epicsThreadRunable
     virtual void run() override final
     {
         evbaseRunning track;
+        epicsThreadPrivateSet(currentLoop, this);
         try {
             evconfig conf(__FILE__, __LINE__, event_config_new());
 #ifdef __rtems__
@@ -182,7 +238,24 @@ struct evbase::Pvt final : public epicsThreadRunable
              */
             event_config_avoid_method(conf.get(), "kqueue");
 #endif
-            decltype (base) tbase(__FILE__, __LINE__, event_base_new_with_config(conf.get()));
+            if(!evMethod.empty()) {
+                // no way to request a method, so avoid all others
+                for(auto m = event_get_supported_methods(); m && *m; m++) {
+                    if(evMethod!=*m)
+                        event_config_avoid_method(conf.get(), *m);
+                }
+            }
+            auto raw(event_base_new_with_config(conf.get()));
+            if(!raw && !evMethod.empty()) {
+                log_warn_printf(logerr, "Unable to use event backend '%s'.  Fall back to default\n",
+                                evMethod.c_str());
+                evconfig dflt(__FILE__, __LINE__, event_config_new());
+#ifdef __rtems__
+                event_config_avoid_method(dflt.get(), "kqueue");
+#endif
+                raw = event_base_new_with_config(dflt.get());
+            }
+            decltype (base) tbase(__FILE__, __LINE__, raw);
             if(evthread_make_base_notifiable(tbase.get())) {
                 throw std::runtime_error("evthread_make_base_notifiable");
             }
@@ -206,6 +279,9 @@ struct evbase::Pvt final : public epicsThreadRunable
 
             int ret = event_base_loop(base.get(), 0);
 
+            if(uring)
+                uring->shutdown();
+
             auto lvl = ret ? Level::Crit : Level::Info;
             log_printf(logerr, lvl, "Exit loop worker: %d for %p\n", ret, base.get());
 
@@ -226,6 +302,7 @@ struct evbase::Pvt final : public epicsThreadRunable
         for(auto& work : todo) {
             try {
                 auto fn(std::move(work.fn));
+                LoopTimer T("work", fn.name());
                 fn();
             }catch(std::exception& e){
                 if(work.result) {
@@ -358,6 +435,68 @@ void evbase::assertInLoop() const
     }
 }
 
+std::string evbase::name() const
+{
+    return pvt->name;
+}
+
+std::shared_ptr<IOURing> evbase::uring() const
+{
+    if(!evUring)
+        return nullptr;
+    assertInLoop();
+    if(!pvt->uring && !pvt->uringFailed) {
+        pvt->uring = IOURing::create(base);
+        if(!pvt->uring) {
+            pvt->uringFailed = true;
+            log_warn_printf(logerr, "%s: io_uring not available.  Fall back to libevent\n",
+                            pvt->name.c_str());
+        }
+    }
+    return pvt->uring;
+}
+
+bool evbase::stats(TimeHistogram& callbacks, uint64_t& stalls, bool zero) const
+{
+    if(!LoopTimer::threshold)
+        return false;
+
+    Guard G(pvt->statsLock);
+    callbacks = pvt->callbacks;
+    stalls = pvt->nstalls;
+    if(zero) {
+        pvt->callbacks.clear();
+        pvt->nstalls = 0u;
+    }
+    return true;
+}
+
+void LoopTimer::start()
+{
+    auto cur = static_cast<evbase::Pvt*>(epicsThreadPrivateGet(currentLoop));
+    if(cur && !cur->timing) {
+        cur->timing = true;
+        loop = cur;
+        begin = monotonicNS();
+    }
+}
+
+void LoopTimer::stop()
+{
+    auto dT = monotonicNS() - begin;
+    loop->timing = false;
+    bool stalled = dT >= threshold;
+    {
+        Guard G(loop->statsLock);
+        loop->callbacks.sample(dT);
+        if(stalled)
+            loop->nstalls++;
+    }
+    if(stalled)
+        log_err_printf(logstall, "%s stalled for %.3f ms in %s %s\n",
+                        loop->name.c_str(), double(dT)*1e-6, origin, detail ? detail : "");
+}
+
 bool evbase::assertInRunningLoop() const
 {
     if(pvt->worker.isCurrentThread())
@@ -390,7 +529,11 @@ evsocket::evsocket(int af, evutil_socket_t sock, bool blocking)
 #endif
         throw std::system_error(err, std::system_category());
     }
-    if(af!=AF_INET && af!=AF_INET6) {
+    if(af!=AF_INET && af!=AF_INET6
+#ifdef PVXS_HAVE_AF_UNIX
+            && af!=AF_UNIX
+#endif
+            ) {
         evutil_closesocket(sock);
         throw std::logic_error("Unsupported address family");
     }
@@ -656,6 +799,24 @@ size_t evsocket::get_buffer_size(evutil_socket_t sock, bool tx)
     return ret;
 }
 
+bool evsocket::peer_credentials(evutil_socket_t sock, int64_t& pid, int64_t& uid)
+{
+#if defined(__linux__) && defined(SO_PEERCRED)
+    struct ucred cred{};
+    socklen_t len(sizeof(cred));
+    if(getsockopt(sock, SOL_SOCKET, SO_PEERCRED, &cred, &len)==0 && len==sizeof(cred)) {
+        pid = cred.pid;
+        uid = cred.uid;
+        return true;
+    }
+#else
+    (void)sock;
+    (void)pid;
+    (void)uid;
+#endif
+    return false;
+}
+
 #if defined(_WIN32) && !defined(EAFNOSUPPORT)
 #  define EAFNOSUPPORT WSAESOCKTNOSUPPORT
 #endif
@@ -1092,6 +1253,7 @@ void expire_cb(evutil_socket_t, short, void * raw)
     assert(self->base.base);
 
     try {
+        LoopTimer T("timer", self->cb.target_type().name());
         self->cb();
     } catch(std::exception& e){
         log_exc_printf(logtimer, "Unhandled exception in Timer callback: %s\n", e.what());
@@ -13,6 +13,7 @@
 #include <string>
 #include <map>
 #include <set>
+#include <typeinfo>
 
 #include <event2/event.h>
 #include <event2/buffer.h>
@@ -151,10 +152,16 @@ struct mfunction {
     explicit operator bool() const {
         return fn.operator bool();
     }
+    //! (mangled) type name of the wrapped functor
+    const char* name() const {
+        return fn ? typeid(*fn).name() : "<null>";
+    }
 private:
     std::unique_ptr<mdetail::VFunctor0> fn;
 };
 
+struct IOURing;
+
 struct PVXS_API evbase {
     evbase() = default;
     explicit evbase(const std::string& name, unsigned prio=0);
@@ -205,13 +212,62 @@ public:
 
     inline void reset() { pvt.reset(); }
 
+    //! Name of worker thread
+    std::string name() const;
+
+    /** Copy, and optionally zero, callback timing statistics.
+     * @returns false if stall detection is disabled, and the arguments are not changed.
+     */
+    bool stats(TimeHistogram& callbacks, uint64_t& stalls, bool zero) const;
+
+    /** With $PVXS_EVENT_BACKEND=io_uring, the ring of this worker.  Created on first call.
+     *  Call from the worker.
+     *  @returns nullptr when using libevent for connection I/O.
+     */
+    std::shared_ptr<IOURing> uring() const;
+
 private:
     struct Pvt;
     std::shared_ptr<Pvt> pvt;
+    friend struct LoopTimer;
 public:
     event_base* base = nullptr;
 };
 
+/* Scoped timing of a callback from an evbase worker for stall detection.
+ * Enabled by $PVXS_LOOP_STALL_THRESHOLD.  A no-op when disabled,
+ * when not called from an evbase worker, or when nested within another LoopTimer.
+ *
+ * @code
+ *   LoopTimer T("bev read", conn->peerName.c_str());
+ * @endcode
+ */
+struct PVXS_API LoopTimer {
+    explicit LoopTimer(const char* origin, const char* detail=nullptr)
+        :origin(origin)
+        ,detail(detail)
+    {
+        if(threshold)
+            start();
+    }
+    LoopTimer(const LoopTimer&) = delete;
+    LoopTimer& operator=(const LoopTimer&) = delete;
+    ~LoopTimer() {
+        if(loop)
+            stop();
+    }
+
+    // in nanoseconds.  Zero when disabled.  Set once before the first evbase is started.
+    static uint64_t threshold;
+private:
+    const char* const origin;
+    const char* const detail;
+    evbase::Pvt* loop = nullptr;
+    uint64_t begin = 0u;
+    void start();
+    void stop();
+};
+
 template<typename T>
 using ev_owned_ptr = owned_ptr<T, ev_delete<T>>;
 typedef ev_owned_ptr<event_config> evconfig;
@@ -287,6 +343,11 @@ struct PVXS_API evsocket
     static
     size_t get_buffer_size(evutil_socket_t sock, bool tx);
 
+    //! Process and user IDs of the peer of a local (AF_UNIX) stream socket.
+    //! Returns false when not known.  Currently Linux only.
+    static
+    bool peer_credentials(evutil_socket_t sock, int64_t& pid, int64_t& uid);
+
     static
     bool canIPv6;
 
@@ -338,7 +399,7 @@ struct PVXS_API IfaceMap {
     };
 
     SockAttach attach;
-    epicsMutex lock;
+    ProfiledMutex lock{"IfaceMap"};
     std::map<uint64_t, Iface> byIndex;
     std::map<std::string, Iface*> byName;
     // map address to tuple of interface and broadcast?
@@ -0,0 +1,778 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+
+#include <algorithm>
+#include <set>
+
+#include <string.h>
+#include <errno.h>
+
+#if defined(__linux__)
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <sys/eventfd.h>
+#  include <sys/socket.h>
+#  include <unistd.h>
+#  include <fcntl.h>
+#  include <linux/io_uring.h>
+#  include <linux/time_types.h>
+   // IORING_REGISTER_PBUF_RING is an enum.  Test a macro added in the same release (5.19)
+#  if defined(__NR_io_uring_setup) && defined(IORING_SETUP_COOP_TASKRUN)
+#    define HAVE_IO_URING
+#  endif
+#endif
+
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
+
+#include <pvxs/log.h>
+
+#include "iouring.h"
+#include "utilpvt.h"
+
+namespace pvxs {
+namespace impl {
+
+DEFINE_LOGGER(loguring, "pvxs.tcp.uring");
+
+IOURing::~IOURing() {}
+UringConn::~UringConn() {}
+
+#ifdef HAVE_IO_URING
+
+namespace {
+
+constexpr unsigned sqSize = 256u;
+// provided receive buffers.  Data is copied out on completion,
+// so buffers are only briefly held.
+constexpr unsigned nRxBufs = 128u; // power of 2
+constexpr size_t rxBufSize = 32u*1024u;
+constexpr uint16_t rxGroup = 0u;
+// max. iovec of one SENDMSG
+constexpr int maxIOV = 64;
+
+template<typename T>
+T loadAcquire(const T* p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+template<typename T>
+void storeRelease(T* p, T v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+int sysSetup(unsigned entries, io_uring_params* p)
+{
+    return int(syscall(__NR_io_uring_setup, entries, p));
+}
+int sysEnter(int fd, unsigned submit, unsigned wait, unsigned flags,
+             const void* arg=nullptr, size_t argsz=0u)
+{
+    return int(syscall(__NR_io_uring_enter, fd, submit, wait, flags, arg, argsz));
+}
+int sysRegister(int fd, unsigned op, const void* arg, unsigned nargs)
+{
+    return int(syscall(__NR_io_uring_register, fd, op, arg, nargs));
+}
+
+size_t sockBufSize(int fd, int opt)
+{
+    int val = 0;
+    socklen_t len = sizeof(val);
+    if(getsockopt(fd, SOL_SOCKET, opt, &val, &len) || val<=0)
+        val = 0x10000;
+    return size_t(val);
+}
+
+struct Conn;
+
+struct Ring final : public IOURing, public std::enable_shared_from_this<Ring> {
+    event_base* const base;
+    int fd = -1;
+    int efd = -1;
+
+    void* sqMap = MAP_FAILED;
+    void* cqMap = MAP_FAILED;
+    size_t sqMapLen = 0u, cqMapLen = 0u;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqesLen = 0u;
+    unsigned *sqHead = nullptr, *sqTail = nullptr, *sqArray = nullptr;
+    unsigned sqMask = 0u, sqEntries = 0u;
+    unsigned *cqHead = nullptr, *cqTail = nullptr;
+    unsigned cqMask = 0u;
+    io_uring_cqe* cqes = nullptr;
+    unsigned localTail = 0u; // SQEs filled, including those not yet submitted
+    unsigned nPending = 0u;  // filled, but not yet submitted
+
+    io_uring_buf_ring* bufRing = static_cast<io_uring_buf_ring*>(MAP_FAILED);
+    size_t bufRingLen = 0u;
+    uint8_t* bufs = static_cast<uint8_t*>(MAP_FAILED);
+    uint16_t bufTail = 0u;
+
+    evevent completeEvt, submitEvt;
+    bool submitQueued = false;
+    bool dead = false;
+
+    std::set<Conn*> conns;
+    size_t nInflight = 0u;
+
+    explicit Ring(event_base* base) :base(base) {}
+    virtual ~Ring();
+
+    bool init();
+    virtual void shutdown() override final;
+
+    bool space(unsigned n);
+    io_uring_sqe* getSQE();
+    void submit();
+    void reap();
+    void cancel(uint64_t userData);
+
+    const uint8_t* buffer(uint16_t bid) const { return bufs + size_t(bid)*rxBufSize; }
+    void recycle(uint16_t bid);
+
+    static void onCompleteS(evutil_socket_t fd, short evt, void *raw);
+    static void onSubmitS(evutil_socket_t fd, short evt, void *raw);
+};
+
+struct Conn final : public UringConn, public std::enable_shared_from_this<Conn> {
+    enum op_t : uint64_t {
+        Recv = 1u,
+        Send = 2u,
+        Connect = 3u,
+    };
+
+    const std::shared_ptr<Ring> ring;
+    int sock = -1;
+    evbufferevent lower; // our end of the pair
+    bufferevent* upper;  // borrowed.  nullptr after close()
+    evbuf txInflight;    // being sent
+
+    sockaddr_storage peer{};
+    __kernel_timespec connTimeout{};
+    msghdr txMsg{};
+    iovec txIOV[maxIOV];
+
+    size_t rxLimit = 0u; // receive paused with this much not yet moved to upper
+    unsigned nInflight = 0u;
+    std::shared_ptr<Conn> keep; // while nInflight
+
+    bool connected = false;
+    bool connecting = false, receiving = false, sending = false;
+    bool rxStalled = false, rxEOF = false, failed = false, closed = false;
+
+    Conn(const std::shared_ptr<Ring>& ring, bufferevent* lower, bufferevent* upper)
+        :ring(ring)
+        ,lower(__FILE__, __LINE__, lower)
+        ,upper(upper)
+        ,txInflight(__FILE__, __LINE__, evbuffer_new())
+    {
+        ring->conns.insert(this);
+    }
+    virtual ~Conn();
+
+    virtual evutil_socket_t fd() const override final { return sock; }
+    virtual int connect(const sockaddr* addr, socklen_t alen, const timeval& timeout) override final;
+    virtual void close() override final;
+
+    uint64_t tag(op_t op) const { return reinterpret_cast<uintptr_t>(this) | op; }
+
+    void attached();
+    void begin();
+    void complete(op_t op, int res, uint32_t flags);
+    void abandon();
+
+    void startRecv();
+    void startSend();
+    void maybeEOF();
+    void fail(short what, int err);
+
+    static void onTxS(bufferevent *bev, void *raw);
+    static void onRxDrainS(evbuffer *buf, const evbuffer_cb_info *info, void *raw);
+};
+static_assert(alignof(Conn)>=4u, "Conn::tag() needs two low bits");
+
+Ring::~Ring()
+{
+    if(bufs!=MAP_FAILED)
+        munmap(bufs, nRxBufs*rxBufSize);
+    if(bufRing!=MAP_FAILED)
+        munmap(bufRing, bufRingLen);
+    if(sqes!=MAP_FAILED)
+        munmap(sqes, sqesLen);
+    if(cqMap!=MAP_FAILED && cqMap!=sqMap)
+        munmap(cqMap, cqMapLen);
+    if(sqMap!=MAP_FAILED)
+        munmap(sqMap, sqMapLen);
+    if(efd!=-1)
+        ::close(efd);
+    if(fd!=-1)
+        ::close(fd);
+}
+
+bool Ring::init()
+{
+    io_uring_params p{};
+    fd = sysSetup(sqSize, &p);
+    if(fd<0) {
+        log_warn_printf(loguring, "io_uring_setup() error %d\n", errno);
+        return false;
+    }
+    if(!(p.features & IORING_FEAT_NODROP) || !(p.features & IORING_FEAT_FAST_POLL)
+            || !(p.features & IORING_FEAT_EXT_ARG)) {
+        log_warn_printf(loguring, "io_uring features 0x%x not sufficient\n", unsigned(p.features));
+        return false;
+    }
+
+    sqMapLen = p.sq_off.array + p.sq_entries*sizeof(unsigned);
+    cqMapLen = p.cq_off.cqes + p.cq_entries*sizeof(io_uring_cqe);
+    if(p.features & IORING_FEAT_SINGLE_MMAP)
+        sqMapLen = cqMapLen = std::max(sqMapLen, cqMapLen);
+
+    sqMap = mmap(nullptr, sqMapLen, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if(sqMap==MAP_FAILED)
+        return false;
+    if(p.features & IORING_FEAT_SINGLE_MMAP) {
+        cqMap = sqMap;
+    } else {
+        cqMap = mmap(nullptr, cqMapLen, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if(cqMap==MAP_FAILED)
+            return false;
+    }
+    sqesLen = p.sq_entries*sizeof(io_uring_sqe);
+    sqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqesLen, PROT_READ|PROT_WRITE,
+                                           MAP_SHARED|MAP_POPULATE, fd, IORING_OFF_SQES));
+    if(sqes==MAP_FAILED)
+        return false;
+
+    auto sq = static_cast<uint8_t*>(sqMap);
+    sqHead = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+    sqTail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+    sqArray = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+    sqMask = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+    sqEntries = p.sq_entries;
+    localTail = *sqTail;
+
+    auto cq = static_cast<uint8_t*>(cqMap);
+    cqHead = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+    cqTail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+    cqMask = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+
+    // provided buffers.  Registration fails before Linux 5.19
+    bufRingLen = nRxBufs*sizeof(io_uring_buf);
+    bufRing = static_cast<io_uring_buf_ring*>(mmap(nullptr, bufRingLen, PROT_READ|PROT_WRITE,
+                                                   MAP_PRIVATE|MAP_ANONYMOUS, -1, 0));
+    bufs = static_cast<uint8_t*>(mmap(nullptr, nRxBufs*rxBufSize, PROT_READ|PROT_WRITE,
+                                      MAP_PRIVATE|MAP_ANONYMOUS, -1, 0));
+    if(bufRing==MAP_FAILED || bufs==MAP_FAILED)
+        return false;
+
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<uintptr_t>(bufRing);
+    reg.ring_entries = nRxBufs;
+    reg.bgid = rxGroup;
+    if(sysRegister(fd, IORING_REGISTER_PBUF_RING, &reg, 1u)) {
+        log_warn_printf(loguring, "io_uring provided buffer ring not supported (%d)\n", errno);
+        return false;
+    }
+    for(unsigned bid=0u; bid<nRxBufs; bid++)
+        recycle(uint16_t(bid));
+
+    efd = eventfd(0, EFD_NONBLOCK|EFD_CLOEXEC);
+    if(efd<0 || sysRegister(fd, IORING_REGISTER_EVENTFD, &efd, 1u)) {
+        log_warn_printf(loguring, "io_uring unable to register eventfd (%d)\n", errno);
+        return false;
+    }
+
+    completeEvt = evevent(__FILE__, __LINE__,
+                          event_new(base, efd, EV_READ|EV_PERSIST, &onCompleteS, this));
+    submitEvt = evevent(__FILE__, __LINE__,
+                        event_new(base, -1, 0, &onSubmitS, this));
+    if(event_add(completeEvt.get(), nullptr))
+        return false;
+
+    log_debug_printf(loguring, "io_uring %d with %u SQE and %u CQE\n", fd, p.sq_entries, p.cq_entries);
+    return true;
+}
+
+void Ring::shutdown()
+{
+    if(dead)
+        return;
+
+    {
+        auto self(shared_from_this());
+
+        // cancel all I/O, and wait briefly for the kernel to release our buffers
+        auto todo(conns);
+        for(auto conn : todo) {
+            if(conns.count(conn))
+                conn->close();
+        }
+        submit();
+
+        __kernel_timespec tmo{0, 10000000}; // 10 ms
+        io_uring_getevents_arg arg{};
+        arg.ts = reinterpret_cast<uintptr_t>(&tmo);
+        for(unsigned i=0u; nInflight && i<100u; i++) {
+            (void)sysEnter(fd, 0u, 1u, IORING_ENTER_GETEVENTS|IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+            reap();
+            submit();
+        }
+        if(nInflight)
+            log_warn_printf(loguring, "io_uring %d shutdown with %zu operations in progress\n", fd, nInflight);
+
+        dead = true;
+        completeEvt.reset();
+        submitEvt.reset();
+
+        // no further completions will be processed
+        todo = conns;
+        for(auto conn : todo) {
+            if(conns.count(conn))
+                conn->abandon();
+        }
+    }
+}
+
+bool Ring::space(unsigned n)
+{
+    if(dead)
+        return false;
+    if(sqEntries - (localTail - loadAcquire(sqHead)) < n)
+        submit();
+    return sqEntries - (localTail - loadAcquire(sqHead)) >= n;
+}
+
+io_uring_sqe* Ring::getSQE()
+{
+    if(!space(1u))
+        return nullptr;
+
+    auto idx = localTail & sqMask;
+    auto sqe = &sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    sqArray[idx] = idx;
+    localTail++;
+    nPending++;
+
+    // submit once, after this pass through the event loop
+    if(!submitQueued) {
+        submitQueued = true;
+        event_active(submitEvt.get(), EV_TIMEOUT, 0);
+    }
+    return sqe;
+}
+
+void Ring::submit()
+{
+    if(!nPending || dead)
+        return;
+
+    storeRelease(sqTail, localTail);
+
+    while(nPending) {
+        auto ret = sysEnter(fd, nPending, 0u, 0u);
+        if(ret>0) {
+            nPending -= std::min(unsigned(ret), nPending);
+
+        } else if(ret<0 && errno==EINTR) {
+            // retry
+
+        } else if(ret<0 && (errno==EAGAIN || errno==EBUSY)) {
+            // completion queue backlog.  retry after next completion
+            break;
+
+        } else {
+            log_err_printf(loguring, "io_uring_enter() error %d\n", ret<0 ? errno : 0);
+            break;
+        }
+    }
+}
+
+void Ring::reap()
+{
+    auto self(shared_from_this());
+
+    for(;;) {
+        auto head = *cqHead;
+        if(head==loadAcquire(cqTail))
+            break;
+        auto cqe(cqes[head & cqMask]);
+        storeRelease(cqHead, head+1u);
+
+        if(!cqe.user_data)
+            continue; // cancel or timeout
+
+        auto conn = reinterpret_cast<Conn*>(uintptr_t(cqe.user_data & ~uint64_t(3u)));
+        auto op = Conn::op_t(cqe.user_data & 3u);
+        try {
+            conn->complete(op, cqe.res, cqe.flags);
+        }catch(std::exception& e){
+            log_exc_printf(loguring, "Unhandled error in io_uring completion: %s\n", e.what());
+        }
+    }
+}
+
+void Ring::cancel(uint64_t userData)
+{
+    if(auto sqe = getSQE()) {
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = userData;
+    }
+}
+
+void Ring::recycle(uint16_t bid)
+{
+    // not a struct assignment, as bufs[0].resv is the tail.
+    // Not bufRing->bufs either, which some kernel headers misplace when compiled as C++
+    auto& buf = reinterpret_cast<io_uring_buf*>(bufRing)[bufTail & (nRxBufs-1u)];
+    buf.addr = reinterpret_cast<uintptr_t>(buffer(bid));
+    buf.len = rxBufSize;
+    buf.bid = bid;
+    bufTail++;
+    storeRelease(&bufRing->tail, bufTail);
+}
+
+void Ring::onCompleteS(evutil_socket_t fd, short evt, void *raw)
+{
+    auto self = static_cast<Ring*>(raw);
+    try {
+        LoopTimer T("io_uring");
+        uint64_t count;
+        auto ret = read(fd, &count, sizeof(count));
+        (void)ret;
+        self->reap();
+        self->submit();
+    }catch(std::exception& e){
+        log_exc_printf(loguring, "Unhandled error in io_uring callback: %s\n", e.what());
+    }
+}
+
+void Ring::onSubmitS(evutil_socket_t fd, short evt, void *raw)
+{
+    auto self = static_cast<Ring*>(raw);
+    self->submitQueued = false;
+    self->submit();
+}
+
+Conn::~Conn()
+{
+    ring->conns.erase(this);
+    if(sock!=-1)
+        ::close(sock);
+}
+
+void Conn::attached()
+{
+    // io_uring waits for readiness itself
+    (void)fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) & ~O_NONBLOCK);
+
+    rxLimit = sockBufSize(sock, SO_RCVBUF);
+    // bound data taken from upper.  More is left in upper output, where ConnBase sees it.
+    bufferevent_setwatermark(lower.get(), EV_READ, 0u, sockBufSize(sock, SO_SNDBUF));
+}
+
+void Conn::begin()
+{
+    if(!nInflight++)
+        keep = shared_from_this();
+    ring->nInflight++;
+}
+
+void Conn::complete(op_t op, int res, uint32_t flags)
+{
+    auto self(keep); // may be the last reference
+    ring->nInflight--;
+    if(!--nInflight) {
+        keep.reset();
+        if(closed && sock!=-1) {
+            ::close(sock);
+            sock = -1;
+        }
+    }
+
+    switch(op) {
+    case Recv:
+        receiving = false;
+        if(flags & IORING_CQE_F_BUFFER) {
+            auto bid = uint16_t(flags >> IORING_CQE_BUFFER_SHIFT);
+            if(res>0 && !closed)
+                (void)bufferevent_write(lower.get(), ring->buffer(bid), size_t(res));
+            ring->recycle(bid);
+        }
+        if(closed || failed) {
+        } else if(res>0) {
+            startRecv();
+        } else if(res==0) {
+            rxEOF = true;
+            maybeEOF();
+        } else if(res==-ENOBUFS || res==-EINTR || res==-EAGAIN) {
+            startRecv();
+        } else {
+            fail(BEV_EVENT_ERROR|BEV_EVENT_READING, -res);
+        }
+        break;
+
+    case Send:
+        sending = false;
+        if(closed || failed) {
+        } else if(res>=0) {
+            (void)evbuffer_drain(txInflight.get(), size_t(res));
+            startSend();
+        } else if(res==-EINTR || res==-EAGAIN) {
+            startSend();
+        } else {
+            fail(BEV_EVENT_ERROR|BEV_EVENT_WRITING, -res);
+        }
+        break;
+
+    case Connect:
+        connecting = false;
+        if(closed || failed) {
+        } else if(res==0) {
+            connected = true;
+            startRecv();
+            startSend();
+            bufferevent_trigger_event(upper, BEV_EVENT_CONNECTED, 0);
+        } else if(res==-ECANCELED) { // by link timeout
+            fail(BEV_EVENT_TIMEOUT|BEV_EVENT_WRITING, ETIMEDOUT);
+        } else {
+            fail(BEV_EVENT_ERROR|BEV_EVENT_WRITING, -res);
+        }
+        break;
+    }
+}
+
+void Conn::abandon()
+{
+    // ring shutdown.  Outstanding operations will not complete
+    closed = true;
+    upper = nullptr;
+    connecting = receiving = sending = false;
+    if(nInflight) {
+        ring->nInflight -= nInflight;
+        nInflight = 0u;
+        auto self(std::move(keep));
+    }
+}
+
+void Conn::startRecv()
+{
+    if(receiving || !connected || closed || failed || rxEOF)
+        return;
+
+    if(evbuffer_get_length(bufferevent_get_output(lower.get())) >= rxLimit) {
+        // upper is not keeping up.  cf. onRxDrainS()
+        rxStalled = true;
+        return;
+    }
+    rxStalled = false;
+
+    auto sqe = ring->getSQE();
+    if(!sqe) {
+        fail(BEV_EVENT_ERROR|BEV_EVENT_READING, EBUSY);
+        return;
+    }
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = sock;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = rxGroup;
+    sqe->len = rxBufSize;
+    sqe->user_data = tag(Recv);
+    receiving = true;
+    begin();
+}
+
+void Conn::startSend()
+{
+    if(sending || !connected || closed || failed)
+        return;
+
+    if(!evbuffer_get_length(txInflight.get())) {
+        auto input = bufferevent_get_input(lower.get());
+        if(!evbuffer_get_length(input))
+            return;
+        // move, not copy.  Chains are not modified while the kernel reads them.
+        (void)evbuffer_add_buffer(txInflight.get(), input);
+    }
+
+    auto sqe = ring->getSQE();
+    if(!sqe) {
+        fail(BEV_EVENT_ERROR|BEV_EVENT_WRITING, EBUSY);
+        return;
+    }
+    auto niov = evbuffer_peek(txInflight.get(), -1, nullptr, txIOV, maxIOV);
+    txMsg.msg_iov = txIOV;
+    txMsg.msg_iovlen = size_t(std::min(niov, maxIOV));
+
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = sock;
+    sqe->addr = reinterpret_cast<uintptr_t>(&txMsg);
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = tag(Send);
+    sending = true;
+    begin();
+}
+
+void Conn::maybeEOF()
+{
+    // only after upper has taken everything received
+    if(rxEOF && upper && !failed && !evbuffer_get_length(bufferevent_get_output(lower.get()))) {
+        failed = true;
+        bufferevent_trigger_event(upper, BEV_EVENT_EOF|BEV_EVENT_READING, 0);
+    }
+}
+
+void Conn::fail(short what, int err)
+{
+    if(failed || !upper)
+        return;
+    failed = true;
+    log_debug_printf(loguring, "io_uring socket %d error %d\n", sock, err);
+    // saved with a deferred callback, and restored before it runs
+    EVUTIL_SET_SOCKET_ERROR(err);
+    bufferevent_trigger_event(upper, what, 0);
+}
+
+int Conn::connect(const sockaddr* addr, socklen_t alen, const timeval& timeout)
+{
+    if(sock!=-1 || closed || alen > socklen_t(sizeof(peer)))
+        return -1;
+    if(!ring->space(2u)) // connect, and linked timeout
+        return -1;
+
+    sock = socket(addr->sa_family, SOCK_STREAM|SOCK_CLOEXEC, 0);
+    if(sock<0)
+        return -1;
+    attached();
+
+    memcpy(&peer, addr, alen);
+    connTimeout.tv_sec = timeout.tv_sec;
+    connTimeout.tv_nsec = timeout.tv_usec*1000;
+
+    auto sqe = ring->getSQE();
+    sqe->opcode = IORING_OP_CONNECT;
+    sqe->fd = sock;
+    sqe->addr = reinterpret_cast<uintptr_t>(&peer);
+    sqe->off = alen;
+    sqe->flags = IOSQE_IO_LINK;
+    sqe->user_data = tag(Connect);
+
+    auto tmo = ring->getSQE();
+    tmo->opcode = IORING_OP_LINK_TIMEOUT;
+    tmo->fd = -1;
+    tmo->addr = reinterpret_cast<uintptr_t>(&connTimeout);
+    tmo->len = 1u;
+
+    connecting = true;
+    begin();
+    return 0;
+}
+
+void Conn::close()
+{
+    if(closed)
+        return;
+    closed = true;
+    upper = nullptr;
+
+    if(sock!=-1 && nInflight) {
+        // wakes any RECV or SENDMSG
+        (void)::shutdown(sock, SHUT_RDWR);
+        if(connecting)
+            ring->cancel(tag(Connect));
+        if(receiving)
+            ring->cancel(tag(Recv));
+        if(sending)
+            ring->cancel(tag(Send));
+    } else if(sock!=-1) {
+        ::close(sock);
+        sock = -1;
+    }
+}
+
+void Conn::onTxS(bufferevent *bev, void *raw)
+{
+    auto self = static_cast<Conn*>(raw);
+    try {
+        self->startSend();
+    }catch(std::exception& e){
+        log_exc_printf(loguring, "Unhandled error in io_uring send: %s\n", e.what());
+    }
+}
+
+void Conn::onRxDrainS(evbuffer *buf, const evbuffer_cb_info *info, void *raw)
+{
+    auto self = static_cast<Conn*>(raw);
+    if(!info->n_deleted)
+        return;
+    if(self->rxStalled && evbuffer_get_length(buf) < self->rxLimit)
+        self->startRecv();
+    self->maybeEOF();
+}
+
+} // namespace
+
+std::shared_ptr<IOURing> IOURing::create(event_base* base)
+{
+    auto ring(std::make_shared<Ring>(base));
+    if(!ring->init())
+        ring.reset();
+    return ring;
+}
+
+std::shared_ptr<UringConn> UringConn::create(const std::shared_ptr<IOURing>& ring,
+                                             evutil_socket_t sock,
+                                             evbufferevent& bev)
+{
+    auto R(std::dynamic_pointer_cast<Ring>(ring));
+    if(!R) {
+        if(sock!=-1)
+            ::close(sock);
+        throw std::logic_error("Not an io_uring");
+    }
+
+    bufferevent* pair[2]{};
+    if(bufferevent_pair_new(R->base, BEV_OPT_DEFER_CALLBACKS, pair)) {
+        if(sock!=-1)
+            ::close(sock);
+        throw BAD_ALLOC();
+    }
+    // caller owns upper
+    bev = evbufferevent(__FILE__, __LINE__, pair[0]);
+
+    auto conn(std::make_shared<Conn>(R, pair[1], pair[0]));
+
+    bufferevent_setcb(pair[1], &Conn::onTxS, nullptr, nullptr, conn.get());
+    if(!evbuffer_add_cb(bufferevent_get_output(pair[1]), &Conn::onRxDrainS, conn.get()))
+        throw BAD_ALLOC();
+    (void)bufferevent_enable(pair[1], EV_READ|EV_WRITE);
+
+    if(sock!=-1) {
+        conn->sock = sock;
+        conn->attached();
+        conn->connected = true;
+        conn->startRecv();
+    }
+    return conn;
+}
+
+#else // HAVE_IO_URING
+
+std::shared_ptr<IOURing> IOURing::create(event_base* base)
+{
+    log_warn_printf(loguring, "io_uring not supported by this build\n%s", "");
+    return nullptr;
+}
+
+std::shared_ptr<UringConn> UringConn::create(const std::shared_ptr<IOURing>& ring,
+                                             evutil_socket_t sock,
+                                             evbufferevent& bev)
+{
+    throw std::logic_error("io_uring not supported");
+}
+
+#endif // HAVE_IO_URING
+
+}} // namespace pvxs::impl
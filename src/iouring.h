@@ -0,0 +1,58 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+#ifndef IOURING_H
+#define IOURING_H
+
+#include <memory>
+
+#include "evhelper.h"
+
+namespace pvxs {
+namespace impl {
+
+/* Optional io_uring backend for TCP connections (Linux >= 5.19).
+ * Selected with $PVXS_EVENT_BACKEND=io_uring.  Falls back to libevent if not supported.
+ *
+ * Each evbase worker creates its ring on first use.  cf. evbase::uring()
+ *   - Completions are signaled through an eventfd watched by the worker's event_base.
+ *   - Submissions queued during one pass of the event loop are made together,
+ *     with a single io_uring_enter().
+ *   - Receives select from a ring of provided buffers shared by all connections of the worker.
+ *   - Sends gather all queued output with one SENDMSG.
+ *
+ * Framing and handlers (ConnBase) still see a bufferevent.  cf. ConnBev
+ * This is one end of a bufferevent pair.  A UringConn owns the socket,
+ * and moves data between it and the other end of the pair.
+ */
+struct PVXS_API IOURing {
+    //! Create the ring of an evbase worker.  Returns nullptr if not supported.
+    static std::shared_ptr<IOURing> create(event_base* base);
+    virtual ~IOURing();
+    //! Cancel all I/O.  Called by the worker before freeing its event_base.
+    virtual void shutdown() =0;
+};
+
+struct PVXS_API UringConn {
+    /** New connection on an accepted socket, or with sock==-1 to connect() later.
+     *  Takes ownership of sock.  Stores the end of the pair to be used by ConnBase in bev.
+     */
+    static std::shared_ptr<UringConn> create(const std::shared_ptr<IOURing>& ring,
+                                             evutil_socket_t sock,
+                                             evbufferevent& bev);
+    virtual ~UringConn();
+    //! Socket.  -1 before connect()
+    virtual evutil_socket_t fd() const =0;
+    /** As bufferevent_socket_connect().  Completion is signaled with BEV_EVENT_CONNECTED,
+     *  or an error, or BEV_EVENT_TIMEOUT after timeout.
+     */
+    virtual int connect(const sockaddr* addr, socklen_t alen, const timeval& timeout) =0;
+    //! Stop I/O and close the socket.  Call after freeing the bufferevent.
+    virtual void close() =0;
+};
+
+}} // namespace pvxs::impl
+
+#endif // IOURING_H
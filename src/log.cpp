@@ -7,6 +7,10 @@
 #include <map>
 #include <string>
 #include <list>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <algorithm>
 
 #include <assert.h>
 #include <stdlib.h>
@@ -25,6 +29,7 @@
 #include <epicsStdio.h>
 #include <epicsThread.h>
 #include <epicsMutex.h>
+#include <epicsEvent.h>
 #include <epicsGuard.h>
 #include <epicsTime.h>
 
@@ -50,6 +55,195 @@ namespace pvxs {
 
 DEFINE_LOGGER(logerr, "pvxs.ev");
 
+namespace {
+
+// Format (at most 64 bytes) as hex lines.  Calls out(line) for each.
+template<typename F>
+void hexLines(const void *buf, size_t buflen, F&& out)
+{
+    const auto cbuf = static_cast<const uint8_t*>(buf);
+    bool ellipsis = buflen > 64u;
+    if(ellipsis)
+        buflen = 64u;
+
+    // whole buffer
+    for(size_t pos=0; pos<buflen;)
+    {
+        // printed line (4 groups of 4 bytes)
+        // addr : AAAAAAAA BBBBBBBB CCCCCCCC DDDDDDDD
+        char buf[4][9] = {"","","",""};
+        const auto addr = unsigned(pos);
+
+        for(unsigned grp=0; grp<4 && pos<buflen ; grp++)
+        {
+            // group of 4 hex chars
+            unsigned chr=0;
+            for(; chr<8 && pos<buflen; pos++, chr+=2)
+            {
+                static const char hex[17]="0123456789ABCDEF";
+                uint8_t v = cbuf[pos];
+                buf[grp][chr+0] = hex[(v>>4)&0xf];
+                buf[grp][chr+1] = hex[(v>>0)&0xf];
+            }
+            for(; chr<8; chr+=2)
+            {
+                buf[grp][chr+0] = '\0';
+                buf[grp][chr+1] = '\0';
+            }
+            buf[grp][8] = '\0';
+        }
+
+        char line[64];
+        epicsSnprintf(line, sizeof(line), "%04x : %s %s %s %s\n", addr, buf[0], buf[1], buf[2], buf[3]);
+        out(line);
+    }
+    if(ellipsis)
+        out("...\n");
+}
+
+/* Asynchronous logging, enabled by $PVXS_LOG_ASYNC=YES
+ *
+ * Each thread formats messages into its own single producer, single consumer,
+ * ring buffer of fixed size slots.  So the logging thread never waits on
+ * errlog, or on any other thread.  A background thread moves messages to errlog.
+ */
+struct LogRing {
+    static constexpr size_t nslots = 64u;
+    static constexpr size_t slotsize = 512u;
+    // incremented only by producer
+    std::atomic<size_t> head{0u};
+    // incremented only by consumer
+    std::atomic<size_t> tail{0u};
+    // messages discarded while full
+    std::atomic<uint64_t> dropped{0u};
+    // owning thread has exited
+    std::atomic<bool> orphan{false};
+    char slots[nslots][slotsize];
+};
+
+struct LogRingHolder {
+    std::shared_ptr<LogRing> ring;
+    ~LogRingHolder() {
+        if(ring)
+            ring->orphan.store(true, std::memory_order_release);
+    }
+};
+
+// cf. logAsyncSnapshot().  Only incremented by the AsyncLog worker
+std::atomic<uint64_t> asyncWritten{0u}, asyncDropped{0u};
+
+struct AsyncLog final : public epicsThreadRunable {
+    epicsMutex lock;
+    // guarded by lock
+    std::vector<std::shared_ptr<LogRing>> rings;
+
+    epicsEvent wakeup;
+    std::atomic<bool> running{true};
+
+    epicsThread worker;
+
+    AsyncLog()
+        :worker(*this, "PVXLOG",
+                epicsThreadGetStackSize(epicsThreadStackSmall),
+                epicsThreadPriorityLow)
+    {
+        worker.start();
+    }
+    virtual ~AsyncLog() {} // never destroyed.  cf. logger_shutdown()
+
+    // join worker, after moving any remaining messages to errlog
+    void stop() {
+        running.store(false);
+        wakeup.signal();
+        worker.exitWait();
+    }
+
+    LogRing* mine() {
+        thread_local LogRingHolder holder;
+        if(!holder.ring) {
+            holder.ring = std::make_shared<LogRing>();
+            Guard G(lock);
+            rings.push_back(holder.ring);
+        }
+        return holder.ring.get();
+    }
+
+    void push(const void *buf, size_t buflen, const char *fmt, va_list args) {
+        auto ring = mine();
+        auto head = ring->head.load(std::memory_order_relaxed);
+        auto used = head - ring->tail.load(std::memory_order_acquire);
+        if(used >= LogRing::nslots) {
+            ring->dropped.fetch_add(1u, std::memory_order_relaxed);
+            return;
+        }
+
+        auto slot = ring->slots[head % LogRing::nslots];
+        size_t N = 0u;
+        if(buf) {
+            hexLines(buf, buflen, [slot, &N](const char *line) {
+                auto L = strlen(line);
+                memcpy(slot+N, line, L); // hex output is much shorter than slotsize
+                N += L;
+            });
+        }
+        int ret = epicsVsnprintf(slot+N, LogRing::slotsize-N, fmt, args);
+        if(ret<0 || size_t(ret) >= LogRing::slotsize-N) {
+            // truncated
+            strcpy(slot + LogRing::slotsize - 5u, "...\n");
+        }
+
+        ring->head.store(head+1u, std::memory_order_release);
+
+        // avoid the cost of a wakeup until a backlog builds
+        if(used+1u >= LogRing::nslots/2u)
+            wakeup.signal();
+    }
+
+    void drain() {
+        decltype (rings) todo;
+        {
+            Guard G(lock);
+            todo = rings;
+        }
+
+        for(auto& ring : todo) {
+            auto tail = ring->tail.load(std::memory_order_relaxed);
+            auto head = ring->head.load(std::memory_order_acquire);
+            for(; tail!=head; tail++) {
+                errlogPrintf("%s", ring->slots[tail % LogRing::nslots]);
+                ring->tail.store(tail+1u, std::memory_order_release);
+                asyncWritten.fetch_add(1u, std::memory_order_relaxed);
+            }
+
+            if(auto ndrop = ring->dropped.exchange(0u, std::memory_order_relaxed)) {
+                auto total = asyncDropped.fetch_add(ndrop, std::memory_order_relaxed) + ndrop;
+                errlogPrintf("pvxs.log dropped %llu messages (%llu total)\n",
+                             (unsigned long long)ndrop, (unsigned long long)total);
+            }
+        }
+
+        // forget empty rings of exited threads
+        Guard G(lock);
+        rings.erase(std::remove_if(rings.begin(), rings.end(), [](const std::shared_ptr<LogRing>& ring) {
+                        return ring->orphan.load(std::memory_order_acquire)
+                                && ring->head.load(std::memory_order_acquire)==ring->tail.load(std::memory_order_relaxed);
+                    }), rings.end());
+    }
+
+    virtual void run() override final {
+        while(running.load()) {
+            wakeup.wait(0.05);
+            drain();
+        }
+        drain();
+    }
+};
+
+// Loaded without a lock by any thread which logs.  So never free'd.
+std::atomic<AsyncLog*> asyncLog{nullptr};
+
+} // namespace
+
 namespace detail {
 
 static
@@ -98,6 +292,12 @@ const char* log_prep(logger& log, unsigned rawlvl)
 static
 void _log_vprintf(unsigned rawlvl, const char *fmt, va_list args)
 {
+    auto alog = asyncLog.load(std::memory_order_acquire);
+    if(alog && Level(rawlvl&0xff)!=Level::Crit && !(rawlvl&0x1000)) {
+        alog->push(nullptr, 0u, fmt, args);
+        return;
+    }
+
     errlogVprintf(fmt, args);
 
     if(Level(rawlvl&0xff)==Level::Crit && abortOnCrit!=0) {
@@ -131,8 +331,14 @@ void _log_printf_hex(unsigned rawlvl, const void *buf, size_t buflen, const char
 {
     va_list args;
     va_start(args, fmt);
-    xerrlogHexPrintf(buf, buflen);
-    _log_vprintf(rawlvl, fmt, args);
+    auto alog = asyncLog.load(std::memory_order_acquire);
+    if(alog && Level(rawlvl&0xff)!=Level::Crit && !(rawlvl&0x1000)) {
+        // keep hex dump together with message
+        alog->push(buf, buflen, fmt, args);
+    } else {
+        xerrlogHexPrintf(buf, buflen);
+        _log_vprintf(rawlvl, fmt, args);
+    }
     va_end(args);
 }
 
@@ -258,6 +464,12 @@ void logger_prepare()
             detail::abortOnCrit = 2;
         }
     }
+
+    if(auto env = getenv("PVXS_LOG_ASYNC")) {
+        if(epicsStrCaseCmp(env, "YES")==0 || strcmp(env, "1")==0) {
+            asyncLog.store(new AsyncLog, std::memory_order_release);
+        }
+    }
 }
 
 } // namespace
@@ -284,42 +496,9 @@ Level logger::init()
 
 void xerrlogHexPrintf(const void *buf, size_t buflen)
 {
-    const auto cbuf = static_cast<const uint8_t*>(buf);
-    bool ellipsis = buflen > 64u;
-    if(ellipsis)
-        buflen = 64u;
-
-    // whole buffer
-    for(size_t pos=0; pos<buflen;)
-    {
-        // printed line (4 groups of 4 bytes)
-        // addr : AAAAAAAA BBBBBBBB CCCCCCCC DDDDDDDD
-        char buf[4][9] = {"","","",""};
-        const auto addr = unsigned(pos);
-
-        for(unsigned grp=0; grp<4 && pos<buflen ; grp++)
-        {
-            // group of 4 hex chars
-            unsigned chr=0;
-            for(; chr<8 && pos<buflen; pos++, chr+=2)
-            {
-                static const char hex[17]="0123456789ABCDEF";
-                uint8_t v = cbuf[pos];
-                buf[grp][chr+0] = hex[(v>>4)&0xf];
-                buf[grp][chr+1] = hex[(v>>0)&0xf];
-            }
-            for(; chr<8; chr+=2)
-            {
-                buf[grp][chr+0] = '\0';
-                buf[grp][chr+1] = '\0';
-            }
-            buf[grp][8] = '\0';
-        }
-
-        errlogPrintf("%04x : %s %s %s %s\n", addr, buf[0], buf[1], buf[2], buf[3]);
-    }
-    if(ellipsis)
-        errlogPrintf("...\n");
+    hexLines(buf, buflen, [](const char *line) {
+        errlogPrintf("%s", line);
+    });
 }
 
 void logger_level_set(const char *name, int lvl)
@@ -393,10 +572,23 @@ void logger_config_env()
 
 namespace pvxs {namespace impl {
 
+LogAsyncStats logAsyncSnapshot()
+{
+    LogAsyncStats ret;
+    ret.written = asyncWritten.load(std::memory_order_relaxed);
+    ret.dropped = asyncDropped.load(std::memory_order_relaxed);
+    return ret;
+}
+
 void logger_shutdown()
 {
     threadOnce<&logger_prepare>();
 
+    // Later messages go directly to errlog.  Other threads may still be
+    // in push(), so the AsyncLog is stopped, but not free'd.
+    if(auto alog = asyncLog.exchange(nullptr, std::memory_order_acq_rel))
+        alog->stop();
+
     errlogFlush();
 
     delete logger_gbl;
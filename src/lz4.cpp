@@ -0,0 +1,304 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <string.h>
+
+#include <epicsThread.h>
+
+#include "lz4.h"
+
+namespace pvxs {
+namespace impl {
+
+namespace {
+
+constexpr size_t minMatch = 4u;
+constexpr size_t maxOffset = 65535u;
+// last match must start at least this many bytes before the end of block
+constexpr size_t mfLimit = 12u;
+// last bytes of a block are always literals
+constexpr size_t lastLiterals = 5u;
+constexpr unsigned hashBits = 14u;
+
+// Smaller chunks are not worth a thread.
+constexpr size_t minChunk = 256u*1024u;
+// Keep positions within a chunk representable in the uint32_t hash table
+constexpr size_t maxChunk = size_t(1u)<<30u;
+
+inline
+uint32_t read32(const uint8_t* p)
+{
+    uint32_t v;
+    memcpy(&v, p, 4u);
+    return v;
+}
+
+inline
+uint32_t hash4(const uint8_t* p)
+{
+    return (read32(p)*2654435761u)>>(32u-hashBits);
+}
+
+inline
+uint8_t* putLen(uint8_t* op, size_t v)
+{
+    for(; v>=255u; v-=255u)
+        *op++ = 255u;
+    *op++ = uint8_t(v);
+    return op;
+}
+
+// token, literal count, and literals.  Match nibble supplied by caller
+inline
+uint8_t* putLits(uint8_t* op, const uint8_t* lit, size_t nlit, uint8_t mcode)
+{
+    *op++ = uint8_t((std::min(nlit, size_t(15u))<<4u) | mcode);
+    if(nlit>=15u)
+        op = putLen(op, nlit-15u);
+    if(nlit)
+        memcpy(op, lit, nlit);
+    return op + nlit;
+}
+
+inline
+uint8_t* putSeq(uint8_t* op, const uint8_t* lit, size_t nlit, size_t offset, size_t mlen)
+{
+    const size_t mcode = mlen-minMatch;
+    op = putLits(op, lit, nlit, uint8_t(std::min(mcode, size_t(15u))));
+    *op++ = uint8_t(offset);
+    *op++ = uint8_t(offset>>8u);
+    if(mcode>=15u)
+        op = putLen(op, mcode-15u);
+    return op;
+}
+
+/* Emit sequences for matches found in base[begin, end).
+ * The final literals, base[anchor, end), are left to the caller.
+ */
+size_t encodeChunk(uint8_t* out, const uint8_t* base, size_t begin, size_t end,
+                   size_t& anchor, uint32_t* table)
+{
+    anchor = begin;
+    if(end-begin <= mfLimit)
+        return 0u;
+
+    // table entries are chunk position+1.  Zero for empty.
+    std::fill_n(table, size_t(1u)<<hashBits, 0u);
+
+    const size_t mflimit = end - mfLimit;
+    const size_t matchlimit = end - lastLiterals;
+    uint8_t* op = out;
+
+    size_t ip = begin;
+    while(ip <= mflimit) {
+        auto& ent = table[hash4(base+ip)];
+        const size_t cand = begin + ent - 1u;
+        const bool valid = ent && ip-cand <= maxOffset;
+        ent = uint32_t(ip - begin + 1u);
+
+        if(valid && read32(base+cand)==read32(base+ip)) {
+            size_t len = minMatch;
+            while(ip+len < matchlimit && base[cand+len]==base[ip+len])
+                len++;
+
+            op = putSeq(op, base+anchor, ip-anchor, ip-cand, len);
+            ip += len;
+            anchor = ip;
+
+        } else {
+            // step faster through incompressible regions
+            ip += 1u + ((ip-anchor)>>6u);
+        }
+    }
+
+    return op-out;
+}
+
+struct Chunk {
+    size_t begin, end;
+    size_t anchor = 0u;
+    size_t nout = 0u;
+    uint8_t* out = nullptr;
+    std::vector<uint8_t> scratch;
+};
+
+struct Pool {
+    const uint8_t* const in;
+    std::vector<Chunk>& chunks;
+    std::atomic<size_t> next{0u};
+
+    Pool(const uint8_t* in, std::vector<Chunk>& chunks) :in(in), chunks(chunks) {}
+
+    void work(uint32_t* table) {
+        for(auto i = next++; i < chunks.size(); i = next++) {
+            auto& C = chunks[i];
+            C.nout = encodeChunk(C.out, in, C.begin, C.end, C.anchor, table);
+        }
+    }
+};
+
+struct Worker final : public epicsThreadRunable {
+    Pool& pool;
+    std::vector<uint32_t> table;
+    epicsThread thr;
+
+    explicit Worker(Pool& pool)
+        :pool(pool)
+        ,table(size_t(1u)<<hashBits)
+        ,thr(*this, "PVXLZ4",
+             epicsThreadGetStackSize(epicsThreadStackSmall),
+             epicsThreadGetPrioritySelf())
+    {
+        thr.start();
+    }
+    virtual ~Worker() {
+        thr.exitWait();
+    }
+
+    virtual void run() override final {
+        pool.work(table.data());
+    }
+};
+
+} // namespace
+
+size_t lz4Compress(uint8_t* out, const uint8_t* in, size_t nin, unsigned nthreads)
+{
+    if(!nthreads)
+        nthreads = std::max(1, epicsThreadGetCPUs());
+
+    size_t chunkSize = std::max(minChunk, (nin + nthreads - 1u)/nthreads);
+    chunkSize = std::min(chunkSize, maxChunk);
+    const size_t nchunk = std::max(size_t(1u), (nin + chunkSize - 1u)/chunkSize);
+
+    std::vector<Chunk> chunks(nchunk);
+    for(size_t i=0u; i<nchunk; i++) {
+        auto& C = chunks[i];
+        C.begin = i*chunkSize;
+        C.end = std::min(nin, C.begin + chunkSize);
+        if(i==0u) {
+            // first chunk needs no splice, so written in place
+            C.out = out;
+        } else {
+            C.scratch.resize(lz4Bound(C.end - C.begin));
+            C.out = C.scratch.data();
+        }
+    }
+
+    std::vector<uint32_t> table(size_t(1u)<<hashBits);
+    Pool pool(in, chunks);
+    {
+        std::vector<std::unique_ptr<Worker>> workers;
+        for(size_t i=1u; i<std::min(size_t(nthreads), nchunk); i++)
+            workers.emplace_back(new Worker(pool));
+
+        pool.work(table.data());
+    } // join
+
+    uint8_t* op = out + chunks[0].nout;
+    size_t pending = chunks[0].anchor;
+
+    for(size_t i=1u; i<nchunk; i++) {
+        auto& C = chunks[i];
+        if(!C.nout)
+            continue; // no matches.  All literals, so pending remains
+
+        // re-write first sequence to prepend the pending literals of previous chunks
+        const uint8_t* cp = C.out;
+        const uint8_t token = *cp++;
+        size_t nlit = token>>4u;
+        if(nlit==15u) {
+            uint8_t b;
+            do {
+                b = *cp++;
+                nlit += b;
+            } while(b==255u);
+        }
+        cp += nlit;
+
+        op = putLits(op, in+pending, C.begin + nlit - pending, token&0xfu);
+
+        const size_t rest = C.nout - (cp - C.out);
+        memcpy(op, cp, rest); // non-empty, includes at least an offset
+        op += rest;
+
+        pending = C.anchor;
+    }
+
+    op = putLits(op, in+pending, nin-pending, 0u);
+
+    return op-out;
+}
+
+void lz4Decompress(uint8_t* out, size_t nout, const uint8_t* in, size_t nin)
+{
+    auto getLen = [in, nin](size_t& ip) -> size_t {
+        size_t ret = 0u;
+        uint8_t b;
+        do {
+            if(ip>=nin)
+                throw std::runtime_error("Truncated LZ4 length");
+            b = in[ip++];
+            ret += b;
+        } while(b==255u);
+        return ret;
+    };
+
+    size_t ip = 0u, op = 0u;
+    while(true) {
+        if(ip>=nin)
+            throw std::runtime_error("Truncated LZ4 block");
+        const auto token = in[ip++];
+
+        size_t nlit = token>>4u;
+        if(nlit==15u)
+            nlit += getLen(ip);
+        if(nlit > nin-ip || nlit > nout-op)
+            throw std::runtime_error("LZ4 literal overflow");
+        if(nlit)
+            memcpy(out+op, in+ip, nlit);
+        ip += nlit;
+        op += nlit;
+
+        if(ip==nin)
+            break; // final literals
+
+        if(nin-ip < 2u)
+            throw std::runtime_error("Truncated LZ4 offset");
+        const size_t offset = in[ip] | size_t(in[ip+1u])<<8u;
+        ip += 2u;
+
+        size_t mlen = token&0xfu;
+        if(mlen==15u)
+            mlen += getLen(ip);
+        mlen += minMatch;
+
+        if(offset==0u || offset > op)
+            throw std::runtime_error("Invalid LZ4 match offset");
+        if(mlen > nout-op)
+            throw std::runtime_error("LZ4 match overflow");
+
+        if(offset >= mlen) {
+            memcpy(out+op, out+op-offset, mlen);
+        } else {
+            // overlapping repeat
+            for(size_t i=0u; i<mlen; i++)
+                out[op+i] = out[op-offset+i];
+        }
+        op += mlen;
+    }
+
+    if(op!=nout)
+        throw std::runtime_error("LZ4 length mismatch");
+}
+
+}} // namespace pvxs::impl
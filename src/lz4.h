@@ -0,0 +1,47 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+#ifndef LZ4_H
+#define LZ4_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <pvxs/version.h>
+
+namespace pvxs {
+namespace impl {
+
+/* LZ4 block format, as used by areaDetector for NTNDArray codec.name="lz4".
+ *   https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+ *
+ * Large inputs are divided into chunks which are compressed in parallel.
+ * Matches do not cross chunk boundaries.  The trailing literals of each
+ * chunk are merged into the first sequence of the next, so the result
+ * is a single standard block which any LZ4 decoder accepts.
+ */
+
+//! Upper limit on compressed size of n bytes
+constexpr size_t lz4Bound(size_t n) { return n + n/255u + 16u; }
+
+/** Compress nin bytes into out, which must have room for lz4Bound(nin) bytes.
+ *
+ * @param nthreads Upper limit on the number of threads used, including the caller.
+ *                 Zero to use the number of CPUs.
+ * @returns Number of bytes written to out.
+ */
+PVXS_API
+size_t lz4Compress(uint8_t* out, const uint8_t* in, size_t nin, unsigned nthreads);
+
+/** Expand nin bytes, which must decode to exactly nout bytes.
+ *
+ * @throws std::runtime_error if the input is not valid.
+ */
+PVXS_API
+void lz4Decompress(uint8_t* out, size_t nout, const uint8_t* in, size_t nin);
+
+}} // namespace pvxs::impl
+
+#endif // LZ4_H
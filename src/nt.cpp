@@ -6,6 +6,7 @@
 
 #include <pvxs/nt.h>
 #include "utilpvt.h"
+#include "lz4.h"
 
 namespace pvxs {
 namespace nt {
@@ -215,8 +216,8 @@ TypeDef NTNDArray::build() const
                         UInt16A("ushortValue"),
                         UInt32A("uintValue"),
                         UInt64A("ulongValue"),
-                        Float32("floatValue"),
-                        Float64("doubleValue"),
+                        Float32A("floatValue"),
+                        Float64A("doubleValue"),
                     }),
                     Struct("codec", "codec_t", {
                         String("name"),
@@ -250,6 +251,105 @@ TypeDef NTNDArray::build() const
     return def;
 }
 
+namespace {
+// areaDetector NDDataType_t, as stored in codec.parameters
+const struct {
+    int32_t ndtype;
+    ArrayType type;
+    const char *member;
+} ndTypes[] = {
+    {0, ArrayType::Int8,    "byteValue"},
+    {1, ArrayType::UInt8,   "ubyteValue"},
+    {2, ArrayType::Int16,   "shortValue"},
+    {3, ArrayType::UInt16,  "ushortValue"},
+    {4, ArrayType::Int32,   "intValue"},
+    {5, ArrayType::UInt32,  "uintValue"},
+    {6, ArrayType::Int64,   "longValue"},
+    {7, ArrayType::UInt64,  "ulongValue"},
+    {8, ArrayType::Float32, "floatValue"},
+    {9, ArrayType::Float64, "doubleValue"},
+};
+} // namespace
+
+void NTNDArray::compress(Value& img, const std::string& codec, unsigned nthreads)
+{
+    if(codec!="lz4")
+        throw std::logic_error(SB()<<"Unsupported NTNDArray codec \""<<escape(codec)<<"\"");
+
+    auto prev(img["codec.name"].as<std::string>());
+    if(!prev.empty())
+        throw std::logic_error(SB()<<"NTNDArray value already compressed with \""<<escape(prev)<<"\"");
+
+    auto raw(img["value"].as<shared_array<const void>>());
+
+    int32_t ndtype = -1;
+    for(auto& T : ndTypes) {
+        if(T.type==raw.original_type()) {
+            ndtype = T.ndtype;
+            break;
+        }
+    }
+    if(ndtype<0)
+        throw std::logic_error(SB()<<"NTNDArray can not compress value of "<<raw.original_type());
+
+    const size_t nbytes = raw.size()*elementSize(raw.original_type());
+
+    shared_array<uint8_t> buf(impl::lz4Bound(nbytes));
+    const size_t ncomp = impl::lz4Compress(buf.data(),
+                                           static_cast<const uint8_t*>(raw.data()),
+                                           nbytes, nthreads);
+
+    shared_array<const uint8_t> comp;
+    if(ncomp + ncomp/4u < buf.size()) {
+        // don't hold on to a mostly unused allocation
+        comp = shared_array<const uint8_t>(buf.begin(), buf.begin()+ncomp);
+    } else {
+        comp = shared_array<const uint8_t>(buf.dataPtr(), buf.data(), ncomp);
+    }
+
+    img["value->ubyteValue"] = comp;
+    img["codec.name"] = codec;
+    // areaDetector expects exactly int32
+    auto param(TypeDef(TypeCode::Int32).create());
+    param = ndtype;
+    img["codec.parameters"].from(param);
+    img["compressedSize"] = int64_t(ncomp);
+    img["uncompressedSize"] = int64_t(nbytes);
+}
+
+void NTNDArray::decompress(Value& img)
+{
+    auto codec(img["codec.name"].as<std::string>());
+    if(codec.empty())
+        return;
+    else if(codec!="lz4")
+        throw std::runtime_error(SB()<<"Unsupported NTNDArray codec \""<<escape(codec)<<"\"");
+
+    auto comp(img["value"].as<shared_array<const uint8_t>>());
+    auto ndtype(img["codec.parameters"].as<int32_t>());
+    auto nbytes(img["uncompressedSize"].as<uint64_t>());
+
+    for(auto& T : ndTypes) {
+        if(T.ndtype!=ndtype)
+            continue;
+
+        const auto esize = elementSize(T.type);
+        // LZ4 can not expand by more than 255x.  Don't trust uncompressedSize for allocation.
+        if(nbytes%esize || nbytes > uint64_t(comp.size())*255u)
+            throw std::runtime_error(SB()<<"NTNDArray invalid uncompressedSize "<<nbytes);
+
+        auto raw(allocArray(T.type, nbytes/esize));
+        impl::lz4Decompress(static_cast<uint8_t*>(raw.data()), nbytes, comp.data(), comp.size());
+
+        img[SB()<<"value->"<<T.member] = raw.freeze();
+        img["codec.name"] = "";
+        img["compressedSize"] = int64_t(nbytes);
+        return;
+    }
+
+    throw std::runtime_error(SB()<<"NTNDArray unsupported codec.parameters "<<ndtype);
+}
+
 NTURI::NTURI(std::initializer_list<Member> args)
 {
     using namespace pvxs::members;
@@ -51,12 +51,12 @@ namespace impl {
 
 #if defined(USE_UNIX_GROUPS)
 
-void osdGetRoles(const std::string& account, std::set<std::string>& roles)
+bool osdGetRoles(const std::string& account, std::set<std::string>& roles)
 {
     passwd *user = getpwnam(account.c_str());
     if(!user) {
         roles.insert(account);
-        return; // don't know who this is
+        return false; // don't know who this is
     }
 
     typedef std::set<gid_t> gids_t;
@@ -122,11 +122,31 @@ void osdGetRoles(const std::string& account, std::set<std::string>& roles)
         if(group* gr = getgrgid(gid))
             roles.insert(gr->gr_name);
     }
+    return true;
+}
+
+bool osdGetAccount(int64_t uid, std::string& account)
+{
+    passwd pw, *user = nullptr;
+    std::vector<char> buf(1024u);
+
+    while(true) {
+        int err = getpwuid_r(uid_t(uid), &pw, &buf[0], buf.size(), &user);
+        if(err==ERANGE && buf.size() < 1024u*1024u) {
+            buf.resize(buf.size()*2u);
+            continue;
+        }
+        break;
+    }
+    if(!user)
+        return false;
+    account = user->pw_name;
+    return true;
 }
 
 #elif defined(USE_LANMAN)
 
-void osdGetRoles(const std::string& account, std::set<std::string>& roles)
+bool osdGetRoles(const std::string& account, std::set<std::string>& roles)
 {
     NET_API_STATUS sts;
     LPLOCALGROUP_USERS_INFO_0 pinfo = NULL;
@@ -136,7 +156,7 @@ void osdGetRoles(const std::string& account, std::set<std::string>& roles)
     {
         size_t N = mbstowcs(NULL, account.c_str(), 0);
         if(N==size_t(-1))
-            return; // username has invalid MB char
+            return false; // username has invalid MB char
         wbuf.resize(N+1);
         N = mbstowcs(&wbuf[0], account.c_str(), account.size());
         assert(N+1==wbuf.size());
@@ -178,16 +198,32 @@ void osdGetRoles(const std::string& account, std::set<std::string>& roles)
 
     if(roles.empty())
         roles.insert(account);
+    return sts==NERR_Success;
+}
+
+bool osdGetAccount(int64_t uid, std::string& account)
+{
+    (void)uid;
+    (void)account;
+    return false; // no local socket peer credentials
 }
 
 #else
 
-void osdGetRoles(const std::string& account, std::set<std::string>& roles)
+bool osdGetRoles(const std::string& account, std::set<std::string>& roles)
 {
     /* Group list not available (RTEMS, vxWorks)
      * Report the remote account as the only role.
      */
     roles.insert(account);
+    return true;
+}
+
+bool osdGetAccount(int64_t uid, std::string& account)
+{
+    (void)uid;
+    (void)account;
+    return false;
 }
 #endif
 
@@ -14,6 +14,11 @@
 
 #include <event2/util.h>
 
+#if !defined(_WIN32) && !defined(vxWorks) && !defined(__rtems__)
+#  include <sys/un.h>
+#  define PVXS_HAVE_AF_UNIX
+#endif
+
 #include <pvxs/version.h>
 
 // added with Base 3.15
@@ -37,13 +42,19 @@ struct SockAttach {
     ~SockAttach() { osiSockRelease(); }
 };
 
-//! representation of a network address
+/** representation of a network address
+ *
+ *  Also a local (AF_UNIX) stream socket path, in the form "unix:/path" where supported.
+ */
 struct PVXS_API SockAddr {
     union store_t {
         sockaddr sa;
         sockaddr_in in;
 #ifdef AF_INET6
         sockaddr_in6 in6;
+#endif
+#ifdef PVXS_HAVE_AF_UNIX
+        sockaddr_un un;
 #endif
     };
 private:
@@ -87,15 +98,25 @@ public:
     static SockAddr any(int af, unsigned port=0);
     static SockAddr loopback(int af, unsigned port=0);
 
+    //! Local (AF_UNIX) socket path, or empty string
+    std::string path() const;
+
     inline int compare(const SockAddr& o, bool useport=true) const {
+#ifdef PVXS_HAVE_AF_UNIX
+        // evutil_sockaddr_cmp() does not order AF_UNIX
+        if(family()==AF_UNIX && o.family()==AF_UNIX)
+            return strncmp(store.un.sun_path, o.store.un.sun_path, sizeof(store.un.sun_path));
+        else if(family()==AF_UNIX || o.family()==AF_UNIX)
+            return family()<o.family() ? -1 : family()>o.family() ? 1 : 0;
+#endif
         return evutil_sockaddr_cmp(&store.sa, &o.store.sa, useport);
     }
 
     inline bool operator<(const SockAddr& o) const {
-        return evutil_sockaddr_cmp(&store.sa, &o.store.sa, true)<0;
+        return compare(o)<0;
     }
     inline bool operator==(const SockAddr& o) const {
-        return evutil_sockaddr_cmp(&store.sa, &o.store.sa, true)==0;
+        return compare(o)==0;
     }
     inline bool operator!=(const SockAddr& o) const {
         return !(*this==o);
@@ -23,6 +23,7 @@
 #include <pvxs/version.h>
 #include <pvxs/sharedArray.h>
 #include "utilpvt.h"
+#include "shm.h"
 
 namespace pvxs {namespace impl {
 
@@ -50,6 +51,8 @@ public:
     Buffer(const Buffer&) = delete;
     Buffer& operator=(const Buffer&) = delete;
     bool be;
+    // when non-NULL, large arrays may be (de)serialized through shared memory
+    ShmSegment* shm = nullptr;
 
     // all sub-classes define
     //   bool refill(size_t more)
@@ -399,7 +402,7 @@ void from_wire(Buffer& buf, std::string& s)
         buf.fault(__FILE__, __LINE__);
 
     } else {
-        s = std::string((char*)buf.save(), len.size);
+        s.assign((char*)buf.save(), len.size); // re-use capacity
         buf._skip(len.size);
     }
 }
@@ -476,6 +479,18 @@ static inline
 void to_wire(Buffer& buf, const shared_array<const void>& varr)
 {
     auto arr = varr.castTo<const E>();
+
+    if(buf.shm && std::is_same<E, C>::value && std::is_pod<C>::value && buf.be==hostBE) {
+        auto offset = buf.shm->put(arr.data(), arr.size()*sizeof(C));
+        if(offset!=size_t(-1)) {
+            // array content is in shared memory block
+            to_wire(buf, uint8_t(255u));
+            to_wire(buf, uint64_t(offset));
+            to_wire(buf, uint64_t(arr.size()));
+            return;
+        }
+    }
+
     to_wire(buf, Size{arr.size()});
 
     if(std::is_pod<C>::value) {
@@ -523,6 +538,24 @@ template<typename E, typename C = E>
 static inline
 void from_wire(Buffer& buf, shared_array<const void>& varr)
 {
+    if(buf.shm && std::is_same<E, C>::value && std::is_pod<C>::value && buf.ensure(1u) && buf[0]==255u) {
+        // array content is in shared memory block
+        buf._skip(1u);
+        uint64_t offset=0u, count=0u;
+        from_wire(buf, offset);
+        from_wire(buf, count);
+        std::shared_ptr<const void> block;
+        if(buf.good() && count <= uint64_t(-1)/sizeof(C))
+            block = buf.shm->get(offset, count*sizeof(C));
+        if(!block) {
+            buf.fault(__FILE__, __LINE__);
+        } else {
+            varr = shared_array<const E>(block, static_cast<const E*>(block.get()), size_t(count))
+                    .template castTo<const void>();
+        }
+        return;
+    }
+
     Size slen{};
     from_wire(buf, slen);
     shared_array<E> arr(slen.size);
@@ -634,7 +667,12 @@ enum pva_app_msg_t : uint8_t {
     CMD_MULTIPLE_DATA = 19,
     CMD_RPC = 20,
     CMD_CANCEL_REQUEST = 21,
-    CMD_ORIGIN_TAG = 22
+    CMD_ORIGIN_TAG = 22,
+    // pvxs extension.  Only sent to a peer which has advertised support.  cf. shm.h
+    CMD_PVXS_SHM = 0x80,
+    // pvxs extensions.  cf. zip.h
+    CMD_PVXS_ZIP = 0x81,
+    CMD_PVXS_ZIPPED = 0x82,
 };
 
 struct pva_search_flags {
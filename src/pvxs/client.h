@@ -147,13 +147,22 @@ struct PVXS_API Operation {
 protected:
     virtual void _reExecGet(std::function<void(client::Result&&)>&& resultcb) =0;
     virtual void _reExecPut(const Value& arg, std::function<void(client::Result&&)>&& resultcb) =0;
+    virtual void _reExecRPC(const Value& arg, std::function<void(client::Result&&)>&& resultcb) =0;
 public:
 #ifdef PVXS_EXPERT_API_ENABLED
-    // usable when Builder::autoExec(false)
+    /* usable when Builder::autoExec(false)
+     *
+     * Requests made before the operation is initialized, or while a previous request
+     * is in progress, are queued.  Results are delivered in order.
+     * Servers which support it (pvxs >= UNRELEASED) are sent several requests
+     * without waiting for each reply.
+     */
     // For GET/PUT, (re)issue request for current value
     inline void reExecGet(std::function<void(client::Result&&)>&& resultcb) { this->_reExecGet(std::move(resultcb)); }
     // For PUT (re)issue request to set current value
     inline void reExecPut(const Value& arg, std::function<void(client::Result&&)>&& resultcb) { this->_reExecPut(arg, std::move(resultcb)); }
+    // For RPC (re)issue request with argument.  @since UNRELEASED
+    inline void reExecRPC(const Value& arg, std::function<void(client::Result&&)>&& resultcb) { this->_reExecRPC(arg, std::move(resultcb)); }
 #endif
 };
 
@@ -170,6 +179,12 @@ struct SubscriptionStat {
     size_t maxQueue=0;
     //! Limit on queue size
     size_t limitQueue=0;
+    //! Interval between successive updates received
+    //! @since UNRELEASED
+    TimeHistogram interArrival;
+    //! Time to decode each update received
+    //! @since UNRELEASED
+    TimeHistogram decode;
 };
 
 //! Handle for monitor subscription
@@ -688,7 +703,7 @@ public:
     SubBuilder& server(const std::string& s) { this->_server = s; return _sb(); }
 
 #ifdef PVXS_EXPERT_API_ENABLED
-    // for GET/PUT control whether operations automatically proceed from INIT to EXEC
+    // for GET/PUT/RPC control whether operations automatically proceed from INIT to EXEC
     // cf. Operation::reExec()
     SubBuilder& autoExec(bool b) { this->_autoexec = b; return _sb(); }
 #endif
@@ -711,6 +726,7 @@ class GetBuilder : public detail::CommonBuilder<GetBuilder, detail::CommonBase>
     std::function<void (const Value&)> _onInit;
     std::function<void(Result&&)> _result;
     bool _get = false;
+    bool _coalesce = true;
     PVXS_API
     std::shared_ptr<Operation> _exec_info();
     PVXS_API
@@ -722,6 +738,21 @@ public:
     //! The functor is stored in the Operation returned by exec().
     GetBuilder& result(std::function<void(Result&&)>&& cb) { _result = std::move(cb); return *this; }
 
+    /** Controls whether this get() may share a network operation with other get()s.
+     *
+     * When true (the default) a get() of a PV with an identical pvRequest to
+     * another get() on the same Context, which has not yet sent its request
+     * to the server, joins that operation instead of creating another.
+     * Each joined Operation receives its own copy of the result Value.
+     * So each result reflects a server side read made after exec() was called.
+     *
+     * Operations with autoExec(false) or onInit() never join.
+     *
+     * Has no effect on info().
+     * @since UNRELEASED
+     */
+    GetBuilder& coalesce(bool b) { _coalesce = b; return *this; }
+
 #ifdef PVXS_EXPERT_API_ENABLED
     // called during operation INIT phase for Get/Put/Monitor when remote type
     // description is available.
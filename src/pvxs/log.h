@@ -76,6 +76,17 @@ void _log_printf_hex(unsigned rawlvl, _Printf_format_string_ const void *buf, si
 PVXS_API
 void xerrlogHexPrintf(const void *buf, size_t buflen);
 
+/** Messages with a level above this limit are removed at compile time.
+ *
+ * eg. building with "-DPVXS_LOG_MAX_LEVEL=40" elides all log_debug_printf() call sites,
+ * including evaluation of their arguments.  Defaults to 50 (Level::Debug), which keeps all messages.
+ *
+ * @since UNRELEASED
+ */
+#ifndef PVXS_LOG_MAX_LEVEL
+#  define PVXS_LOG_MAX_LEVEL 50
+#endif
+
 /** Try to log a message at the defined level.
  *
  * Due to portability issues with MSVC, log formats must have at least one argument.
@@ -87,8 +98,10 @@ void xerrlogHexPrintf(const void *buf, size_t buflen);
  *  @endcode
  */
 #define log_printf(LOGGER, LVL, FMT, ...) do{ \
-    if(auto _log_prefix = ::pvxs::detail::log_prep(LOGGER, unsigned(LVL))) \
-        ::pvxs::detail:: _log_printf(unsigned(LVL), "%s " FMT, _log_prefix, __VA_ARGS__); \
+    if((unsigned(LVL)&0xffu) <= unsigned(PVXS_LOG_MAX_LEVEL)) { \
+        if(auto _log_prefix = ::pvxs::detail::log_prep(LOGGER, unsigned(LVL))) \
+            ::pvxs::detail:: _log_printf(unsigned(LVL), "%s " FMT, _log_prefix, __VA_ARGS__); \
+    } \
 }while(0)
 
 /* A note about MSVC (legacy) pre-processor weirdness.
@@ -117,8 +130,10 @@ void xerrlogHexPrintf(const void *buf, size_t buflen);
 #define log_debug_printf(LOGGER, FMT, ...) log_printf(LOGGER, ::pvxs::Level::Debug, FMT, __VA_ARGS__)
 
 #define log_hex_printf(LOGGER, LVL, BUF, BUFLEN, FMT, ...) do{ \
-    if(auto _log_prefix = ::pvxs::detail::log_prep(LOGGER, unsigned(LVL))) \
-        ::pvxs::detail:: _log_printf_hex(unsigned(LVL), BUF, BUFLEN, "%s " FMT, _log_prefix, __VA_ARGS__);\
+    if((unsigned(LVL)&0xffu) <= unsigned(PVXS_LOG_MAX_LEVEL)) { \
+        if(auto _log_prefix = ::pvxs::detail::log_prep(LOGGER, unsigned(LVL))) \
+            ::pvxs::detail:: _log_printf_hex(unsigned(LVL), BUF, BUFLEN, "%s " FMT, _log_prefix, __VA_ARGS__);\
+    } \
     }while(0)
 
 //! Set level for a specific logger
@@ -140,6 +155,11 @@ PVXS_API void logger_level_clear();
  * all internal log messages.
  *
  * VAL may be one of "CRIT", "ERR", "WARN", "INFO", or "DEBUG"
+ *
+ * Independently, if **$PVXS_LOG_ASYNC** is "YES" when the first logger is initialized,
+ * then messages below Level::Crit are formatted into a per-thread ring buffer and
+ * passed to errlog by a background thread.  Messages are dropped, and counted,
+ * when a ring buffer is full.  (since UNRELEASED)
  */
 PVXS_API void logger_config_env();
 
@@ -15,6 +15,7 @@
 #include <memory>
 
 #include <pvxs/version.h>
+#include <pvxs/util.h>
 
 namespace pvxs {
 namespace impl {
@@ -41,6 +42,53 @@ namespace impl {
  * @since 0.2.0
  */
 struct Report {
+    /** Distribution of time spent by monitor updates waiting within a server.
+     *
+     * Only populated by Server::report() when server::Config::latencyStats is set.
+     *
+     * @since UNRELEASED
+     */
+    struct Latency {
+        //! From MonitorControlOp::post() until de-queued for transmission
+        TimeHistogram queue;
+        //! From MonitorControlOp::post() until handed to the OS socket
+        TimeHistogram send;
+
+        inline Latency& operator+=(const Latency& o) {
+            queue += o.queue;
+            send += o.send;
+            return *this;
+        }
+        inline void clear() {
+            queue.clear();
+            send.clear();
+        }
+    };
+
+    /** Distribution of client side operation timing.
+     *
+     * Only populated by Context::report()
+     *
+     * @since UNRELEASED
+     */
+    struct Timing {
+        //! From start of search until channel is connected
+        TimeHistogram connect;
+        //! Round trip time of GET/PUT/RPC execution.  From request sent until reply received.
+        TimeHistogram rtt;
+        //! Interval between successive monitor updates of each Subscription
+        TimeHistogram interArrival;
+        //! Time to decode each monitor update
+        TimeHistogram decode;
+
+        inline void clear() {
+            connect.clear();
+            rtt.clear();
+            interArrival.clear();
+            decode.clear();
+        }
+    };
+
     //! Info for a single channel (to a particular PV name on a particular server)
     struct Channel {
         //! Channel name.  aka. PV name
@@ -49,6 +97,12 @@ struct Report {
         size_t tx{}, rx{};
         //! Contextual information (maybe) supplied by the Source
         std::shared_ptr<const ReportInfo> info;
+        //! Monitor update latency through this channel.
+        //! @since UNRELEASED
+        Latency latency;
+        //! Client side operation timing.
+        //! @since UNRELEASED
+        Timing timing;
     };
 
     //! Info for a single connection to remote peer
@@ -61,10 +115,95 @@ struct Report {
         size_t tx{}, rx{};
         //! Channels currently connected through this socket
         std::list<Channel> channels;
+        //! Monitor update latency through this connection, including closed channels.
+        //! @since UNRELEASED
+        Latency latency;
+        /** Compression of message bodies.  Only from Server::report() when negotiated.
+         *  Body bytes before and after compression, time spent compressing (seconds),
+         *  and number of times compression was suspended after exceeding its CPU budget.
+         *  cf. server::Config::compressThreshold
+         *  @since UNRELEASED
+         */
+        size_t zipIn{}, zipOut{}, zipSuspend{};
+        double zipTime{};
+        /** Arrays, and their size in bytes, sent through shared memory.
+         *  Only from Server::report() when negotiated.
+         *  cf. server::Config::shmSize
+         *  @since UNRELEASED
+         */
+        size_t shmBlocks{}, shmBytes{};
     };
 
     //! Currently open sockets
     std::list<Connection> connections;
+
+    //! Monitor update latency through all connections, including closed connections.
+    //! @since UNRELEASED
+    Latency latency;
+
+    /** Time spent in callbacks by an event loop worker thread.
+     *
+     * Only populated when stall detection is enabled by $PVXS_LOOP_STALL_THRESHOLD.
+     *
+     * @since UNRELEASED
+     */
+    struct Loop {
+        //! Worker thread name
+        std::string name;
+        //! Distribution of callback run times
+        TimeHistogram callbacks;
+        //! Number of callbacks which exceeded the stall threshold
+        uint64_t stalls{};
+    };
+
+    //! Event loop workers used by this client/server.
+    //! Includes the UDP worker, which may be shared with other clients/servers in this process.
+    //! @since UNRELEASED
+    std::list<Loop> loops;
+
+    /** Contention statistics of internal locks.
+     *
+     * Only populated when lock profiling is enabled by $PVXS_LOCK_PROFILE=YES.
+     * Statistics are process wide, and accumulated for all locks of the same name.
+     *
+     * @since UNRELEASED
+     */
+    struct Lock {
+        //! Lock name.  eg. "SharedPV" or "MonitorOp"
+        std::string name;
+        //! Number of times lock was acquired
+        uint64_t acquisitions{};
+        //! Number of acquisitions which had to wait
+        uint64_t contended{};
+        //! Time spent waiting by contended acquisitions
+        TimeHistogram wait;
+        //! Time from acquisition until release
+        TimeHistogram hold;
+    };
+
+    //! @since UNRELEASED
+    std::list<Lock> locks;
+
+    /** Lookups of client account roles.  cf. server::ClientCredentials::roles()
+     *
+     * Statistics are process wide.  Only from Server::report()
+     *
+     * @since UNRELEASED
+     */
+    struct Roles {
+        //! Number of roles() answered from cache
+        uint64_t hits{};
+        //! Number of hits answered from an expired entry, while it was refreshed
+        uint64_t stale{};
+        //! Number of roles() which waited for a lookup
+        uint64_t misses{};
+        //! Number of lookups which did not find the account
+        uint64_t unknown{};
+        //! Current number of cached accounts
+        size_t entries{};
+        //! Time spent in each lookup
+        TimeHistogram lookup;
+    } roles;
 };
 
 struct PVXS_API ReportInfo {
@@ -160,6 +160,37 @@ struct NTNDArray {
     inline Value create() const {
         return build().create();
     }
+
+    /** Compress the "value" array of an NTNDArray in place.
+     *
+     * The array is replaced with "value->ubyteValue" holding the compressed bytes,
+     * and the "codec", "compressedSize", and "uncompressedSize" fields are set
+     * in the manner of areaDetector.
+     *
+     * Currently the only codec is "lz4", the LZ4 block format.
+     * Large arrays are divided between several threads.
+     * The uncompressed array is read in place, without conversion.
+     *
+     * @param img NTNDArray with an uncompressed, numeric, "value".
+     * @param codec Codec name.
+     * @param nthreads Upper limit on threads used, including the caller.  Zero for the number of CPUs.
+     * @throws std::logic_error for an unsupported codec or array type, or if "value" is already compressed.
+     * @since UNRELEASED
+     */
+    PVXS_API
+    static void compress(Value& img, const std::string& codec = "lz4", unsigned nthreads = 0u);
+
+    /** Decompress the "value" array of an NTNDArray in place.
+     *
+     * Reverses compress(), or the equivalent from areaDetector.
+     * The original array type is restored from "codec.parameters".
+     * No-op if "codec.name" is empty.
+     *
+     * @throws std::runtime_error for an unsupported codec, or invalid compressed data.
+     * @since UNRELEASED
+     */
+    PVXS_API
+    static void decompress(Value& img);
 };
 
 class PVXS_API NTURI {
@@ -175,6 +175,110 @@ struct PVXS_API Config {
     //! @since 0.2.0
     double tcpTimeout = 40.0;
 
+    /** Collect statistics on the latency of monitor updates.
+     *
+     * When enabled, each MonitorControlOp::post() is time stamped.  The delays
+     * until each update is de-queued, and then handed to the OS socket, are
+     * accumulated as histograms.  cf. Server::report() and the "latency"
+     * operation of the "server" PV.
+     *
+     * May also be set with $PVXS_SERVER_LATENCY_STATS=YES
+     *
+     * @since UNRELEASED
+     */
+    bool latencyStats = false;
+
+    /** Name of an optional PV publishing server statistics.
+     *
+     * When not empty, the server will serve an NTTable with this name
+     * containing one row per client connection, and a final row "*"
+     * with totals for the server.  Includes byte counts and rates,
+     * operation counts, monitor queue depth and squash counts.
+     * Also search request rates and instanceSnapshot() counters.
+     * Updated every statsPeriod seconds.
+     *
+     * May also be set with $PVXS_SERVER_STATS_PV
+     *
+     * @since UNRELEASED
+     */
+    std::string statsPV;
+
+    /** Interval, in seconds, between updates of statsPV.
+     *
+     * May also be set with $PVXS_SERVER_STATS_PERIOD
+     *
+     * @since UNRELEASED
+     */
+    double statsPeriod = 5.0;
+
+    /** Size, in bytes, of a shared memory segment offered to same host clients.
+     *
+     * When non-zero, pvxs clients connecting through a local socket (cf. unixPath) are offered
+     * a per-connection shared memory segment of this size.  Large numeric arrays
+     * (eg. NTNDArray value) sent in GET, RPC, and monitor replies are copied into this
+     * segment, and only a descriptor is sent through the socket.  Arrays are sent inline
+     * when the segment is full.  Currently only supported on Linux.
+     *
+     * May also be set with $PVXS_SERVER_SHM_SIZE
+     *
+     * @since UNRELEASED
+     */
+    size_t shmSize = 0u;
+
+    /** Path of a local (AF_UNIX) stream socket on which to also accept connections.
+     *
+     * When not empty, the server additionally listens on this socket.
+     * Clients on the same host may then connect with an address of the form "unix:/path",
+     * either through client::Config::nameServers or eg. client::GetBuilder::server().
+     * Such connections bypass the TCP/IP stack, but otherwise behave as TCP connections.
+     * A stale socket file left by an exited process is replaced.
+     * Not supported on Windows, RTEMS, or vxWorks.
+     *
+     * May also be set with $PVXS_SERVER_UNIX_PATH
+     *
+     * @since UNRELEASED
+     */
+    std::string unixPath;
+
+    /** Compress replies to pvxs clients when body is at least this many bytes.
+     *
+     * When non-zero, compression is offered to pvxs clients during connection validation.
+     * Message bodies sent to such clients of at least this size are compressed with a
+     * fast built-in codec, which may reference previous bodies sent through the same connection.
+     * So successive updates of slowly changing arrays compress well.
+     * Not used with other PVA clients.  Zero (default) disables.
+     *
+     * May also be set with $PVXS_SERVER_COMPRESS_THRESHOLD
+     *
+     * @since UNRELEASED
+     */
+    size_t compressThreshold = 0u;
+
+    /** Fraction of time which each connection may spend compressing.
+     *
+     * Compression is suspended for a time when this budget is exceeded,
+     * or if the size reduction is less than 10%.
+     *
+     * May also be set with $PVXS_SERVER_COMPRESS_BUDGET
+     *
+     * @since UNRELEASED
+     */
+    double compressBudget = 0.1;
+
+    /** Time, in seconds, to hold back search replies to aggregate names claimed.
+     *
+     * When non-zero, names claimed in response to search requests from the same client,
+     * with the same search sequence ID, are collected for up to this long before being sent.
+     * Clients which search for many names in many small packets then receive
+     * fewer, and fuller, replies.  A reply is sent as soon as it is full.
+     * Zero (default) replies to each search request immediately.  Limited to 0.1 seconds.
+     *
+     * May also be set with $PVXS_SERVER_SEARCH_REPLY_HOLD
+     *
+     * @since UNRELEASED
+     */
+    double searchReplyHold = 0.0;
+
     //! Server unique ID.  Only meaningful in readback via Server::config()
     ServerGUID guid{};
 
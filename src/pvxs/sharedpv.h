@@ -17,6 +17,10 @@
 namespace pvxs {
 class Value;
 
+namespace client {
+class Context;
+}
+
 namespace server {
 
 struct ChannelControl;
@@ -115,6 +119,63 @@ private:
     std::shared_ptr<Impl> impl;
 };
 
+/** Re-serve PVs found through a client Context.  A caching proxy.
+ *
+ * The first search or channel creation for a PV name starts one upstream
+ * subscription, which is then shared by all downstream clients of that PV.
+ * So the load on the upstream server does not depend on the number of downstream clients.
+ * Names are claimed once the upstream subscription delivers its first update.
+ * GET is answered from the latest update.  PUT and RPC are forwarded upstream.
+ *
+ * Until a PV is found, only an upstream channel is created, which searches.
+ * Upstream subscriptions without downstream clients are kept in a cache of at most
+ * maxIdle entries, after which the least recently used are cancelled.
+ * Separately, at most maxPending names which have not (yet) been found upstream are
+ * remembered, after which the oldest are forgotten.
+ * maxPending should exceed the number of distinct names which downstream clients may
+ * be searching for at any one time.
+ *
+ * @code
+ * auto upstream(client::Config::from_env().build());
+ * auto proxy(server::ProxySource::build(upstream));
+ * auto srv(server::Config::from_env().build()
+ *          .addSource("proxy", proxy.source()));
+ * @endcode
+ *
+ * @warning Do not proxy the Server which the ProxySource is added to.
+ *          eg. by using the server's own client configuration.
+ *
+ * @since UNRELEASED
+ */
+struct PVXS_API ProxySource
+{
+    /** Create a new proxy.
+     *
+     * @param upstream Client context through which PVs are found
+     * @param maxIdle Upper limit on upstream subscriptions without downstream clients
+     * @param maxPending Upper limit on names being searched for upstream without downstream clients
+     */
+    static ProxySource build(const client::Context& upstream, size_t maxIdle = 64u, size_t maxPending = 1024u);
+
+    ~ProxySource();
+
+    inline explicit operator bool() const { return !!impl; }
+
+    //! Fetch the Source interface, which may be used with Server::addSource()
+    std::shared_ptr<Source> source() const;
+
+    //! Disconnect all downstream clients and cancel all upstream subscriptions.
+    void close();
+
+    //! Upstream subscription state by PV name.  True if downstream clients are connected.
+    typedef std::map<std::string, bool> list_t;
+    list_t list() const;
+
+    struct Impl;
+private:
+    std::shared_ptr<Impl> impl;
+};
+
 } // namespace server
 } // namespace pvxs
 
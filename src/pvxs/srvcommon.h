@@ -30,6 +30,11 @@ namespace server {
  * - "ca" - Client provided account name.
  * - "anonymous" - Client provided no credentials.  account will also be "anonymous".
  *
+ * Since UNRELEASED, for a client connected through a local socket (cf. server::Config::unixPath),
+ * where the OS provides them, peer includes the process and user IDs of the client process
+ * (eg. "unix:/run/ioc.sock,pid=1234,uid=1000"), and method is always "ca" with account
+ * naming the user of that process, regardless of the credentials presented.
+ *
  * @since 0.2.0
  */
 struct PVXS_API ClientCredentials {
@@ -50,6 +55,9 @@ struct PVXS_API ClientCredentials {
      * in with the account is a member.
      * On Windows targets this returns the list of local groups for the account.
      * On other targets, an empty list is returned.
+     *
+     * Since UNRELEASED, results are cached process wide.
+     * cf. $PVXS_ROLE_CACHE_TTL and $PVXS_ROLE_CACHE_NEGATIVE_TTL
      */
     std::set<std::string> roles() const;
 };
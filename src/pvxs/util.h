@@ -315,6 +315,50 @@ public:
     }
 };
 
+/** Log2 scale histogram of time intervals.
+ *
+ * Bucket zero counts intervals shorter than 1 microsecond.
+ * Bucket N>0 counts intervals in the range [2**(N-1), 2**N) microseconds.
+ * The last bucket also counts all longer intervals.
+ *
+ * Not thread-safe.  Callers provide any necessary locking.
+ *
+ * @since UNRELEASED
+ */
+struct PVXS_API TimeHistogram {
+    static constexpr size_t nbuckets = 32u;
+    //! Sample counts
+    std::array<uint64_t, nbuckets> buckets{};
+    //! Total number of samples
+    uint64_t count = 0u;
+    //! Sum of all sample intervals in nanoseconds
+    uint64_t total = 0u;
+    //! Longest single interval in nanoseconds
+    uint64_t longest = 0u;
+
+    //! Record one interval in nanoseconds
+    void sample(uint64_t ns);
+    //! Accumulate counts from another histogram
+    TimeHistogram& operator+=(const TimeHistogram& o);
+    //! Zero all counters
+    inline void clear() { *this = TimeHistogram{}; }
+
+    //! Upper limit of a bucket in seconds
+    static double limit(size_t bucket);
+    //! Mean interval in seconds.  Zero if empty.
+    double mean() const;
+    /** Estimate a quantile (eg. 0.5 for median) in seconds.
+     *
+     * Returns the upper limit of the bucket in which the quantile falls.
+     * Zero if empty.
+     */
+    double quantile(double q) const;
+};
+
+//! Print summary of count, mean, median, 99th percentile and max
+PVXS_API
+std::ostream& operator<<(std::ostream& strm, const TimeHistogram& hist);
+
 struct Timer;
 
 #ifdef PVXS_EXPERT_API_ENABLED
@@ -0,0 +1,296 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+/* Process wide cache of osdGetRoles() results.
+ *
+ * osdGetRoles() may block for some time (eg. LDAP/SSSD backed NSS).
+ * Lookups are made by a single worker thread.  Once roles have been asked for,
+ * server connections request a lookup as soon as the client account is known,
+ * so that a later call to ClientCredentials::roles() will usually find a cached result.
+ * Results for unknown accounts are also cached, usually for a shorter time.
+ * Once expired, a result continues to be used for up to another TTL while it is
+ * refreshed in the background.  Callers only wait when no usable result exists.
+ */
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+
+#include <stdlib.h>
+
+#include <epicsEvent.h>
+#include <epicsGuard.h>
+#include <epicsMutex.h>
+#include <epicsThread.h>
+
+#include <pvxs/log.h>
+
+#include "utilpvt.h"
+
+DEFINE_LOGGER(logrole, "pvxs.roles");
+
+namespace pvxs {
+namespace impl {
+
+namespace {
+
+typedef epicsGuard<epicsMutex> Guard;
+typedef epicsGuardRelease<epicsMutex> UnGuard;
+
+// interval between scans for expired entries
+constexpr double pruneInterval = 30.0;
+
+uint64_t envSeconds(const char* name, double def)
+{
+    double val = def;
+    if(auto env = getenv(name)) {
+        try {
+            val = parseTo<double>(env);
+        }catch(std::exception& e){
+            log_warn_printf(logrole, "Ignore invalid %s=\"%s\" : %s\n", name, env, e.what());
+        }
+    }
+    if(!(val > 0.0))
+        val = 0.0;
+    return uint64_t(val*1e9);
+}
+
+struct RoleCache final : public epicsThreadRunable {
+    struct Entry {
+        std::set<std::string> roles;
+        // monotonicNS().  Valid when ready
+        uint64_t expires = 0u; // refresh after
+        uint64_t discard = 0u; // no longer used after
+        bool ready = false;
+        // signaled, once, when ready.  Each waiter passes the signal along.
+        epicsEvent done;
+    };
+    typedef std::shared_ptr<Entry> pentry_t;
+
+    struct Account {
+        pentry_t cur;  // latest result, or first lookup in progress
+        pentry_t next; // refresh in progress
+    };
+
+    // TTL in nanoseconds.  Zero disables the cache.
+    const uint64_t ttl, negativeTTL;
+
+    epicsMutex lock;
+    // guarded by lock
+    std::map<std::string, Account> entries;
+    std::deque<std::pair<std::string, pentry_t>> todo;
+    RoleCacheStats stats;
+
+    epicsEvent wakeup;
+    epicsThread worker;
+
+    RoleCache()
+        :ttl(envSeconds("PVXS_ROLE_CACHE_TTL", 300.0))
+        ,negativeTTL(envSeconds("PVXS_ROLE_CACHE_NEGATIVE_TTL", 30.0))
+        ,worker(*this, "PVXROLE",
+                epicsThreadGetStackSize(epicsThreadStackSmall),
+                epicsThreadPriorityMedium)
+    {
+        if(ttl)
+            worker.start();
+    }
+    virtual ~RoleCache() {} // never destroyed
+
+    pentry_t request(Guard& G, const std::string& account)
+    {
+        G.assertIdenticalMutex(lock);
+
+        auto ent(std::make_shared<Entry>());
+        todo.emplace_back(account, ent);
+        wakeup.signal();
+        return ent;
+    }
+
+    /* find a usable entry, or begin a lookup.
+     * An expired entry is returned, and sets stale, while a refresh is in progress.
+     */
+    pentry_t lookup(Guard& G, const std::string& account, bool& stale)
+    {
+        G.assertIdenticalMutex(lock);
+
+        auto now = monotonicNS();
+        auto& acct = entries[account];
+
+        if(acct.cur && acct.cur->ready && acct.cur->discard <= now)
+            acct.cur.reset(); // too old to use
+
+        if(!acct.cur) {
+            // wait for a refresh already in progress, or begin a new lookup
+            acct.cur = acct.next ? std::move(acct.next) : request(G, account);
+            acct.next.reset();
+
+        } else if(acct.cur->ready && acct.cur->expires <= now) {
+            if(!acct.next)
+                acct.next = request(G, account);
+            stale = true;
+        }
+        return acct.cur;
+    }
+
+    void prune(Guard& G)
+    {
+        G.assertIdenticalMutex(lock);
+
+        auto now = monotonicNS();
+        for(auto it(entries.begin()); it!=entries.end();) {
+            auto& acct = it->second;
+            if(!acct.next && acct.cur->ready && acct.cur->discard <= now) {
+                it = entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    virtual void run() override final
+    {
+        Guard G(lock);
+        while(true) {
+            if(todo.empty()) {
+                bool timeout;
+                {
+                    UnGuard U(G);
+                    timeout = !wakeup.wait(pruneInterval);
+                }
+                if(timeout)
+                    prune(G);
+                continue;
+            }
+
+            auto req(std::move(todo.front()));
+            todo.pop_front();
+
+            std::set<std::string> roles;
+            bool known = false;
+            auto start = monotonicNS();
+            {
+                UnGuard U(G);
+                try {
+                    known = osdGetRoles(req.first, roles);
+                }catch(std::exception& e){
+                    log_err_printf(logrole, "Error looking up roles of '%s' : %s\n",
+                                   req.first.c_str(), e.what());
+                    roles.clear();
+                    roles.insert(req.first);
+                }
+            }
+            auto now = monotonicNS();
+
+            stats.lookup.sample(now - start);
+            if(!known)
+                stats.unknown++;
+
+            log_debug_printf(logrole, "'%s' %s %zu roles in %.3f sec\n",
+                             req.first.c_str(), known ? "has" : "unknown,",
+                             roles.size(), double(now - start)*1e-9);
+
+            auto& ent = req.second;
+            const auto life = known ? ttl : negativeTTL;
+            ent->roles = std::move(roles);
+            ent->expires = now + life;
+            ent->discard = ent->expires + life;
+            ent->ready = true;
+            ent->done.signal();
+
+            // a completed refresh replaces the stale entry
+            auto it(entries.find(req.first));
+            if(it!=entries.end() && it->second.next==ent) {
+                it->second.cur = std::move(it->second.next);
+                it->second.next.reset();
+            }
+        }
+    }
+};
+
+RoleCache* roleCache;
+// set by the first roleCacheGet().  Servers which never ask for roles make no lookups.
+std::atomic<bool> roleCacheUsed{false};
+
+void roleCacheInit()
+{
+    roleCache = new RoleCache;
+}
+
+} // namespace
+
+void roleCachePrefetch(const std::string& account)
+{
+    if(!roleCacheUsed.load(std::memory_order_relaxed))
+        return;
+
+    threadOnce<&roleCacheInit>();
+    auto& C = *roleCache;
+    if(!C.ttl)
+        return;
+
+    Guard G(C.lock);
+    bool stale = false;
+    (void)C.lookup(G, account, stale);
+}
+
+void roleCacheGet(const std::string& account, std::set<std::string>& roles)
+{
+    roleCacheUsed.store(true, std::memory_order_relaxed);
+    threadOnce<&roleCacheInit>();
+    auto& C = *roleCache;
+
+    if(!C.ttl) {
+        // cache disabled.  Lookup in caller
+        auto start = monotonicNS();
+        bool known = osdGetRoles(account, roles);
+        auto elapsed = monotonicNS() - start;
+
+        Guard G(C.lock);
+        C.stats.misses++;
+        C.stats.lookup.sample(elapsed);
+        if(!known)
+            C.stats.unknown++;
+        return;
+    }
+
+    Guard G(C.lock);
+    bool stale = false;
+    auto ent(C.lookup(G, account, stale));
+
+    if(ent->ready) {
+        C.stats.hits++;
+        if(stale)
+            C.stats.stale++;
+
+    } else {
+        C.stats.misses++;
+        while(!ent->ready) {
+            UnGuard U(G);
+            ent->done.wait();
+        }
+        ent->done.signal(); // wake next waiter, if any
+    }
+
+    roles.insert(ent->roles.begin(), ent->roles.end());
+}
+
+RoleCacheStats roleCacheSnapshot(bool zero)
+{
+    if(!roleCacheUsed.load(std::memory_order_relaxed))
+        return RoleCacheStats{};
+
+    threadOnce<&roleCacheInit>();
+    auto& C = *roleCache;
+
+    Guard G(C.lock);
+    auto ret(C.stats);
+    ret.entries = C.entries.size();
+    if(zero)
+        C.stats = RoleCacheStats{};
+    return ret;
+}
+
+}} // namespace pvxs::impl
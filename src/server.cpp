@@ -24,6 +24,7 @@
 #include <pvxs/server.h>
 #include <pvxs/client.h>
 #include <pvxs/log.h>
+#include <pvxs/nt.h>
 #include "evhelper.h"
 #include "serverconn.h"
 #include "utilpvt.h"
@@ -45,6 +46,50 @@ DEFINE_LOGGER(serversearch, "pvxs.server.search");
 static constexpr timeval beaconIntervalShort{15, 0};
 static constexpr timeval beaconIntervalLong{180, 0};
 
+// as with client search requests, try not to fragment search replies.
+// 49 bytes of header and fixed fields, then 4 bytes per ID.
+static constexpr size_t maxReplyIDs = (1400u - 49u)/4u;
+// limit on clients with held search replies (cf. Config::searchReplyHold).
+// Beyond this, reply immediately.
+static constexpr size_t maxPendingReplies = 1024u;
+
+// prototype for Config::statsPV
+static
+Value buildStats()
+{
+    using namespace pvxs::members;
+
+    nt::NTTable table;
+    table.add_column(TypeCode::String, "peer", "Peer")
+         .add_column(TypeCode::UInt64, "channels", "Channels")
+         .add_column(TypeCode::UInt64, "get", "GET")
+         .add_column(TypeCode::UInt64, "put", "PUT")
+         .add_column(TypeCode::UInt64, "rpc", "RPC")
+         .add_column(TypeCode::UInt64, "monitor", "MONITOR")
+         .add_column(TypeCode::UInt64, "info", "INFO")
+         .add_column(TypeCode::UInt64, "queued", "Mon. Queued")
+         .add_column(TypeCode::UInt64, "squashed", "Mon. Squashed")
+         .add_column(TypeCode::UInt64, "backlog", "Backlog")
+         .add_column(TypeCode::UInt64, "txBytes", "TX bytes")
+         .add_column(TypeCode::UInt64, "rxBytes", "RX bytes")
+         .add_column(TypeCode::Float64, "txRate", "TX bytes/s")
+         .add_column(TypeCode::Float64, "rxRate", "RX bytes/s");
+
+    auto def(table.build());
+    def += {
+        Float64("searchRate"),
+        Float64("claimRate"),
+        Struct("instances", {
+            StringA("name"),
+            UInt64A("count"),
+        }),
+    };
+
+    auto ret(def.create());
+    ret["labels"].assign(table.create()["labels"]);
+    return ret;
+}
+
 Server Server::fromEnv()
 {
     return Config::fromEnv().build();
@@ -242,6 +287,10 @@ Report Server::report(bool zero) const
 
     pvt->acceptor_loop.call([this, &ret, zero](){
 
+        ret.latency = pvt->latency;
+        if(zero)
+            pvt->latency.clear();
+
         for(auto& pair : pvt->connections) {
             auto conn = pair.first;
 
@@ -251,9 +300,25 @@ Report Server::report(bool zero) const
             sconn.credentials = conn->cred;
             sconn.tx = conn->statTx;
             sconn.rx = conn->statRx;
+            sconn.latency = conn->latency;
+            if(auto& zip = conn->zipTx) {
+                sconn.zipIn = zip->nIn;
+                sconn.zipOut = zip->nOut;
+                sconn.zipSuspend = zip->nSuspend;
+                sconn.zipTime = double(zip->nTime)*1e-9;
+            }
+            if(auto& shm = conn->shm) {
+                sconn.shmBlocks = shm->nBlocks;
+                sconn.shmBytes = shm->nBytes;
+            }
 
             if(zero) {
                 conn->statTx = conn->statRx = 0u;
+                conn->latency.clear();
+                if(auto& zip = conn->zipTx)
+                    zip->nIn = zip->nOut = zip->nTime = zip->nSuspend = 0u;
+                if(auto& shm = conn->shm)
+                    shm->nBlocks = shm->nBytes = 0u;
             }
 
             for(auto& pair : conn->chanBySID) {
@@ -265,15 +330,37 @@ Report Server::report(bool zero) const
                 schan.tx = chan->statTx;
                 schan.rx = chan->statRx;
                 schan.info = chan->reportInfo;
+                schan.latency = chan->latency;
 
                 if(zero) {
                     chan->statTx = chan->statRx = 0u;
+                    chan->latency.clear();
                 }
             }
         }
 
     });
 
+    // TCP connections, and UDP searches
+    for(auto loop : {&pvt->acceptor_loop, &pvt->udpLoop}) {
+        Report::Loop sloop;
+        sloop.name = loop->name();
+        if(loop->stats(sloop.callbacks, sloop.stalls, zero))
+            ret.loops.push_back(std::move(sloop));
+    }
+
+    lockProfileReport(ret, zero);
+
+    {
+        auto roles(roleCacheSnapshot(zero));
+        ret.roles.hits = roles.hits;
+        ret.roles.stale = roles.stale;
+        ret.roles.misses = roles.misses;
+        ret.roles.unknown = roles.unknown;
+        ret.roles.entries = roles.entries;
+        ret.roles.lookup = roles.lookup;
+    }
+
     return ret;
 }
 
@@ -325,6 +412,34 @@ std::ostream& operator<<(std::ostream& strm, const Server& serv)
 
             Indented I(strm);
 
+            if(serv.pvt->effective.latencyStats) {
+                strm<<indent{}<<"Queue latency: "<<serv.pvt->latency.queue<<"\n"
+                    <<indent{}<<"Send latency:  "<<serv.pvt->latency.send<<"\n";
+            }
+
+            {
+                TimeHistogram callbacks;
+                uint64_t stalls = 0u;
+                if(serv.pvt->acceptor_loop.stats(callbacks, stalls, false))
+                    strm<<indent{}<<"Loop callbacks: "<<callbacks<<" stalls="<<stalls<<"\n";
+            }
+
+            for(auto& pair : lockProfileSnapshot()) {
+                strm<<indent{}<<"Lock "<<pair.first<<" acquired="<<pair.second.acquisitions
+                    <<" contended="<<pair.second.contended<<"\n";
+                Indented I(strm);
+                strm<<indent{}<<"wait: "<<pair.second.wait<<"\n"
+                    <<indent{}<<"hold: "<<pair.second.hold<<"\n";
+            }
+
+            {
+                auto roles(roleCacheSnapshot());
+                if(roles.hits || roles.misses)
+                    strm<<indent{}<<"Roles hits="<<roles.hits<<" stale="<<roles.stale<<" misses="<<roles.misses
+                        <<" unknown="<<roles.unknown<<" entries="<<roles.entries
+                        <<" lookup: "<<roles.lookup<<"\n";
+            }
+
             for(auto& pair : serv.pvt->connections) {
                 auto conn = pair.first;
 
@@ -332,6 +447,21 @@ std::ostream& operator<<(std::ostream& strm, const Server& serv)
                     <<" backlog="<<conn->backlog.size()
                     <<" TX="<<conn->statTx<<" RX="<<conn->statRx
                     <<" auth="<<conn->cred->method<<"\n";
+                if(auto& zip = conn->zipTx) {
+                    Indented I(strm);
+                    strm<<indent{}<<"Compressed "<<zip->nIn<<" -> "<<zip->nOut<<" bytes in "
+                        <<double(zip->nTime)*1e-9<<" sec. suspended="<<zip->nSuspend<<"\n";
+                }
+                if(auto& shm = conn->shm) {
+                    Indented I(strm);
+                    strm<<indent{}<<"Shared memory "<<shm->path<<" sent "<<shm->nBlocks<<" arrays, "
+                        <<shm->nBytes<<" bytes\n";
+                }
+                if(serv.pvt->effective.latencyStats) {
+                    Indented I(strm);
+                    strm<<indent{}<<"Queue latency: "<<conn->latency.queue<<"\n"
+                        <<indent{}<<"Send latency:  "<<conn->latency.send<<"\n";
+                }
                 if(detail>2)
                     strm<<*conn->cred;
 
@@ -387,6 +517,9 @@ Server::Pvt::Pvt(const Config &conf)
     ,beaconTimer(__FILE__, __LINE__,
                  event_new(acceptor_loop.base, -1, EV_TIMEOUT, doBeaconsS, this))
     ,searchReply(0x10000)
+    ,statsProto(buildStats())
+    ,statsTimer(__FILE__, __LINE__,
+                event_new(acceptor_loop.base, -1, EV_TIMEOUT|EV_PERSIST, doStatsS, this))
     ,builtinsrc(StaticSource::build())
     ,state(Stopped)
 {
@@ -396,6 +529,10 @@ Server::Pvt::Pvt(const Config &conf)
 
     auto manager = UDPManager::instance(effective.shareUDP());
 
+    udpLoop = manager.loop();
+    searchHoldTimer = evevent(__FILE__, __LINE__,
+                              event_new(udpLoop.base, -1, EV_TIMEOUT, doSearchHoldS, this));
+
     evsocket dummy(AF_INET, SOCK_DGRAM, 0);
 
     const auto cb(std::bind(&Pvt::onSearch, this, std::placeholders::_1));
@@ -504,6 +641,11 @@ Server::Pvt::Pvt(const Config &conf)
             firstiface = false;
         }
 
+        if(!effective.unixPath.empty()) {
+            SockAddr addr(std::string(SB()<<"unix:"<<effective.unixPath));
+            interfaces.emplace_back(addr, this, false);
+        }
+
         for(const auto& addr : effective.beaconDestinations) {
             beaconDest.emplace_back(addr.c_str(), effective.udp_port);
             log_debug_printf(serversetup, "Will send beacons to %s\n",
@@ -561,6 +703,12 @@ Server::Pvt::Pvt(const Config &conf)
         sources[std::make_pair(-1, "__server")] = std::make_shared<ServerSource>(this);
         sources[std::make_pair(-1, "__builtin")] = builtinsrc.source();
     }
+
+    if(!effective.statsPV.empty()) {
+        statsPV = SharedPV::buildReadonly();
+        statsPV.open(statsProto.cloneEmpty());
+        builtinsrc.add(effective.statsPV, statsPV);
+    }
 }
 
 Server::Pvt::~Pvt()
@@ -608,6 +756,12 @@ void Server::Pvt::start()
         if(event_add(beaconTimer.get(), &immediate))
             log_err_printf(serversetup, "Error enabling beacon timer on\n%s", "");
 
+        if(statsPV) {
+            auto period(totv(effective.statsPeriod));
+            if(event_add(statsTimer.get(), &period))
+                log_err_printf(serversetup, "Error enabling stats timer on\n%s", "");
+        }
+
         state = Running;
     });
 
@@ -631,6 +785,9 @@ void Server::Pvt::stop()
 
         if(event_del(beaconTimer.get()))
             log_err_printf(serversetup, "Error disabling beacon timer on\n%s", "");
+
+        if(statsPV && event_del(statsTimer.get()))
+            log_err_printf(serversetup, "Error disabling stats timer on\n%s", "");
     });
     if(prev_state!=Running)
         return;
@@ -640,6 +797,19 @@ void Server::Pvt::stop()
         L->stop();
     }
 
+    // send any held search replies
+    udpLoop.call([this]()
+    {
+        (void)event_del(searchHoldTimer.get());
+        for(auto& key : pendingOrder) {
+            auto it(pendingReplies.find(key));
+            if(it!=pendingReplies.end())
+                sendPendingReply(it->first, it->second);
+        }
+        pendingReplies.clear();
+        pendingOrder.clear();
+    });
+
     acceptor_loop.call([this]()
     {
         // stop accepting new TCP connections
@@ -714,29 +884,82 @@ void Server::Pvt::onSearch(const UDPManager::Search& msg)
         if(name._claim)
             nreply++;
     }
+    statSearch += searchOp._names.size();
+    statClaim += nreply;
 
     // "pvlist" breaks unless we honor mustReply flag
     if(nreply==0 && !msg.mustReply)
         return;
 
+    auto it(pendingReplies.end());
+    if(effective.searchReplyHold > 0.0) {
+        auto key(std::make_pair(msg.src, msg.searchID));
+        it = pendingReplies.find(key);
+        if(it==pendingReplies.end() && pendingReplies.size() < maxPendingReplies) {
+            it = pendingReplies.emplace(key, PendingReply()).first;
+            it->second.reply = msg.deferReply();
+            it->second.deadline = monotonicNS() + uint64_t(effective.searchReplyHold*1e9);
+            if(pendingOrder.empty()) {
+                auto hold(totv(effective.searchReplyHold));
+                if(event_add(searchHoldTimer.get(), &hold))
+                    log_err_printf(serversetup, "Error enabling search hold timer\n%s", "");
+            }
+            pendingOrder.push_back(key);
+        }
+    }
+
+    if(effective.searchReplyHold > 0.0 && it!=pendingReplies.end()) {
+        auto& pending = it->second;
+
+        pending.mustReply |= msg.mustReply;
+        for(auto i : range(msg.names.size())) {
+            if(searchOp._names[i]._claim) {
+                pending.ids.push_back(msg.names[i].id);
+                log_debug_printf(serversearch, "Search claimed '%s'\n", msg.names[i].name);
+            }
+        }
+
+        // send full replies now.  Hold any remainder
+        while(pending.ids.size() >= maxReplyIDs) {
+            auto pktlen = buildSearchReply(msg.searchID, pending.ids.data(), maxReplyIDs);
+            if(pktlen)
+                (void)msg.reply(searchReply.data(), pktlen);
+            pending.ids.erase(pending.ids.begin(), pending.ids.begin()+maxReplyIDs);
+            pending.mustReply = false;
+        }
+        return;
+    }
+
+    claimed.clear();
+    for(auto i : range(msg.names.size())) {
+        if(searchOp._names[i]._claim) {
+            claimed.push_back(msg.names[i].id);
+            log_debug_printf(serversearch, "Search claimed '%s'\n", msg.names[i].name);
+        }
+    }
+
+    auto pktlen = buildSearchReply(msg.searchID, claimed.data(), claimed.size());
+    if(pktlen)
+        (void)msg.reply(searchReply.data(), pktlen);
+}
+
+size_t Server::Pvt::buildSearchReply(uint32_t searchID, const uint32_t* ids, size_t nids)
+{
     VectorOutBuf M(true, searchReply);
 
     M.skip(8, __FILE__, __LINE__); // fill in header after body length known
 
     _to_wire<12>(M, effective.guid.data(), false, __FILE__, __LINE__);
-    to_wire(M, msg.searchID);
+    to_wire(M, searchID);
     to_wire(M, SockAddr::any(AF_INET));
     to_wire(M, uint16_t(effective.tcp_port));
     to_wire(M, "tcp");
     // "found" flag
-    to_wire(M, uint8_t(nreply!=0 ? 1 : 0));
+    to_wire(M, uint8_t(nids!=0 ? 1 : 0));
 
-    to_wire(M, uint16_t(nreply));
-    for(auto i : range(msg.names.size())) {
-        if(searchOp._names[i]._claim) {
-            to_wire(M, uint32_t(msg.names[i].id));
-            log_debug_printf(serversearch, "Search claimed '%s'\n", msg.names[i].name);
-        }
+    to_wire(M, uint16_t(nids));
+    for(auto i : range(nids)) {
+        to_wire(M, ids[i]);
     }
     auto pktlen = M.save()-searchReply.data();
 
@@ -746,8 +969,55 @@ void Server::Pvt::onSearch(const UDPManager::Search& msg)
 
     if(!M.good() || !H.good()) {
         log_crit_printf(serverio, "Logic error in Search buffer fill\n%s", "");
-    } else {
-        (void)msg.reply(searchReply.data(), pktlen);
+        return 0u;
+    }
+    return pktlen;
+}
+
+void Server::Pvt::sendPendingReply(const pendingKey& key, PendingReply& pending)
+{
+    if(pending.ids.empty() && !pending.mustReply)
+        return; // already sent in full
+
+    auto pktlen = buildSearchReply(key.second, pending.ids.data(), pending.ids.size());
+    if(!pktlen)
+        return;
+
+    log_debug_printf(serverio, "Send held reply -> %s\n", key.first.tostring().c_str());
+
+    // From the socket which received the search, as an immediate reply would be.
+    // Errors are logged by the UDPCollector.
+    (void)pending.reply(searchReply.data(), pktlen);
+}
+
+void Server::Pvt::doSearchHold()
+{
+    auto now(monotonicNS());
+
+    while(!pendingOrder.empty()) {
+        auto it(pendingReplies.find(pendingOrder.front()));
+        assert(it!=pendingReplies.end());
+        if(it->second.deadline > now)
+            break;
+
+        sendPendingReply(it->first, it->second);
+        pendingReplies.erase(it);
+        pendingOrder.pop_front();
+    }
+
+    if(!pendingOrder.empty()) {
+        auto remaining(totv(double(pendingReplies[pendingOrder.front()].deadline - now)*1e-9));
+        if(event_add(searchHoldTimer.get(), &remaining))
+            log_err_printf(serversetup, "Error re-enabling search hold timer\n%s", "");
+    }
+}
+
+void Server::Pvt::doSearchHoldS(evutil_socket_t fd, short evt, void *raw)
+{
+    try {
+        static_cast<Pvt*>(raw)->doSearchHold();
+    }catch(std::exception& e){
+        log_exc_printf(serverio, "Unhandled error in search hold timer callback: %s\n", e.what());
     }
 }
 
@@ -820,6 +1090,114 @@ void Server::Pvt::doBeaconsS(evutil_socket_t fd, short evt, void *raw)
     }
 }
 
+void Server::Pvt::doStats()
+{
+    auto now(monotonicNS());
+    double dT = statsLast ? double(now - statsLast)*1e-9 : 0.0;
+    statsLast = now;
+
+    auto rate = [dT](uint64_t cur, uint64_t prev) -> double {
+        // counters may have been zero'd by Server::report()
+        auto delta = cur>=prev ? cur-prev : cur;
+        return dT>0.0 ? double(delta)/dT : 0.0;
+    };
+
+    const size_t nrow = connections.size()+1u;
+    shared_array<std::string> peer(nrow);
+    shared_array<uint64_t> nchan(nrow), nget(nrow), nput(nrow), nrpc(nrow), nmon(nrow), ninfo(nrow),
+            queued(nrow), squashed(nrow), backlog(nrow), txBytes(nrow), rxBytes(nrow);
+    shared_array<double> txRate(nrow), rxRate(nrow);
+
+    const size_t last = nrow-1u;
+    peer[last] = "*";
+    nchan[last] = nget[last] = nput[last] = nrpc[last] = nmon[last] = ninfo[last] = 0u;
+    queued[last] = squashed[last] = backlog[last] = txBytes[last] = rxBytes[last] = 0u;
+    txRate[last] = rxRate[last] = 0.0;
+
+    size_t i=0u;
+    for(auto& pair : connections) {
+        auto conn = pair.first;
+
+        ServerOp::Stats ops;
+        for(auto& pair : conn->opByIOID) {
+            if(pair.second)
+                pair.second->stats(ops);
+        }
+
+        peer[i] = conn->peerName;
+        nchan[last] += nchan[i] = conn->chanBySID.size();
+        nget[last] += nget[i] = ops.nget;
+        nput[last] += nput[i] = ops.nput;
+        nrpc[last] += nrpc[i] = ops.nrpc;
+        nmon[last] += nmon[i] = ops.nmonitor;
+        ninfo[last] += ninfo[i] = ops.ninfo;
+        queued[last] += queued[i] = ops.monQueue;
+        squashed[last] += squashed[i] = ops.monSquash;
+        backlog[last] += backlog[i] = conn->backlog.size();
+        txBytes[last] += txBytes[i] = conn->statTx;
+        rxBytes[last] += rxBytes[i] = conn->statRx;
+        txRate[last] += txRate[i] = rate(conn->statTx, conn->statsPrevTx);
+        rxRate[last] += rxRate[i] = rate(conn->statRx, conn->statsPrevRx);
+        conn->statsPrevTx = conn->statTx;
+        conn->statsPrevRx = conn->statRx;
+        i++;
+    }
+
+    auto val(statsProto.cloneEmpty());
+    val["value.peer"] = peer.freeze();
+    val["value.channels"] = nchan.freeze();
+    val["value.get"] = nget.freeze();
+    val["value.put"] = nput.freeze();
+    val["value.rpc"] = nrpc.freeze();
+    val["value.monitor"] = nmon.freeze();
+    val["value.info"] = ninfo.freeze();
+    val["value.queued"] = queued.freeze();
+    val["value.squashed"] = squashed.freeze();
+    val["value.backlog"] = backlog.freeze();
+    val["value.txBytes"] = txBytes.freeze();
+    val["value.rxBytes"] = rxBytes.freeze();
+    val["value.txRate"] = txRate.freeze();
+    val["value.rxRate"] = rxRate.freeze();
+
+    {
+        uint64_t search = statSearch, claim = statClaim;
+        val["searchRate"] = rate(search, statsPrevSearch);
+        val["claimRate"] = rate(claim, statsPrevClaim);
+        statsPrevSearch = search;
+        statsPrevClaim = claim;
+    }
+
+    {
+        auto snap(instanceSnapshot());
+        shared_array<std::string> names(snap.size());
+        shared_array<uint64_t> counts(snap.size());
+        size_t n=0u;
+        for(auto& pair : snap) {
+            names[n] = pair.first;
+            counts[n] = pair.second;
+            n++;
+        }
+        val["instances.name"] = names.freeze();
+        val["instances.count"] = counts.freeze();
+    }
+
+    epicsTimeStamp ts;
+    epicsTimeGetCurrent(&ts);
+    val["timeStamp.secondsPastEpoch"] = ts.secPastEpoch + POSIX_TIME_AT_EPICS_EPOCH;
+    val["timeStamp.nanoseconds"] = ts.nsec;
+
+    statsPV.post(val);
+}
+
+void Server::Pvt::doStatsS(evutil_socket_t fd, short evt, void *raw)
+{
+    try {
+        static_cast<Pvt*>(raw)->doStats();
+    }catch(std::exception& e){
+        log_exc_printf(serverio, "Unhandled error in stats timer callback: %s\n", e.what());
+    }
+}
+
 Source::~Source() {}
 
 Source::List Source::onList() {
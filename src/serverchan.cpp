@@ -4,6 +4,7 @@
  * in file LICENSE that is included with this distribution.
  */
 
+#include <algorithm>
 #include <stdexcept>
 #include <cassert>
 
@@ -19,6 +20,9 @@ DEFINE_LOGGER(connio, "pvxs.tcp.io");
 
 DEFINE_LOGGER(serversearch, "pvxs.server.search");
 
+// limit on names claimed in one TCP search reply.  32KB
+static constexpr size_t maxTCPSearchReplyIDs = 8192u;
+
 ServerChan::ServerChan(const std::shared_ptr<ServerConn> &conn,
                        uint32_t sid,
                        uint32_t cid,
@@ -194,16 +198,19 @@ void ServerConn::handle_SEARCH()
     uint16_t nchan=0;
     from_wire(M, nchan);
 
-    server::Source::Search op;
+    // re-use storage between requests.  Name servers may see many.
+    auto& op = searchOp;
     strncpy(op._src, peerName.c_str(), sizeof(op._src)-1);
     op._src[sizeof(op._src)-1] = '\0';
-    std::vector<std::pair<uint32_t, std::string>> nameStorage(nchan);
+    if(searchNames.size() < nchan)
+        searchNames.resize(nchan);
     op._names.resize(nchan);
 
     for(auto n : range(nchan)) {
-        from_wire(M, nameStorage[n].first);
-        from_wire(M, nameStorage[n].second);
-        op._names[n]._name = nameStorage[n].second.c_str();
+        from_wire(M, searchNames[n].first);
+        from_wire(M, searchNames[n].second);
+        op._names[n]._name = searchNames[n].second.c_str();
+        op._names[n]._claim = false;
     }
 
     if(!M.good())
@@ -221,7 +228,7 @@ void ServerConn::handle_SEARCH()
         }
     }
 
-    uint16_t nreply = 0;
+    size_t nreply = 0;
     for(const auto& name : op._names) {
         if(name._claim)
             nreply++;
@@ -230,29 +237,38 @@ void ServerConn::handle_SEARCH()
     if(nreply==0 && !mustReply)
         return;
 
-    {
+    // Split large replies so that one large search does not delay other traffic.
+    size_t next = 0u;
+    do {
+        const auto count = std::min(nreply, maxTCPSearchReplyIDs);
+        nreply -= count;
+
         (void)evbuffer_drain(txBody.get(), evbuffer_get_length(txBody.get()));
 
-        EvOutBuf R(sendBE, txBody.get());
-
-        _to_wire<12>(R, iface->server->effective.guid.data(), false, __FILE__, __LINE__);
-        to_wire(R, searchID);
-        to_wire(R, SockAddr::any(AF_INET));
-        to_wire(R, iface->bind_addr.port());
-        to_wire(R, "tcp");
-        // "found" flag
-        to_wire(R, uint8_t(nreply!=0 ? 1 : 0));
-
-        to_wire(R, uint16_t(nreply));
-        for(auto i : range(op._names.size())) {
-            if(op._names[i]._claim) {
-                to_wire(R, uint32_t(nameStorage[i].first));
-                log_debug_printf(serversearch, "Search claimed '%s'\n", op._names[i]._name);
+        {
+            // 12 GUID + 4 searchID + 16 address + 2 port + 4 "tcp" + 1 found + 2 count
+            EvOutBuf R(sendBE, txBody.get(), 41u + 4u*count);
+
+            _to_wire<12>(R, iface->server->effective.guid.data(), false, __FILE__, __LINE__);
+            to_wire(R, searchID);
+            to_wire(R, SockAddr::any(AF_INET));
+            to_wire(R, iface->bind_addr.port());
+            to_wire(R, "tcp");
+            // "found" flag
+            to_wire(R, uint8_t(count!=0 ? 1 : 0));
+
+            to_wire(R, uint16_t(count));
+            for(size_t found = 0u; found < count; next++) {
+                if(op._names[next]._claim) {
+                    to_wire(R, uint32_t(searchNames[next].first));
+                    log_debug_printf(serversearch, "Search claimed '%s'\n", op._names[next]._name);
+                    found++;
+                }
             }
         }
-    }
 
-    enqueueTxBody(CMD_SEARCH_RESPONSE);
+        enqueueTxBody(CMD_SEARCH_RESPONSE);
+    } while(nreply);
 }
 
 void ServerConn::handle_CREATE_CHANNEL()
@@ -15,6 +15,11 @@
 #include <pvxs/log.h>
 #include "serverconn.h"
 
+#ifdef PVXS_HAVE_AF_UNIX
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
 // limit on size of TX buffer above which we suspend RX.
 // defined as multiple of OS socket TX buffer size
 static constexpr size_t tcp_tx_limit_mult = 2u;
@@ -33,7 +38,7 @@ DEFINE_INST_COUNTER2(Server::Pvt, ServerPvt);
 std::set<std::string> ClientCredentials::roles() const
 {
     std::set<std::string> ret;
-    osdGetRoles(account, ret);
+    roleCacheGet(account, ret);
     return ret;
 }
 
@@ -53,16 +58,60 @@ DEFINE_LOGGER(connio, "pvxs.tcp.io");
 
 DEFINE_LOGGER(remote, "pvxs.remote.log");
 
+namespace {
+SockAddr peerOf(const ServIface* iface, const sockaddr *peer, int socklen)
+{
+    // local socket clients are usually unnamed.  Identify by the listening path instead.
+    if(iface->bind_addr.family()==AF_UNIX)
+        return iface->bind_addr;
+    return SockAddr(peer, socklen);
+}
+
+// Distinguish local socket clients by process.  eg. "unix:/run/ioc.sock,pid=1234,uid=1000"
+std::string peerNameOf(const ServIface* iface, evutil_socket_t sock)
+{
+    int64_t pid, uid;
+    if(iface->bind_addr.family()!=AF_UNIX || !evsocket::peer_credentials(sock, pid, uid))
+        return std::string();
+    return SB()<<iface->bind_addr<<",pid="<<pid<<",uid="<<uid;
+}
+
+// remove a local socket left behind by an exited process.
+// Never a socket with a listener, or any other kind of file.
+bool unlinkStale(const SockAddr& addr)
+{
+#ifdef PVXS_HAVE_AF_UNIX
+    auto path(addr.path());
+    struct stat info;
+    if(lstat(path.c_str(), &info)!=0 || !S_ISSOCK(info.st_mode))
+        return false;
+
+    evsocket probe(AF_UNIX, SOCK_STREAM, 0, true);
+    if(connect(probe.sock, &addr->sa, addr.size())==0 || SOCKERRNO!=SOCK_ECONNREFUSED)
+        return false; // in use
+
+    log_debug_printf(connsetup, "Remove stale %s\n", addr.tostring().c_str());
+    return unlink(path.c_str())==0;
+#else
+    (void)addr;
+    return false;
+#endif
+}
+} // namespace
+
 ServerConn::ServerConn(ServIface* iface, evutil_socket_t sock, struct sockaddr *peer, int socklen)
     :ConnBase(false, iface->server->effective.sendBE(),
-              bufferevent_socket_new(iface->server->acceptor_loop.base, sock, BEV_OPT_CLOSE_ON_FREE|BEV_OPT_DEFER_CALLBACKS),
-              SockAddr(peer))
+              ConnBev::create(iface->server->acceptor_loop, sock),
+              peerOf(iface, peer, socklen), peerNameOf(iface, sock))
     ,iface(iface)
     ,tcp_tx_limit(evsocket::get_buffer_size(sock, true) * tcp_tx_limit_mult)
 {
+    if(peerAddr.family()==AF_UNIX && !evsocket::peer_credentials(sock, peerPID, peerUID))
+        peerPID = peerUID = -1;
+
     log_debug_printf(connio, "Client %s connects, RX readahead %zu TX limit %zu\n",
                      peerName.c_str(), readahead, tcp_tx_limit);
-    {
+    if(peerAddr.family()!=AF_UNIX) {
         int opt = 1;
         if(setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (char*)&opt, sizeof(opt))<0) {
             auto err(SOCKERRNO);
@@ -81,6 +130,11 @@ ServerConn::ServerConn(ServIface* iface, evutil_socket_t sock, struct sockaddr *
 
     bufferevent_setcb(bev.get(), &bevReadS, &bevWriteS, &bevEventS, this);
 
+    if(iface->server->effective.latencyStats) {
+        if(!evbuffer_add_cb(bufferevent_get_output(bev.get()), &txDrainS, this))
+            throw BAD_ALLOC();
+    }
+
     timeval tmo(totv(iface->server->effective.tcpTimeout));
     bufferevent_set_timeouts(bev.get(), &tmo, &tmo);
 
@@ -102,11 +156,19 @@ ServerConn::ServerConn(ServIface* iface, evutil_socket_t sock, struct sockaddr *
         // serverIntrospectionRegistryMaxSize, also not used
         to_wire(M, uint16_t(0x7fff));
 
+        const bool offerShm = iface->server->effective.shmSize && peerAddr.family()==AF_UNIX && sendBE==hostBE;
+        const bool offerZip = iface->server->effective.compressThreshold;
+
         /* list given in reverse order of priority.
          * Old pvAccess* was missing a "break" when looping,
          * so it took the last known plugin.
          */
-        to_wire(M, Size{2});
+        to_wire(M, Size{3u + (offerShm ? 1u : 0u) + (offerZip ? 1u : 0u)});
+        if(offerShm) // not an auth. method.  Ignored by other implementations.  cf. shm.h
+            to_wire(M, "x-pvxs-shm");
+        if(offerZip) // also not an auth. method.  cf. zip.h
+            to_wire(M, "x-pvxs-zip");
+        to_wire(M, "x-pvxs-pipeline"); // also not an auth. method.  cf. conn.h
         to_wire(M, "anonymous");
         to_wire(M, "ca");
         auto bend = M.save();
@@ -140,6 +202,46 @@ const std::shared_ptr<ServerChan>& ServerConn::lookupSID(uint32_t sid)
     return it->second;
 }
 
+void ServerConn::notePosted(ServerChan& chan, uint64_t posted)
+{
+    auto now = monotonicNS();
+    auto delta = now - posted;
+    chan.latency.queue.sample(delta);
+    latency.queue.sample(delta);
+    iface->server->latency.queue.sample(delta);
+
+    // TX is complete after everything now in the output buffer has been sent
+    if(bev) {
+        auto tx = bufferevent_get_output(bev.get());
+        txMarks.push_back(TxMark{txSent + evbuffer_get_length(tx), posted, chan.sid});
+    }
+}
+
+void ServerConn::txDrainS(struct evbuffer *buf, const struct evbuffer_cb_info *info, void *raw)
+{
+    auto self = static_cast<ServerConn*>(raw);
+    if(!info->n_deleted)
+        return; // only interested in bytes removed, by writing to the socket
+
+    self->txSent += info->n_deleted;
+
+    if(self->txMarks.empty())
+        return;
+
+    auto now = monotonicNS();
+    while(!self->txMarks.empty() && self->txMarks.front().end <= self->txSent) {
+        const auto& mark = self->txMarks.front();
+        auto delta = now - mark.posted;
+
+        self->latency.send.sample(delta);
+        self->iface->server->latency.send.sample(delta);
+        if(auto& chan = self->lookupSID(mark.sid))
+            chan->latency.send.sample(delta);
+
+        self->txMarks.pop_front();
+    }
+}
+
 void ServerConn::handle_ECHO()
 {
     // Client requests echo as a keep-alive check
@@ -206,8 +308,22 @@ void ServerConn::handle_CONNECTION_VALIDATION()
                     C->account = user;
                 });
             }
+            if(peerUID>=0) {
+                // local socket.  The peer process user is known, so ignore any claim.
+                std::string account;
+                if(!osdGetAccount(peerUID, account))
+                    account = SB()<<peerUID;
+                if(selected=="ca" && C->account!=account)
+                    log_debug_printf(connsetup, "Client %s claims account \"%s\", is \"%s\"\n",
+                                     peerName.c_str(), C->account.c_str(), account.c_str());
+                C->method = "ca";
+                C->account = account;
+            }
             if(C->method.empty()) {
                 C->account = C->method = "anonymous";
+            } else {
+                // begin lookup now.  Likely to be needed for the first PUT.
+                roleCachePrefetch(C->account);
             }
             C->raw = auth;
 
@@ -231,6 +347,68 @@ void ServerConn::handle_CONNECTION_VALIDATION()
     auth_complete(this, Status{Status::Ok});
 }
 
+void ServerConn::handle_PVXS_SHM()
+{
+    EvInBuf M(peerBE, segBuf.get(), 16);
+
+    uint8_t op = 0xff;
+    from_wire(M, op);
+    if(!M.good()) {
+        log_err_printf(connio, "%s:%d Client %s Invalid PVXS_SHM\n",
+                       M.file(), M.line(), peerName.c_str());
+        bev.reset();
+        return;
+    }
+
+    const auto size = iface->server->effective.shmSize;
+
+    if(op==ShmSegment::ShmRequest && size && !shm && !shmPending && peerAddr.family()==AF_UNIX && sendBE==hostBE) {
+        shmPending = ShmSegment::create(size);
+        if(!shmPending)
+            return; // client will continue without
+
+        (void)evbuffer_drain(txBody.get(), evbuffer_get_length(txBody.get()));
+        {
+            EvOutBuf R(sendBE, txBody.get());
+            to_wire(R, uint8_t(ShmSegment::ShmOffer));
+            to_wire(R, shmPending->path);
+            to_wire(R, uint64_t(size));
+        }
+        enqueueTxBody(CMD_PVXS_SHM);
+
+    } else if(op==ShmSegment::ShmAccept && shmPending) {
+        shm = std::move(shmPending);
+        log_debug_printf(connsetup, "Client %s accepts shared memory %s\n", peerName.c_str(), shm->path.c_str());
+
+    } else {
+        log_debug_printf(connsetup, "Client %s ignore PVXS_SHM %u\n", peerName.c_str(), op);
+    }
+}
+
+void ServerConn::handle_PVXS_ZIP()
+{
+    EvInBuf M(peerBE, segBuf.get(), 16);
+
+    uint8_t op = 0xff;
+    from_wire(M, op);
+    if(!M.good()) {
+        log_err_printf(connio, "%s:%d Client %s Invalid PVXS_ZIP\n",
+                       M.file(), M.line(), peerName.c_str());
+        bev.reset();
+        return;
+    }
+
+    const auto& conf = iface->server->effective;
+
+    if(op==ZipEncoder::ZipRequest && conf.compressThreshold && !zipTx) {
+        zipTx.reset(new ZipEncoder(conf.compressThreshold, conf.compressBudget));
+        log_debug_printf(connsetup, "Client %s accepts compression\n", peerName.c_str());
+
+    } else {
+        log_debug_printf(connsetup, "Client %s ignore PVXS_ZIP %u\n", peerName.c_str(), op);
+    }
+}
+
 void ServerConn::handle_AUTHNZ()
 {
     // ignored (so far no auth plugin actually uses)
@@ -298,6 +476,17 @@ void ServerConn::handle_DESTROY_REQUEST()
         opByIOID.erase(it);
         op->cleanup();
     }
+
+    if(shm) {
+        // replies with this IOID are already queued before this.  cf. ShmSegment::ShmDestroyed
+        (void)evbuffer_drain(txBody.get(), evbuffer_get_length(txBody.get()));
+        {
+            EvOutBuf R(sendBE, txBody.get());
+            to_wire(R, uint8_t(ShmSegment::ShmDestroyed));
+            to_wire(R, ioid);
+        }
+        enqueueTxBody(CMD_PVXS_SHM);
+    }
 }
 
 void ServerConn::handle_MESSAGE()
@@ -408,12 +597,16 @@ ServIface::ServIface(const SockAddr &addr, server::Server::Pvt *server, bool fal
     server->acceptor_loop.assertInLoop();
     auto orig_port = bind_addr.port();
 
+    bool staleChecked = false;
+    if(bind_addr.family()==AF_UNIX)
+        fallback = false; // no port to fall back to
+
     // try to bind to requested port, then fallback to a random port
     while(true) {
 
         sock = evsocket(bind_addr.family(), SOCK_STREAM, 0);
 
-        if(evutil_make_listen_socket_reuseable(sock.sock))
+        if(bind_addr.family()!=AF_UNIX && evutil_make_listen_socket_reuseable(sock.sock))
             log_warn_printf(connsetup, "Unable to make socket reusable%s", "\n");
 
         try {
@@ -438,6 +631,11 @@ ServIface::ServIface(const SockAddr &addr, server::Server::Pvt *server, bool fal
                 evconnlistener_disable(listener.get());
 
         } catch(std::system_error& e) {
+            if(bind_addr.family()==AF_UNIX && e.code().value()==SOCK_EADDRINUSE && !staleChecked) {
+                staleChecked = true;
+                if(unlinkStale(bind_addr))
+                    continue;
+            }
             if(fallback && (e.code().value()==SOCK_EADDRINUSE || e.code().value()==SOCK_EACCES)) {
                 log_debug_printf(connsetup, "Address %s in use or not permitted: %s\n",
                                  bind_addr.tostring().c_str(),
@@ -462,6 +660,14 @@ ServIface::ServIface(const SockAddr &addr, server::Server::Pvt *server, bool fal
     }
 }
 
+ServIface::~ServIface()
+{
+#ifdef PVXS_HAVE_AF_UNIX
+    if(bind_addr.family()==AF_UNIX && sock.sock!=evutil_socket_t(-1))
+        (void)unlink(bind_addr.path().c_str());
+#endif
+}
+
 void ServIface::onConnS(struct evconnlistener *listener, evutil_socket_t sock, struct sockaddr *peer, int socklen, void *raw)
 {
     auto self = static_cast<ServIface*>(raw);
@@ -8,6 +8,7 @@
 #define SERVERCONN_H
 
 #include <list>
+#include <deque>
 #include <map>
 #include <memory>
 #include <atomic>
@@ -55,6 +56,14 @@ struct ServerOp
     // do any cleanup which must be done from that worker.
     virtual void cleanup();
     virtual void show(std::ostream& strm) const =0;
+
+    // counters for Config::statsPV
+    struct Stats {
+        uint64_t nget{}, nput{}, nrpc{}, nmonitor{}, ninfo{};
+        uint64_t monQueue{}, monSquash{};
+    };
+    // called from tcp worker.  accumulate into stats
+    virtual void stats(Stats& stats) const =0;
 };
 
 struct ServerChannelControl : public server::ChannelControl
@@ -91,6 +100,7 @@ struct ServerChan
     } state;
 
     size_t statTx{}, statRx{};
+    Report::Latency latency;
     std::shared_ptr<const ReportInfo> reportInfo;
 
     std::function<void(std::unique_ptr<server::ConnectOp>&&)> onOp;
@@ -114,6 +124,8 @@ struct ServerConn final : public ConnBase, public std::enable_shared_from_this<S
 {
     ServIface* const iface;
     const size_t tcp_tx_limit;
+    // process and user of a local (AF_UNIX) socket peer, from the OS.  Otherwise -1
+    int64_t peerPID = -1, peerUID = -1;
 
     std::shared_ptr<const server::ClientCredentials> cred;
 
@@ -123,6 +135,26 @@ struct ServerConn final : public ConnBase, public std::enable_shared_from_this<S
 
     std::list<std::function<void()>> backlog;
 
+    // monitor update latency tracking.  cf. Config::latencyStats
+    Report::Latency latency;
+    struct TxMark {
+        uint64_t end;    // value of txSent after this message is written
+        uint64_t posted; // monotonicNS() of post()
+        uint32_t sid;
+    };
+    std::deque<TxMark> txMarks;
+    uint64_t txSent = 0u; // cumulative bytes handed to OS
+
+    // offered, but not yet accepted.  cf. Config::shmSize
+    std::shared_ptr<ShmSegment> shmPending;
+
+    // statTx and statRx at previous Server::Pvt::doStats()
+    size_t statsPrevTx{}, statsPrevRx{};
+
+    // properly locals of handle_SEARCH().  Re-used to avoid allocations.
+    server::Source::Search searchOp;
+    std::vector<std::pair<uint32_t, std::string>> searchNames;
+
     INST_COUNTER(ServerConn);
 
     ServerConn(ServIface* iface, evutil_socket_t sock, struct sockaddr *peer, int socklen);
@@ -132,6 +164,9 @@ struct ServerConn final : public ConnBase, public std::enable_shared_from_this<S
 
     const std::shared_ptr<ServerChan>& lookupSID(uint32_t sid);
 
+    // Record latency of a monitor update which has just been enqueued.
+    void notePosted(ServerChan& chan, uint64_t posted);
+
 private:
 #define CASE(Op) virtual void handle_##Op() override final;
     CASE(ECHO);
@@ -152,6 +187,9 @@ private:
     CASE(GET_FIELD);
 
     CASE(MESSAGE);
+
+    CASE(PVXS_SHM);
+    CASE(PVXS_ZIP);
 #undef CASE
 
     void handle_GPR(pva_app_msg_t cmd);
@@ -163,6 +201,7 @@ private:
     //void bevEvent(short events);
     virtual void bevRead() override final;
     virtual void bevWrite() override final;
+    static void txDrainS(struct evbuffer *buf, const struct evbuffer_cb_info *info, void *raw);
 };
 
 struct ServIface
@@ -176,6 +215,7 @@ struct ServIface
     evlisten listener;
 
     ServIface(const SockAddr &addr, server::Server::Pvt *server, bool fallback);
+    ~ServIface();
 
     static void onConnS(struct evconnlistener *listener, evutil_socket_t sock, struct sockaddr *peer, int socklen, void *raw);
 };
@@ -188,6 +228,7 @@ struct ServerSource : public server::Source
     server::Server::Pvt* const serv;
 
     const Value info;
+    const Value latency;
 
     INST_COUNTER(ServerSource);
 
@@ -234,6 +275,34 @@ struct Server::Pvt
     evevent beaconTimer;
 
     std::vector<uint8_t> searchReply;
+    std::vector<uint32_t> claimed; // local of onSearch() on UDP worker
+
+    // cf. Config::searchReplyHold.  Access from UDP worker
+    struct PendingReply {
+        // sends from the socket which received the search.  cf. UDPManager::Search::deferReply()
+        std::function<bool(const void *msg, size_t msglen)> reply;
+        std::vector<uint32_t> ids;
+        uint64_t deadline; // monotonicNS()
+        bool mustReply = false;
+    };
+    typedef std::pair<SockAddr, uint32_t> pendingKey; // client and searchID
+    std::map<pendingKey, PendingReply> pendingReplies;
+    std::deque<pendingKey> pendingOrder; // ascending deadline
+    evbase udpLoop;
+    evevent searchHoldTimer;
+
+    // cf. Config::latencyStats.  Access from acceptor_loop worker
+    Report::Latency latency;
+
+    // cf. Config::statsPV
+    // names searched for, and claimed.  Updated from UDP worker
+    std::atomic<uint64_t> statSearch{0u}, statClaim{0u};
+    // Access from acceptor_loop worker
+    const Value statsProto;
+    SharedPV statsPV;
+    evevent statsTimer;
+    uint64_t statsLast = 0u; // monotonicNS() of previous doStats()
+    uint64_t statsPrevSearch = 0u, statsPrevClaim = 0u;
 
     // properly a local of Pvt::onSearch() on the UDP worker.
     // made a member to avoid re-alloc of _names vector.
@@ -241,7 +310,7 @@ struct Server::Pvt
 
     StaticSource builtinsrc;
 
-    RWLock sourcesLock;
+    RWLock sourcesLock{"sourcesLock"};
     std::map<std::pair<int, std::string>, std::shared_ptr<Source> > sources;
 
     enum state_t {
@@ -261,8 +330,14 @@ struct Server::Pvt
 
 private:
     void onSearch(const UDPManager::Search& msg);
+    size_t buildSearchReply(uint32_t searchID, const uint32_t* ids, size_t nids);
+    void sendPendingReply(const pendingKey& key, PendingReply& pending);
+    void doSearchHold();
+    static void doSearchHoldS(evutil_socket_t fd, short evt, void *raw);
     void doBeacons(short evt);
     static void doBeaconsS(evutil_socket_t fd, short evt, void *raw);
+    void doStats();
+    static void doStatsS(evutil_socket_t fd, short evt, void *raw);
 };
 
 }} // namespace pvxs::server
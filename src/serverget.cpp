@@ -5,6 +5,7 @@
  */
 
 #include <cassert>
+#include <deque>
 
 #include <pvxs/log.h>
 #include "dataimpl.h"
@@ -26,6 +27,9 @@ cmd2op(pva_app_msg_t cmd){
     }
 }
 
+struct ServerGPR;
+void execGPR(ServerConn* conn, const std::shared_ptr<ServerGPR>& op, uint8_t subcmd, Value&& val);
+
 // generalized Get/Put/RPC
 struct ServerGPR final : public ServerOp
 {
@@ -79,6 +83,7 @@ struct ServerGPR final : public ServerOp
             (void)evbuffer_drain(conn->txBody.get(), evbuffer_get_length(conn->txBody.get()));
 
             EvOutBuf R(conn->sendBE, conn->txBody.get());
+            R.shm = conn->shm.get();
             to_wire(R, uint32_t(ioid));
             to_wire(R, subcmd);
             to_wire(R, sts);
@@ -120,6 +125,16 @@ struct ServerGPR final : public ServerOp
 
         if(state == ServerOp::Dead) {
             cleanup();
+
+        } else if(state == ServerOp::Idle && !backlog.empty()) {
+            // begin next pipelined EXEC
+            auto it(conn->opByIOID.find(ioid));
+            if(it!=conn->opByIOID.end() && it->second.get()==this) {
+                auto next(std::move(backlog.front()));
+                backlog.pop_front();
+                execGPR(conn.get(), std::static_pointer_cast<ServerGPR>(it->second),
+                        next.first, std::move(next.second));
+            }
         }
     }
 
@@ -128,6 +143,7 @@ struct ServerGPR final : public ServerOp
         ServerOp::cleanup();
         onPut = nullptr;
         onGet = nullptr;
+        backlog.clear();
     }
 
     void show(std::ostream& strm) const override final
@@ -145,6 +161,16 @@ struct ServerGPR final : public ServerOp
         }
     }
 
+    void stats(Stats& stats) const override final
+    {
+        switch(cmd) {
+        case CMD_GET: stats.nget++; break;
+        case CMD_PUT: stats.nput++; break;
+        case CMD_RPC: stats.nrpc++; break;
+        default: break;
+        }
+    }
+
     pva_app_msg_t cmd = pva_app_msg_t(-1); //spoil
     uint8_t subcmd = 0u; // valid when state==Executing or Creating
     bool lastRequest=false;
@@ -157,6 +183,9 @@ struct ServerGPR final : public ServerOp
 
     std::function<void(std::unique_ptr<server::ExecOp>&&)> onGet;
 
+    // EXEC requests received while Executing.  subcmd and PUT/RPC value.  cf. maxPipelineExec
+    std::deque<std::pair<uint8_t, Value>> backlog;
+
     INST_COUNTER(ServerGPR);
 };
 DEFINE_INST_COUNTER(ServerGPR);
@@ -331,6 +360,58 @@ struct ServerGPRExec : public server::ExecOp
 };
 DEFINE_INST_COUNTER(ServerGPRExec);
 
+void execGPR(ServerConn* conn, const std::shared_ptr<ServerGPR>& op, uint8_t subcmd, Value&& val)
+{
+    auto chan = op->chan.lock();
+    if(!chan)
+        throw std::logic_error("live op on dead channel");
+
+    const auto cmd = op->cmd;
+    const bool isput = cmd!=CMD_GET && !(subcmd&0x40);
+    const auto& peerName = conn->peerName;
+
+    if(!op->lastRequest)
+        op->lastRequest = subcmd&0x10;
+
+    std::unique_ptr<ServerGPRExec> ctrl{new ServerGPRExec(conn, cmd, conn->iface->server->internal_self, chan->name, op)};
+
+    op->subcmd = subcmd;
+    op->state = ServerOp::Executing;
+
+    log_debug_printf(connsetup, "Client %s op%x executing %s\n",
+                     peerName.c_str(), cmd, chan->name.c_str());
+
+    try {
+        if(cmd==CMD_RPC && isput) {
+            if(chan->onRPC)
+                chan->onRPC(std::move(ctrl), std::move(val));
+            else
+                ctrl->error("RPC Not Implemented");
+
+        } else if(cmd==CMD_PUT && isput) {
+            if(op->onPut)
+                op->onPut(std::move(ctrl), std::move(val));
+            else
+                ctrl->error("PUT Not Implemented");
+
+        } else if(cmd!=CMD_RPC && !isput) {
+            if(op->onGet)
+                op->onGet(std::move(ctrl));
+            else
+                ctrl->error("GET Not Implemented");
+
+        } else {
+            log_err_printf(connsetup, "Client %s Get exec in incorrect command %d\n",
+                       peerName.c_str(), subcmd);
+        }
+    } catch(std::exception& e) {
+        log_err_printf(connsetup, "Client %s Unhandled exception in onGet/Put/RPC %s : %s\n",
+                   peerName.c_str(), typeid(e).name(), e.what());
+        if(ctrl)
+            ctrl->error(e.what());
+    }
+}
+
 } // namespace
 
 void ServerConn::handle_GPR(pva_app_msg_t cmd)
@@ -455,47 +536,20 @@ void ServerConn::handle_GPR(pva_app_msg_t cmd)
 
         if(op->state==ServerOp::Idle) {
             // all set
+            if(!op->backlog.empty()) {
+                // left after CANCEL_REQUEST.  Preserve order.
+                op->backlog.emplace_back(subcmd, std::move(val));
+                subcmd = op->backlog.front().first;
+                val = std::move(op->backlog.front().second);
+                op->backlog.pop_front();
+            }
+            execGPR(this, op, subcmd, std::move(val));
 
-            if(!op->lastRequest)
-                op->lastRequest = subcmd&0x10;
-
-            std::unique_ptr<ServerGPRExec> ctrl{new ServerGPRExec(this, cmd, iface->server->internal_self, chan->name, op)};
-
-            op->subcmd = subcmd;
-            op->state = ServerOp::Executing;
-
-            log_debug_printf(connsetup, "Client %s op%x executing %s\n",
+        } else if(op->state==ServerOp::Executing && op->backlog.size() < maxPipelineExec) {
+            // pipelined.  cf. maxPipelineExec
+            log_debug_printf(connsetup, "Client %s op%x queue exec %s\n",
                              peerName.c_str(), cmd, chan->name.c_str());
-
-            try {
-                if(cmd==CMD_RPC && isput) {
-                    if(chan->onRPC)
-                        chan->onRPC(std::move(ctrl), std::move(val));
-                    else
-                        ctrl->error("RPC Not Implemented");
-
-                } else if(cmd==CMD_PUT && isput) {
-                    if(op->onPut)
-                        op->onPut(std::move(ctrl), std::move(val));
-                    else
-                        ctrl->error("PUT Not Implemented");
-
-                } else if(cmd!=CMD_RPC && !isput) {
-                    if(op->onGet)
-                        op->onGet(std::move(ctrl));
-                    else
-                        ctrl->error("GET Not Implemented");
-
-                } else {
-                    log_err_printf(connsetup, "Client %s Get exec in incorrect command %d\n",
-                               peerName.c_str(), subcmd);
-                }
-            } catch(std::exception& e) {
-                log_err_printf(connsetup, "Client %s Unhandled exception in onGet/Put/RPC %s : %s\n",
-                           peerName.c_str(), typeid(e).name(), e.what());
-                if(ctrl)
-                    ctrl->error(e.what());
-            }
+            op->backlog.emplace_back(subcmd, std::move(val));
 
         } else {
             log_err_printf(connsetup, "CLient %s Get exec in incorrect state %d\n",
@@ -54,6 +54,11 @@ struct ServerIntrospect final : public ServerOp
         strm<<"INFO\n";
     }
 
+    void stats(Stats& stats) const override final
+    {
+        stats.ninfo++;
+    }
+
     INST_COUNTER(ServerIntrospect);
 };
 DEFINE_INST_COUNTER(ServerIntrospect);
@@ -22,7 +22,7 @@ DEFINE_LOGGER(connio, "pvxs.tcp.io");
 
 namespace {
 
-typedef epicsGuard<epicsMutex> Guard;
+typedef epicsGuard<ProfiledMutex> Guard;
 
 struct MonitorOp final : public ServerOp
 {
@@ -54,11 +54,12 @@ struct MonitorOp final : public ServerOp
     std::string msg;
 
     // Further members guarded by this lock (except as noted)
-    mutable epicsMutex lock;
+    mutable ProfiledMutex lock{"MonitorOp"};
 
     // is doReply() scheduled to run
     bool scheduled=false;
     bool pipeline=false; // const after setup
+    bool timed=false; // const after setup.  cf. Config::latencyStats
     // finish() called
     bool finished=false;
     size_t window=0u, limit=4u;
@@ -66,8 +67,15 @@ struct MonitorOp final : public ServerOp
     size_t ackAt=1u;
     size_t maxQueue=0u;
     size_t nSquash=0u;
+    size_t totalSquash=0u; // not reset by MonitorControlOp::stats()
 
-    std::deque<Value> queue;
+    struct Update {
+        Value val;
+        // monotonicNS() when post()'d, or zero if not timed
+        uint64_t posted;
+        Update(const Value& val, uint64_t posted) :val(val), posted(posted) {}
+    };
+    std::deque<Update> queue;
 
     INST_COUNTER(MonitorOp);
 
@@ -126,6 +134,7 @@ struct MonitorOp final : public ServerOp
             return;
 
         uint8_t subcmd = 0u;
+        uint64_t posted = 0u;
         if(self->state==Creating) {
             subcmd = 0x08;
             self->state = self->type ? Idle : Dead;
@@ -136,7 +145,7 @@ struct MonitorOp final : public ServerOp
                                  conn->peerName.c_str(), unsigned(self->ioid));
                 return; // nothing to do
 
-            } else if(!self->queue.front()) {
+            } else if(!self->queue.front().val) {
                 subcmd = 0x10;
                 self->state = Dead;
                 log_debug_printf(connio, "Client %s IOID %u finishes\n",
@@ -148,6 +157,7 @@ struct MonitorOp final : public ServerOp
             (void)evbuffer_drain(conn->txBody.get(), evbuffer_get_length(conn->txBody.get()));
 
             EvOutBuf R(conn->sendBE, conn->txBody.get());
+            R.shm = conn->shm.get();
             to_wire(R, uint32_t(self->ioid));
             to_wire(R, subcmd);
             if(subcmd&0x08) {
@@ -161,8 +171,8 @@ struct MonitorOp final : public ServerOp
 
             } else if(!self->queue.empty()) {
                 auto& ent = self->queue.front();
-                if(ent) {
-                    to_wire_valid(R, ent, &self->pvMask);
+                if(ent.val) {
+                    to_wire_valid(R, ent.val, &self->pvMask);
                     // TODO: placeholder for overrun mask
                     to_wire(R, uint8_t(0u));
 
@@ -170,12 +180,16 @@ struct MonitorOp final : public ServerOp
                     to_wire(R, Status{});
                 }
 
+                posted = ent.posted;
                 self->queue.pop_front();
             }
         }
 
         ch->statTx += conn->enqueueTxBody(pva_app_msg_t::CMD_MONITOR);
 
+        if(posted)
+            conn->notePosted(*ch, posted);
+
         if(self->state == ServerOp::Dead) {
             self->cleanup();
             return;
@@ -225,6 +239,14 @@ struct MonitorOp final : public ServerOp
     {
         strm<<"MONITOR\n";
     }
+
+    void stats(Stats& stats) const override final
+    {
+        Guard G(lock);
+        stats.nmonitor++;
+        stats.monQueue += queue.size();
+        stats.monSquash += totalSquash;
+    }
 };
 DEFINE_INST_COUNTER(MonitorOp);
 
@@ -251,6 +273,8 @@ struct ServerMonitorControl : public server::MonitorControlOp
 
         // pvMask is const at this point, so no need to lock
         bool real = testmask(val, mon->pvMask);
+        // as is timed
+        uint64_t now = mon->timed ? monotonicNS() : 0u;
 
         Guard G(mon->lock);
         if(mon->finished)
@@ -261,7 +285,7 @@ struct ServerMonitorControl : public server::MonitorControlOp
             if((mon->queue.size() < mon->limit) || force || !val) {
 
                 mon->finished = !val;
-                mon->queue.push_back(val);
+                mon->queue.emplace_back(val, now);
 
                 if(mon->maxQueue < mon->queue.size())
                     mon->maxQueue = mon->queue.size();
@@ -270,8 +294,10 @@ struct ServerMonitorControl : public server::MonitorControlOp
                 // squash
                 assert(mon->limit>0 && !mon->queue.empty());
 
-                mon->queue.back().assign(val);
+                // keep original post() time, which is now the age of the oldest squashed update
+                mon->queue.back().val.assign(val);
                 mon->nSquash++;
+                mon->totalSquash++;
 
             } else {
                 // nope
@@ -300,7 +326,7 @@ struct ServerMonitorControl : public server::MonitorControlOp
         stat.maxQueue = mon->maxQueue;
         stat.limitQueue = mon->limit;
         stat.window = mon->window;
-        stat.nQueue = mon->nSquash;
+        stat.nSquash = mon->nSquash;
 
         if(reset)
             mon->maxQueue = mon->nSquash = 0u;
@@ -492,6 +518,7 @@ void ServerConn::handle_MONITOR()
 
         auto op(std::make_shared<MonitorOp>(chan, ioid));
         op->window = nack;
+        op->timed = iface->server->effective.latencyStats;
         (void)pvRequest["record._options.pipeline"].as(op->pipeline);
 
         pvRequest["record._options.queueSize"].as<uint32_t>([&op](size_t qSize){
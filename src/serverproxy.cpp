@@ -0,0 +1,459 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include <epicsGuard.h>
+
+#include <pvxs/log.h>
+#include <pvxs/client.h>
+#include <pvxs/sharedpv.h>
+#include <pvxs/source.h>
+
+#include "utilpvt.h"
+
+typedef epicsGuard<pvxs::impl::ProfiledMutex> Guard;
+typedef epicsGuardRelease<pvxs::impl::ProfiledMutex> UnGuard;
+
+DEFINE_LOGGER(logproxy, "pvxs.server.proxy");
+
+namespace pvxs {
+namespace server {
+
+/* Threading.  Upstream subscription events arrive on the client worker,
+ * which calls SharedPV::open() and post(), and so synchronizes with the server worker.
+ * So the server worker must never wait for the client worker.  All upstream
+ * operations are created with syncCancel(false), and cancelled only implicitly
+ * by releasing the handle.
+ *
+ * Entries without downstream clients are kept in one of two lists.
+ * Those with an upstream value in the idle LRU, limited by maxIdle.
+ * Those still connecting (maybe to a PV which does not exist) in the pending FIFO,
+ * limited by maxPending.  An entry with downstream clients is in neither.
+ */
+struct ProxySource::Impl final : public Source, public std::enable_shared_from_this<Impl>
+{
+    struct Entry {
+        const std::string name;
+        SharedPV pv;
+        // upstream channel, until connected for the first time
+        std::shared_ptr<client::Connect> conn;
+        // upstream subscription, once connected
+        std::shared_ptr<client::Subscription> sub;
+
+        // guarded by Impl::lock
+        bool ready = false; // pv has been open()'d with an upstream value
+        bool inuse = false; // downstream clients are attached
+        std::list<std::shared_ptr<Entry>>::iterator pos; // in idle (ready) or pending (!ready) when !inuse
+
+        explicit Entry(const std::string& name)
+            :name(name)
+            ,pv(SharedPV::buildReadonly())
+        {}
+    };
+    typedef std::list<std::shared_ptr<Entry>> entries_t;
+
+    client::Context upstream;
+    const size_t maxIdle;
+    const size_t maxPending;
+
+    mutable ProfiledMutex lock{"ProxySource"};
+    std::map<std::string, std::shared_ptr<Entry>> entries;
+    // ready entries without downstream clients.  Least recently used first.
+    entries_t idle;
+    // connecting entries without downstream clients.  Oldest first.
+    entries_t pending;
+    bool closed = false;
+
+    INST_COUNTER(ProxySourceImpl);
+
+    Impl(const client::Context& upstream, size_t maxIdle, size_t maxPending)
+        :upstream(upstream)
+        ,maxIdle(maxIdle)
+        ,maxPending(maxPending)
+    {}
+
+    entries_t& listOf(const Entry& entry)
+    {
+        return entry.ready ? idle : pending;
+    }
+
+    std::shared_ptr<Entry> lookup(Guard& G, const std::string& name,
+                                  std::vector<std::shared_ptr<Entry>>& evicted)
+    {
+        G.assertIdenticalMutex(lock);
+
+        auto it(entries.find(name));
+        if(it!=entries.end())
+            return it->second;
+        else if(closed)
+            return nullptr;
+
+        log_debug_printf(logproxy, "%p open upstream '%s'\n", this, name.c_str());
+
+        auto entry(std::make_shared<Entry>(name));
+        std::weak_ptr<Impl> wself(shared_from_this());
+        std::weak_ptr<Entry> wentry(entry);
+
+        entry->pv.onFirstConnect([wself, wentry](SharedPV& pv) {
+            auto self(wself.lock());
+            auto entry(wentry.lock());
+            if(!self || !entry)
+                return;
+            {
+                Guard G(self->lock);
+                auto it(self->entries.find(entry->name));
+                if(it!=self->entries.end() && it->second==entry) {
+                    if(!entry->inuse) {
+                        entry->inuse = true;
+                        self->listOf(*entry).erase(entry->pos);
+                    }
+                    return;
+                }
+            }
+            // raced with eviction.  Client will search again.
+            pv.close();
+        });
+
+        entry->pv.onLastDisconnect([wself, wentry](SharedPV&) {
+            auto self(wself.lock());
+            auto entry(wentry.lock());
+            if(!self || !entry)
+                return;
+            std::vector<std::shared_ptr<Entry>> evicted;
+            {
+                Guard G(self->lock);
+                // may be called once for each channel during SharedPV::close()
+                auto it(self->entries.find(entry->name));
+                if(!entry->inuse || it==self->entries.end() || it->second!=entry)
+                    return;
+                entry->inuse = false;
+                auto& list = self->listOf(*entry);
+                entry->pos = list.insert(list.end(), entry);
+                self->evict(G, evicted);
+            }
+            Impl::release(evicted);
+        });
+
+        entry->pv.onPut([wself, name](SharedPV&, std::unique_ptr<ExecOp>&& rawop, Value&& val) {
+            std::shared_ptr<ExecOp> op(std::move(rawop));
+            auto self(wself.lock());
+            if(!self) {
+                op->error("Proxy closed");
+                return;
+            }
+
+            auto put(self->upstream.put(name)
+                     .syncCancel(false)
+                     .build([val](Value&& prototype) -> Value {
+                         auto ret(prototype.cloneEmpty());
+                         ret.assign(val);
+                         return ret;
+                     })
+                     .result([op](client::Result&& result) {
+                         try {
+                             result();
+                             op->reply();
+                         }catch(std::exception& e){
+                             op->error(e.what());
+                         }
+                     })
+                     .exec());
+            // upstream operation lives until the downstream operation completes, or is cancelled
+            op->onCancel([put]() {});
+        });
+
+        entry->pv.onRPC([wself, name](SharedPV&, std::unique_ptr<ExecOp>&& rawop, Value&& arg) {
+            std::shared_ptr<ExecOp> op(std::move(rawop));
+            auto self(wself.lock());
+            if(!self) {
+                op->error("Proxy closed");
+                return;
+            }
+
+            auto rpc(self->upstream.rpc(name, arg)
+                     .syncCancel(false)
+                     .result([op](client::Result&& result) {
+                         try {
+                             op->reply(result());
+                         }catch(std::exception& e){
+                             op->error(e.what());
+                         }
+                     })
+                     .exec());
+            op->onCancel([rpc]() {});
+        });
+
+        // Only search upstream until the PV is found.  A name which is never found
+        // costs only an upstream channel, until evicted from pending.
+        // dispatch()s to client worker.  Does not block.
+        entry->conn = upstream.connect(name)
+                .syncCancel(false)
+                .onConnect([wself, wentry]() {
+                    auto self(wself.lock());
+                    auto entry(wentry.lock());
+                    if(self && entry)
+                        self->onFound(entry);
+                })
+                .exec();
+
+        entries.emplace(name, entry);
+        entry->pos = pending.insert(pending.end(), entry);
+        evict(G, evicted, entry);
+
+        return entry;
+    }
+
+    // on client worker
+    void onFound(const std::shared_ptr<Entry>& entry)
+    {
+        std::weak_ptr<Impl> wself(shared_from_this());
+        std::weak_ptr<Entry> wentry(entry);
+
+        {
+            Guard G(lock);
+            auto it(entries.find(entry->name));
+            if(it==entries.end() || it->second!=entry || entry->sub)
+                return; // already evicted, or reconnect
+        }
+
+        log_debug_printf(logproxy, "%p upstream '%s' found\n", this, entry->name.c_str());
+
+        // dispatch()s to client worker.  Does not block.
+        auto sub(upstream.monitor(entry->name)
+                 .syncCancel(false)
+                 .maskConnected(true)
+                 .maskDisconnected(false)
+                 .event([wself, wentry](client::Subscription& sub) {
+                     auto self(wself.lock());
+                     auto entry(wentry.lock());
+                     if(self && entry)
+                         self->onUpstream(entry, sub);
+                 })
+                 .exec());
+
+        Guard G(lock);
+        auto it(entries.find(entry->name));
+        if(it!=entries.end() && it->second==entry && !entry->sub)
+            entry->sub = std::move(sub);
+        // otherwise evicted meanwhile.  Implicit cancel after unlock
+    }
+
+    // on client worker
+    void onUpstream(const std::shared_ptr<Entry>& entry, client::Subscription& sub)
+    {
+        while(true) {
+            try {
+                auto val(sub.pop());
+                if(!val)
+                    break;
+
+                bool ready;
+                std::vector<std::shared_ptr<Entry>> evicted;
+                {
+                    Guard G(lock);
+                    ready = entry->ready;
+                    setReady(G, entry, true, evicted);
+                }
+                release(evicted);
+
+                if(ready) {
+                    entry->pv.post(val);
+                } else {
+                    log_debug_printf(logproxy, "%p upstream '%s' ready\n", this, entry->name.c_str());
+                    entry->pv.open(val);
+                }
+
+            }catch(std::exception& e){
+                // disconnect, finished, or error.  Downstream clients will reconnect
+                // after the next upstream update, which may have a different type.
+                log_debug_printf(logproxy, "%p upstream '%s' reset: %s\n",
+                                 this, entry->name.c_str(), e.what());
+                std::vector<std::shared_ptr<Entry>> evicted;
+                {
+                    Guard G(lock);
+                    setReady(G, entry, false, evicted);
+                }
+                release(evicted);
+                entry->pv.close();
+            }
+        }
+    }
+
+    // move an entry without downstream clients between pending and idle
+    void setReady(Guard& G, const std::shared_ptr<Entry>& entry, bool ready,
+                  std::vector<std::shared_ptr<Entry>>& evicted)
+    {
+        G.assertIdenticalMutex(lock);
+
+        if(entry->ready==ready)
+            return;
+
+        auto it(entries.find(entry->name));
+        if(entry->inuse || it==entries.end() || it->second!=entry) {
+            entry->ready = ready;
+            return;
+        }
+
+        listOf(*entry).erase(entry->pos);
+        entry->ready = ready;
+        auto& list = listOf(*entry);
+        entry->pos = list.insert(list.end(), entry);
+        evict(G, evicted, entry);
+    }
+
+    void evict(Guard& G, std::vector<std::shared_ptr<Entry>>& evicted,
+               const std::shared_ptr<Entry>& keep = nullptr)
+    {
+        G.assertIdenticalMutex(lock);
+
+        for(auto list : {std::make_pair(&idle, maxIdle), std::make_pair(&pending, maxPending)}) {
+            auto it(list.first->begin());
+            while(list.first->size() > list.second && it!=list.first->end()) {
+                if(*it==keep) {
+                    // newly created or moved, and not yet given a chance to connect
+                    ++it;
+                    continue;
+                }
+                auto victim(std::move(*it));
+                it = list.first->erase(it);
+                entries.erase(victim->name);
+
+                log_debug_printf(logproxy, "%p evict upstream '%s'\n", this, victim->name.c_str());
+                evicted.push_back(std::move(victim));
+            }
+        }
+    }
+
+    // call without lock
+    static
+    void release(std::vector<std::shared_ptr<Entry>>& evicted)
+    {
+        for(auto& entry : evicted) {
+            // implicit cancel
+            entry->conn.reset();
+            entry->sub.reset();
+            entry->pv.close();
+        }
+        evicted.clear();
+    }
+
+    virtual void onSearch(Search &op) override final
+    {
+        std::vector<std::shared_ptr<Entry>> evicted;
+        {
+            Guard G(lock);
+            for(auto& name : op) {
+                auto entry(lookup(G, name.name(), evicted));
+                if(entry && entry->ready) {
+                    name.claim();
+                    log_debug_printf(logproxy, "%p claim '%s'\n", this, name.name());
+                }
+            }
+        }
+        release(evicted);
+    }
+
+    virtual void onCreate(std::unique_ptr<ChannelControl> &&op) override final
+    {
+        SharedPV pv;
+        std::vector<std::shared_ptr<Entry>> evicted;
+        {
+            Guard G(lock);
+            if(auto entry = lookup(G, op->name(), evicted))
+                pv = entry->pv;
+        }
+        release(evicted);
+
+        // Until ready, SharedPV defers operations
+        if(pv)
+            pv.attach(std::move(op));
+    }
+
+    virtual List onList() override final
+    {
+        auto names(std::make_shared<std::set<std::string>>());
+        {
+            Guard G(lock);
+            for(auto& pair : entries) {
+                if(pair.second->ready)
+                    names->insert(pair.first);
+            }
+        }
+
+        List ret;
+        ret.names = names;
+        ret.dynamic = true;
+        return ret;
+    }
+
+    virtual void show(std::ostream& strm) override final
+    {
+        strm<<"ProxySource";
+
+        Guard G(lock);
+        for(auto& pair : entries) {
+            strm<<"\n"<<indent{}<<pair.first
+                <<(pair.second->ready ? "" : " connecting")
+                <<(pair.second->inuse ? "" : " idle");
+        }
+    }
+};
+DEFINE_INST_COUNTER2(ProxySource::Impl, ProxySourceImpl);
+
+ProxySource ProxySource::build(const client::Context& upstream, size_t maxIdle, size_t maxPending)
+{
+    if(!upstream)
+        throw std::logic_error("ProxySource requires a client Context");
+
+    ProxySource ret;
+    ret.impl = std::make_shared<Impl>(upstream, maxIdle, maxPending);
+    return ret;
+}
+
+ProxySource::~ProxySource() {}
+
+std::shared_ptr<Source> ProxySource::source() const
+{
+    if(!impl)
+        throw std::logic_error("Empty ProxySource");
+    return impl;
+}
+
+void ProxySource::close()
+{
+    if(!impl)
+        throw std::logic_error("Empty ProxySource");
+
+    std::vector<std::shared_ptr<Impl::Entry>> evicted;
+    {
+        Guard G(impl->lock);
+        impl->closed = true;
+        for(auto& pair : impl->entries)
+            evicted.push_back(std::move(pair.second));
+        impl->entries.clear();
+        impl->idle.clear();
+        impl->pending.clear();
+    }
+    Impl::release(evicted);
+}
+
+ProxySource::list_t ProxySource::list() const
+{
+    if(!impl)
+        throw std::logic_error("Empty ProxySource");
+
+    list_t ret;
+    Guard G(impl->lock);
+    for(auto& pair : impl->entries)
+        ret[pair.first] = pair.second->inuse;
+    return ret;
+}
+
+} // namespace server
+} // namespace pvxs
@@ -20,6 +20,11 @@ ServerSource::ServerSource(server::Server::Pvt* serv)
                       Member(TypeCode::String, "implLang"),
                       Member(TypeCode::String, "version"),
                   }).create())
+    ,latency(TypeDef(TypeCode::Struct, {
+                         Member(TypeCode::Float64A, "limit"),
+                         Member(TypeCode::UInt64A, "queue"),
+                         Member(TypeCode::UInt64A, "send"),
+                     }).create())
 {}
 
 void ServerSource::onSearch(Search &op)
@@ -86,6 +91,33 @@ void ServerSource::onCreate(std::unique_ptr<server::ChannelControl> &&op)
             ret["implLang"] = "cpp";
             ret["version"] = version_str();
 
+            eop->reply(ret);
+            return;
+
+        } else if(op=="latency") {
+            if(!serv->effective.latencyStats) {
+                eop->error("Latency statistics not enabled.  cf. PVXS_SERVER_LATENCY_STATS");
+                return;
+            }
+
+            Report::Latency snap;
+            serv->acceptor_loop.call([this, &snap](){
+                snap = serv->latency;
+            });
+
+            shared_array<double> limit(TimeHistogram::nbuckets);
+            shared_array<uint64_t> queue(TimeHistogram::nbuckets), send(TimeHistogram::nbuckets);
+            for(auto i : range(TimeHistogram::nbuckets)) {
+                limit[i] = TimeHistogram::limit(i);
+                queue[i] = snap.queue.buckets[i];
+                send[i] = snap.send.buckets[i];
+            }
+
+            auto ret = latency.cloneEmpty();
+            ret["limit"] = limit.freeze();
+            ret["queue"] = queue.freeze();
+            ret["send"] = send.freeze();
+
             eop->reply(ret);
             return;
         }
@@ -19,8 +19,8 @@
 #include "utilpvt.h"
 #include "dataimpl.h"
 
-typedef epicsGuard<epicsMutex> Guard;
-typedef epicsGuardRelease<epicsMutex> UnGuard;
+typedef epicsGuard<pvxs::impl::ProfiledMutex> Guard;
+typedef epicsGuardRelease<pvxs::impl::ProfiledMutex> UnGuard;
 
 DEFINE_LOGGER(logshared, "pvxs.server.sharedpv");
 DEFINE_LOGGER(logsource, "pvxs.server.staticsource");
@@ -34,7 +34,7 @@ using ptr_set = std::set<T, std::owner_less<T>>;
 
 struct SharedPV::Impl : public std::enable_shared_from_this<Impl>
 {
-    mutable epicsMutex lock;
+    mutable ProfiledMutex lock{"SharedPV"};
 
     std::function<void(SharedPV&, std::unique_ptr<ExecOp>&&, Value&&)> onPut;
     std::function<void(SharedPV&, std::unique_ptr<ExecOp>&&, Value&&)> onRPC;
@@ -477,9 +477,11 @@ struct StaticSource::Impl final : public Source
 
     virtual void onSearch(Search &op) override
     {
+        std::string key; // re-use allocation for lookups
         auto G(lock.lockReader());
         for(auto& name : op) {
-            auto it(pvs.find(name.name()));
+            key = name.name();
+            auto it(pvs.find(key));
             if(it!=pvs.end()) {
                 name.claim();
                 log_debug_printf(logsource, "%p claim '%s'\n", this, name.name());
@@ -0,0 +1,298 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+#include <string.h>
+#include <errno.h>
+
+#if defined(__linux__)
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#  include <fcntl.h>
+#  ifdef SYS_memfd_create
+#    define HAVE_SHM
+#  endif
+#  ifndef F_ADD_SEALS
+#    define F_ADD_SEALS 1033
+#    define F_GET_SEALS 1034
+#    define F_SEAL_SEAL 0x0001
+#    define F_SEAL_SHRINK 0x0002
+#    define F_SEAL_GROW 0x0004
+#  endif
+#endif
+
+#include <pvxs/log.h>
+
+#include "shm.h"
+
+namespace pvxs {
+namespace impl {
+
+DEFINE_LOGGER(logshm, "pvxs.shm");
+
+namespace {
+
+// each block begins on a cache line, with this header
+struct BlockHeader {
+    uint32_t slot; // index in reference count table
+    uint32_t reserved;
+    uint64_t nbytes;
+};
+constexpr size_t blockAlign = 64u;
+static_assert(sizeof(BlockHeader)<=blockAlign, "BlockHeader too large");
+
+typedef std::atomic<uint32_t> refcount_t;
+static_assert(sizeof(refcount_t)==sizeof(uint32_t), "refcount_t not shareable");
+
+// name given to memfd_create(), and checked by the peer
+constexpr char memfdName[] = "pvxs-shm";
+
+size_t pageSize()
+{
+#ifdef HAVE_SHM
+    return size_t(sysconf(_SC_PAGESIZE));
+#else
+    return 4096u;
+#endif
+}
+
+// Enough reference counts for the smallest blocks to fill the segment.
+// Page aligned, so that the peer may map blocks read-only.
+size_t ctrlSizeOf(size_t size)
+{
+    const size_t nslots = size/ShmSegment::threshold + 1u;
+    const size_t page = pageSize();
+    return (nslots*sizeof(refcount_t) + page - 1u)/page*page;
+}
+
+refcount_t* refTable(uint8_t* base)
+{
+    return reinterpret_cast<refcount_t*>(base);
+}
+
+} // namespace
+
+ShmSegment::ShmSegment(size_t size, uint8_t *base, int fd, const std::string& path)
+    :size(size)
+    ,ctrlSize(ctrlSizeOf(size))
+    ,base(base)
+    ,fd(fd)
+    ,path(path)
+    ,slotBusy(ctrlSize/sizeof(refcount_t), false)
+    ,head(ctrlSize)
+{}
+
+ShmSegment::~ShmSegment()
+{
+#ifdef HAVE_SHM
+    munmap(base, size);
+    if(fd>=0)
+        close(fd);
+#endif
+}
+
+std::shared_ptr<ShmSegment> ShmSegment::create(size_t size)
+{
+#ifdef HAVE_SHM
+    if(size <= ctrlSizeOf(size) + blockAlign + threshold) {
+        log_warn_printf(logshm, "Shared memory size %zu too small\n", size);
+        return nullptr;
+    }
+
+    int fd = syscall(SYS_memfd_create, memfdName, 3u /* MFD_CLOEXEC|MFD_ALLOW_SEALING */);
+    if(fd<0) {
+        log_warn_printf(logshm, "memfd_create() error %d\n", errno);
+        return nullptr;
+    }
+
+    void *base = MAP_FAILED;
+    // size is fixed, so the peer can not be made to fault by truncation
+    if(ftruncate(fd, off_t(size))==0 && fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK|F_SEAL_GROW|F_SEAL_SEAL)==0)
+        base = mmap(nullptr, size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if(base==MAP_FAILED) {
+        log_warn_printf(logshm, "Unable to allocate %zu bytes of shared memory: %d\n", size, errno);
+        close(fd);
+        return nullptr;
+    }
+
+    // peer process opens our descriptor.  Requires same user, and PID namespace
+    std::string path(SB()<<"/proc/"<<getpid()<<"/fd/"<<fd);
+
+    log_debug_printf(logshm, "Create %s %zu bytes\n", path.c_str(), size);
+
+    return std::make_shared<ShmSegment>(size, static_cast<uint8_t*>(base), fd, path);
+#else
+    (void)size;
+    return nullptr;
+#endif
+}
+
+std::shared_ptr<ShmSegment> ShmSegment::open(const std::string& path, size_t size,
+                                             int64_t peerPID, int64_t peerUID)
+{
+#ifdef HAVE_SHM
+    // only a descriptor of our peer process.  eg. "/proc/1234/fd/5"
+    const std::string prefix(SB()<<"/proc/"<<peerPID<<"/fd/");
+    if(peerPID<=0 || path.size()<=prefix.size() || path.compare(0u, prefix.size(), prefix)!=0
+            || path.find_first_not_of("0123456789", prefix.size())!=std::string::npos) {
+        log_warn_printf(logshm, "Reject shared memory path %s from PID %lld\n",
+                        (SB()<<escape(path)).str().c_str(), (long long)peerPID);
+        return nullptr;
+    }
+
+    const size_t ctrl = ctrlSizeOf(size);
+    if(size <= ctrl + blockAlign) {
+        log_debug_printf(logshm, "Reject shared memory size %zu\n", size);
+        return nullptr;
+    }
+
+    int fd = ::open(path.c_str(), O_RDWR|O_CLOEXEC);
+    if(fd<0) {
+        log_debug_printf(logshm, "Unable to open %s : %d\n", path.c_str(), errno);
+        return nullptr;
+    }
+
+    // Check what was actually opened.  Must be a sealed memfd, created by our peer
+    bool ok;
+    {
+        char target[64] = "";
+        std::string self(SB()<<"/proc/self/fd/"<<fd);
+        auto n = readlink(self.c_str(), target, sizeof(target)-1u);
+        if(n>0)
+            target[n] = '\0';
+
+        const int seals = fcntl(fd, F_GET_SEALS);
+        struct stat info;
+
+        ok = strncmp(target, "/memfd:", 7u)==0 && strncmp(target+7u, memfdName, sizeof(memfdName)-1u)==0
+                && seals!=-1 && (seals&(F_SEAL_SHRINK|F_SEAL_GROW))==(F_SEAL_SHRINK|F_SEAL_GROW)
+                && fstat(fd, &info)==0 && S_ISREG(info.st_mode)
+                && int64_t(info.st_uid)==peerUID && size_t(info.st_size)==size;
+    }
+
+    void *base = MAP_FAILED;
+    if(ok) {
+        // Blocks read-only.  Only the reference count table is writable
+        base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if(base!=MAP_FAILED && mmap(base, ctrl, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_FIXED, fd, 0)==MAP_FAILED) {
+            munmap(base, size);
+            base = MAP_FAILED;
+        }
+    }
+    // mapping persists after close
+    close(fd);
+
+    if(!ok) {
+        log_warn_printf(logshm, "Reject %s, not a shared memory segment\n", path.c_str());
+        return nullptr;
+
+    } else if(base==MAP_FAILED) {
+        log_debug_printf(logshm, "Unable to map %s %zu bytes\n", path.c_str(), size);
+        return nullptr;
+    }
+
+    log_debug_printf(logshm, "Map %s %zu bytes\n", path.c_str(), size);
+
+    return std::make_shared<ShmSegment>(size, static_cast<uint8_t*>(base), -1, path);
+#else
+    (void)path;
+    (void)size;
+    (void)peerPID;
+    (void)peerUID;
+    return nullptr;
+#endif
+}
+
+// first free range of at least need bytes, beginning at or after from
+size_t ShmSegment::findGap(size_t need, size_t from) const
+{
+    size_t start = ctrlSize; // end of previous block
+    for(auto& pair : outstanding) {
+        auto gap = std::max(start, from);
+        if(pair.first >= gap && pair.first - gap >= need)
+            return gap;
+        start = std::max(start, pair.first + pair.second.need);
+    }
+    auto gap = std::max(start, from);
+    if(size >= gap && size - gap >= need)
+        return gap;
+    return size_t(-1);
+}
+
+size_t ShmSegment::put(const void *data, size_t nbytes)
+{
+    if(nbytes < threshold)
+        return size_t(-1);
+
+    const size_t need = blockAlign + ((nbytes + blockAlign-1u) & ~(blockAlign-1u));
+    auto refs = refTable(base);
+
+    // reclaim each block released by peer.  A block still held does not delay others.
+    for(auto it(outstanding.begin()); it!=outstanding.end();) {
+        if(refs[it->second.slot].load(std::memory_order_acquire)) {
+            ++it;
+        } else {
+            slotBusy[it->second.slot] = false;
+            it = outstanding.erase(it);
+        }
+    }
+
+    uint32_t slot = 0u;
+    while(slot<slotBusy.size() && slotBusy[slot])
+        slot++;
+    if(slot==slotBusy.size())
+        return size_t(-1);
+
+    // continue after the last allocation, then wrap around
+    auto at = findGap(need, head);
+    if(at==size_t(-1) && head!=ctrlSize)
+        at = findGap(need, ctrlSize);
+    if(at==size_t(-1))
+        return size_t(-1);
+
+    auto hdr = new (base + at) BlockHeader;
+    hdr->slot = slot;
+    hdr->reserved = 0u;
+    hdr->nbytes = nbytes;
+    memcpy(base + at + blockAlign, data, nbytes);
+    refs[slot].store(1u, std::memory_order_release);
+
+    slotBusy[slot] = true;
+    outstanding[at] = Block{need, slot};
+    head = at + need;
+    nBlocks++;
+    nBytes += nbytes;
+
+    return at;
+}
+
+std::shared_ptr<const void> ShmSegment::get(uint64_t offset, uint64_t nbytes)
+{
+    if(offset%blockAlign || offset < ctrlSize || offset > size || size - offset < blockAlign
+            || size - offset - blockAlign < nbytes)
+        return nullptr;
+
+    auto hdr = reinterpret_cast<const BlockHeader*>(base + offset);
+    const auto slot = hdr->slot;
+    if(hdr->nbytes!=nbytes || slot >= ctrlSize/sizeof(refcount_t))
+        return nullptr;
+
+    auto ref = &refTable(base)[slot];
+
+    // deleter keeps mapping alive while any view exists
+    auto self(shared_from_this());
+    return std::shared_ptr<const void>(base + offset + blockAlign, [self, ref](const void*) {
+        ref->fetch_sub(1u, std::memory_order_release);
+    });
+}
+
+}} // namespace pvxs::impl
@@ -0,0 +1,95 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+#ifndef SHM_H
+#define SHM_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "utilpvt.h"
+
+namespace pvxs {
+namespace impl {
+
+/* Same host transport of large arrays through shared memory.
+ *
+ * Negotiated per connection when both peers are pvxs, connected through a local (AF_UNIX) socket.
+ *   - Server includes "x-pvxs-shm" in its CONNECTION_VALIDATION auth list (ignored by others)
+ *   - Client sends CMD_PVXS_SHM ShmRequest
+ *   - Server creates a sealed memfd segment and replies with ShmOffer of its path and size
+ *   - Client checks that the path names a memfd of its peer process, maps the segment
+ *     and replies ShmAccept
+ *   - Server may now encode numeric arrays as a descriptor of a block in the segment.
+ *
+ * On a negotiated connection, an array Size lead byte of 255 (otherwise invalid)
+ * is followed by a uint64_t offset and uint64_t element count.
+ *
+ * The segment begins with a table of reference counts, which the client maps writable.
+ * Blocks follow, which the client maps read-only.  Each block begins with a header
+ * naming its reference count, set to 1 by the server before sending.
+ * The client decrements when its last shared_array view is released.
+ * The server reclaims each block once its count reaches zero.
+ *
+ * A reply may be in flight when the client sends CMD_DESTROY_REQUEST.  So the client
+ * keeps the type of a cancelled operation, and decodes (then discards) any such reply
+ * to release its blocks, until the server follows the DESTROY_REQUEST with ShmDestroyed.
+ * If the segment is full, arrays are sent inline.
+ */
+struct PVXS_API ShmSegment : public std::enable_shared_from_this<ShmSegment> {
+    enum op_t : uint8_t {
+        ShmRequest = 0,
+        ShmOffer = 1,
+        ShmAccept = 2,
+        ShmDestroyed = 3, // followed by uint32_t IOID
+    };
+
+    // Arrays with fewer bytes than this are always sent inline
+    static constexpr size_t threshold = 16u*1024u;
+
+    const size_t size;
+    // size of the reference count table.  Blocks begin at this offset
+    const size_t ctrlSize;
+    uint8_t * const base;
+    const int fd;
+    // which the peer may open()
+    const std::string path;
+
+    // allocation state.  Only used by owner (server), on connection worker
+    struct Block {
+        size_t need;
+        uint32_t slot;
+    };
+    std::map<size_t, Block> outstanding; // by offset
+    std::vector<bool> slotBusy;
+    size_t head; // next allocation
+    // counters of arrays sent through the segment
+    size_t nBlocks = 0u, nBytes = 0u;
+
+    ShmSegment(size_t size, uint8_t *base, int fd, const std::string& path);
+    ~ShmSegment();
+
+    //! Create a new segment.  Returns nullptr if not supported
+    static std::shared_ptr<ShmSegment> create(size_t size);
+    /** Map a segment created by our peer.  Returns nullptr on error,
+     *  or if path does not name a pvxs memfd owned by process peerPID and user peerUID.
+     */
+    static std::shared_ptr<ShmSegment> open(const std::string& path, size_t size,
+                                            int64_t peerPID, int64_t peerUID);
+
+    //! Copy into a new block.  Returns size_t(-1) to send inline
+    size_t put(const void *data, size_t nbytes);
+    //! View of a block.  The block is released when the last reference is dropped.
+    std::shared_ptr<const void> get(uint64_t offset, uint64_t nbytes);
+
+private:
+    size_t findGap(size_t need, size_t from) const;
+};
+
+}} // namespace pvxs::impl
+
+#endif // SHM_H
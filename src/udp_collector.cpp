@@ -76,6 +76,8 @@ struct UDPCollector final : public UDPManager::Search,
             if(!(ev&EV_READ))
                 return;
 
+            LoopTimer T("udp", self->name.c_str());
+
             // handle up to 4 packets before going back to the reactor
             for(unsigned i=0; i<4 && self->handle_one(); i++) {}
 
@@ -89,6 +91,9 @@ struct UDPCollector final : public UDPManager::Search,
     // Search interface
 public:
     virtual bool reply(const void *msg, size_t msglen) const override;
+    virtual std::function<bool(const void *msg, size_t msglen)> deferReply() const override;
+
+    bool replyTo(const SockAddr& dest, const void *msg, size_t msglen) const;
 };
 
 
@@ -482,20 +487,35 @@ void UDPCollector::forwardM(const SockAddr& origin, const uint8_t *pbuf, size_t
 }
 
 bool UDPCollector::reply(const void *msg, size_t msglen) const
+{
+    return replyTo(src, msg, msglen);
+}
+
+std::function<bool(const void *msg, size_t msglen)> UDPCollector::deferReply() const
+{
+    std::weak_ptr<const UDPCollector> self(shared_from_this());
+    SockAddr dest(src);
+    return [self, dest](const void *msg, size_t msglen) -> bool {
+        auto collector(self.lock());
+        return collector && collector->replyTo(dest, msg, msglen);
+    };
+}
+
+bool UDPCollector::replyTo(const SockAddr& dest, const void *msg, size_t msglen) const
 {
     manager->loop.assertInLoop();
 
     log_hex_printf(logio, Level::Debug, msg, msglen, "Send %s -> %s\n",
-                   bind_addr.tostring().c_str(), src.tostring().c_str());
+                   bind_addr.tostring().c_str(), dest.tostring().c_str());
 
-    auto ntx = sendto(sock.sock, (char*)msg, msglen, 0, &src->sa, src.size());
+    auto ntx = sendto(sock.sock, (char*)msg, msglen, 0, &dest->sa, dest.size());
     if(ntx<0) {
         int err = evutil_socket_geterror(sock.sock);
         if(err==SOCK_EWOULDBLOCK || err==EAGAIN || err==SOCK_EINTR) {
             // nothing to do here
         } else {
             log_warn_printf(logio, "UDP TX Error on %s -> %s : (%d) %s\n",
-                            name.c_str(), src.tostring().c_str(),
+                            name.c_str(), dest.tostring().c_str(),
                             err, evutil_socket_error_to_string(err));
         }
         return false; // wait for more I/O
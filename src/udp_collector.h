@@ -66,6 +66,8 @@ struct PVXS_API UDPManager
         decltype (names)::const_iterator end() const   { return names.end(); }
 
         virtual bool reply(const void *msg, size_t msglen) const =0;
+        //! Reply later, from the receiving socket.  Call only from UDPManager::loop()
+        virtual std::function<bool(const void *msg, size_t msglen)> deferReply() const =0;
         Search() = default;
         Search(const Search&) = delete;
         Search& operator=(const Search&) = delete;
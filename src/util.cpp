@@ -17,6 +17,8 @@
 #include <signal.h>
 
 #include <iomanip>
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
 #include <sstream>
 #include <stdexcept>
@@ -24,10 +26,15 @@
 
 #include <ctype.h>
 
+#include <epicsTime.h>
+#include <epicsString.h>
+#include <epicsGuard.h>
+
 #include <pvxs/log.h>
 #include <pvxs/util.h>
 #include <pvxs/sharedArray.h>
 #include <pvxs/data.h>
+#include <pvxs/server.h>
 #include "utilpvt.h"
 #include "udp_collector.h"
 
@@ -121,6 +128,85 @@ std::map<std::string, size_t> instanceSnapshot()
     return ret;
 }
 
+namespace impl {
+
+struct LockProfile {
+    epicsMutex lock;
+    LockStats stats;
+};
+
+namespace {
+struct LockProfGbl_t {
+    bool enabled = false;
+    epicsMutex lock;
+    std::map<std::string, std::unique_ptr<LockProfile>> byName;
+} *LockProfGbl;
+
+void LockProfInit()
+{
+    LockProfGbl = new LockProfGbl_t;
+    auto env = getenv("PVXS_LOCK_PROFILE");
+    LockProfGbl->enabled = env && (epicsStrCaseCmp(env, "YES")==0 || strcmp(env, "1")==0);
+}
+} // namespace
+
+LockProfile* lockProfileFor(const char* name)
+{
+    threadOnce<&LockProfInit>();
+    auto& gbl = *LockProfGbl;
+    if(!gbl.enabled)
+        return nullptr;
+
+    epicsGuard<epicsMutex> G(gbl.lock);
+    auto& prof = gbl.byName[name];
+    if(!prof)
+        prof.reset(new LockProfile);
+    return prof.get();
+}
+
+void lockProfileSample(LockProfile* prof, bool contended, uint64_t wait, uint64_t hold)
+{
+    epicsGuard<epicsMutex> G(prof->lock);
+    prof->stats.acquisitions++;
+    if(contended) {
+        prof->stats.contended++;
+        prof->stats.wait.sample(wait);
+    }
+    prof->stats.hold.sample(hold);
+}
+
+std::map<std::string, LockStats> lockProfileSnapshot(bool zero)
+{
+    std::map<std::string, LockStats> ret;
+
+    threadOnce<&LockProfInit>();
+    auto& gbl = *LockProfGbl;
+    epicsGuard<epicsMutex> G(gbl.lock);
+    for(auto& pair : gbl.byName) {
+        epicsGuard<epicsMutex> G(pair.second->lock);
+        ret[pair.first] = pair.second->stats;
+        if(zero)
+            pair.second->stats = LockStats{};
+    }
+
+    return ret;
+}
+
+void lockProfileReport(Report& report, bool zero)
+{
+    for(auto& pair : lockProfileSnapshot(zero)) {
+        Report::Lock lock;
+        lock.name = pair.first;
+        lock.acquisitions = pair.second.acquisitions;
+        lock.contended = pair.second.contended;
+        lock.wait = pair.second.wait;
+        lock.hold = pair.second.hold;
+        report.locks.push_back(std::move(lock));
+    }
+}
+
+} // namespace impl
+
 // _assume_ only positive indices will be used
 static
 std::atomic<int> indentIndex{INT_MIN};
@@ -254,6 +340,69 @@ std::ostream& operator<<(std::ostream& strm, const ServerGUID& guid)
     return strm;
 }
 
+constexpr size_t TimeHistogram::nbuckets;
+
+void TimeHistogram::sample(uint64_t ns)
+{
+    uint64_t us = ns/1000u;
+    size_t idx = 0u;
+    while(us && idx < nbuckets-1u) {
+        us >>= 1u;
+        idx++;
+    }
+    buckets[idx]++;
+    count++;
+    total += ns;
+    if(longest < ns)
+        longest = ns;
+}
+
+TimeHistogram& TimeHistogram::operator+=(const TimeHistogram& o)
+{
+    for(auto i : range(nbuckets))
+        buckets[i] += o.buckets[i];
+    count += o.count;
+    total += o.total;
+    if(longest < o.longest)
+        longest = o.longest;
+    return *this;
+}
+
+double TimeHistogram::limit(size_t bucket)
+{
+    return double(uint64_t(1u)<<bucket)*1e-6;
+}
+
+double TimeHistogram::mean() const
+{
+    return count ? double(total)*1e-9/count : 0.0;
+}
+
+double TimeHistogram::quantile(double q) const
+{
+    if(!count)
+        return 0.0;
+    uint64_t thres = uint64_t(std::max(0.0, std::min(q, 1.0))*count);
+    uint64_t accum = 0u;
+    for(auto i : range(nbuckets)) {
+        accum += buckets[i];
+        if(accum > thres || accum==count)
+            return std::min(limit(i), double(longest)*1e-9);
+    }
+    return double(longest)*1e-9; // not reached
+}
+
+std::ostream& operator<<(std::ostream& strm, const TimeHistogram& hist)
+{
+    Restore R(strm);
+    strm<<"N="<<hist.count;
+    if(hist.count) {
+        strm<<" mean="<<hist.mean()<<" p50<="<<hist.quantile(0.5)
+            <<" p99<="<<hist.quantile(0.99)<<" max="<<double(hist.longest)*1e-9;
+    }
+    return strm;
+}
+
 #if !defined(__rtems__) && !defined(vxWorks)
 
 /* Initially EVUTIL_INVALID_SOCKET
@@ -377,6 +526,9 @@ SockAddr::SockAddr(int af)
     if(af!=AF_INET
 #ifdef AF_INET6
             && af!=AF_INET6
+#endif
+#ifdef PVXS_HAVE_AF_UNIX
+            && af!=AF_UNIX
 #endif
             && af!=AF_UNSPEC)
         throw std::invalid_argument("Unsupported address family");
@@ -397,6 +549,17 @@ SockAddr::SockAddr(const sockaddr *addr, socklen_t alen)
     if(family()==AF_UNSPEC) {}
     else if(family()==AF_INET && (!alen || alen>=sizeof(sockaddr_in))) {}
     else if(family()==AF_INET6 && (!alen || alen>=sizeof(sockaddr_in6))) {}
+#ifdef PVXS_HAVE_AF_UNIX
+    else if(family()==AF_UNIX) {
+        // accept() may return a truncated, or unnamed, sockaddr_un
+        if(!alen)
+            alen = sizeof(sockaddr_un);
+        if(alen > offsetof(sockaddr_un, sun_path))
+            memcpy(&store, addr, std::min(size_t(alen), sizeof(sockaddr_un)));
+        store.un.sun_path[sizeof(store.un.sun_path)-1u] = '\0';
+        return;
+    }
+#endif
     else
         throw std::invalid_argument("Unsupported address family");
 
@@ -410,6 +573,9 @@ size_t SockAddr::size() const noexcept
     case AF_INET: return sizeof(store.in);
 #ifdef AF_INET6
     case AF_INET6: return sizeof(store.in6);
+#endif
+#ifdef PVXS_HAVE_AF_UNIX
+    case AF_UNIX: return sizeof(store.un);
 #endif
     default: // AF_UNSPEC and others
         return sizeof(store);
@@ -433,6 +599,9 @@ void SockAddr::setPort(unsigned short port)
     case AF_INET: store.in.sin_port = htons(port); break;
 #ifdef AF_INET6
     case AF_INET6:store.in6.sin6_port = htons(port); break;
+#endif
+#ifdef PVXS_HAVE_AF_UNIX
+    case AF_UNIX: break; // no port number
 #endif
     default:
         throw std::logic_error("SockAddr: set family before port");
@@ -442,6 +611,22 @@ void SockAddr::setPort(unsigned short port)
 void SockAddr::setAddress(const char *name, unsigned short defport)
 {
     assert(name);
+
+    if(strncmp(name, "unix:", 5u)==0) {
+#ifdef PVXS_HAVE_AF_UNIX
+        SockAddr temp(AF_UNIX);
+        const char *path = name+5u;
+        size_t plen = strlen(path);
+        if(plen==0u || plen >= sizeof(temp->un.sun_path))
+            throw std::runtime_error(SB()<<"Invalid local socket path \""<<escape(name)<<"\"");
+        memcpy(temp->un.sun_path, path, plen);
+        (*this) = temp;
+        return;
+#else
+        throw std::runtime_error(SB()<<"Local sockets not supported \""<<escape(name)<<"\"");
+#endif
+    }
+
     // too bad evutil_parse_sockaddr_port() treats ":0" as an error...
 
     /* looking for
@@ -564,6 +749,9 @@ bool SockAddr::isLO() const noexcept
     case AF_INET: return store.in.sin_addr.s_addr==htonl(INADDR_LOOPBACK);
 #ifdef AF_INET6
     case AF_INET6: return IN6_IS_ADDR_LOOPBACK(&store.in6.sin6_addr);
+#endif
+#ifdef PVXS_HAVE_AF_UNIX
+    case AF_UNIX: return true; // always same host
 #endif
     default: return false;
     }
@@ -601,6 +789,15 @@ SockAddr SockAddr::map4to6() const
     return ret;
 }
 
+std::string SockAddr::path() const
+{
+#ifdef PVXS_HAVE_AF_UNIX
+    if(family()==AF_UNIX)
+        return std::string(store.un.sun_path);
+#endif
+    return std::string();
+}
+
 std::string SockAddr::tostring() const
 {
     std::ostringstream strm;
@@ -679,6 +876,11 @@ std::ostream& operator<<(std::ostream& strm, const SockAddr& addr)
                 strm<<':'<<port;
             break;
     }
+#endif
+#ifdef PVXS_HAVE_AF_UNIX
+    case AF_UNIX:
+        strm<<"unix:"<<addr->un.sun_path;
+        break;
 #endif
     case AF_UNSPEC:
         strm<<"<>";
@@ -755,6 +957,17 @@ void threadOnce_(threadOnceInfo *info)
         throw std::logic_error("threadOnce() : Previous failure");
 }
 
+uint64_t monotonicNS()
+{
+#if EPICS_VERSION_INT >= VERSION_INT(7,0,1,0)
+    return epicsMonotonicGet();
+#else
+    epicsTimeStamp now;
+    (void)epicsTimeGetCurrent(&now);
+    return uint64_t(now.secPastEpoch)*1000000000u + now.nsec;
+#endif
+}
+
 template<>
 double parseTo<double>(const std::string& s) {
     size_t idx=0, L=s.size();
@@ -20,6 +20,7 @@
 
 #include <atomic>
 #include <memory>
+#include <map>
 #include <set>
 #include <string>
 #include <sstream>
@@ -30,6 +31,7 @@
 
 #include <compilerDependencies.h>
 #include <epicsThread.h>
+#include <epicsMutex.h>
 
 #include <pvxs/version.h>
 #include <pvxs/util.h>
@@ -155,29 +157,137 @@ template<>
 PVXS_API
 int64_t parseTo<int64_t>(const std::string& s);
 
+//! Monotonic clock in nanoseconds.  Only differences are meaningful.
+PVXS_API
+uint64_t monotonicNS();
+
+/* Lock contention profiling.  Enabled when $PVXS_LOCK_PROFILE=YES.
+ * Statistics are accumulated for all locks sharing a name.
+ */
+struct LockStats {
+    //! Number of times (outermost) lock was acquired
+    uint64_t acquisitions = 0u;
+    //! Number of acquisitions which had to wait
+    uint64_t contended = 0u;
+    //! Time spent waiting by contended acquisitions
+    TimeHistogram wait;
+    //! Time from acquisition until (outermost) release
+    TimeHistogram hold;
+};
+
+struct LockProfile;
+
+//! Find or create accumulator for a named lock.  Returns nullptr when profiling is disabled.
+PVXS_API
+LockProfile* lockProfileFor(const char* name);
+
+PVXS_API
+void lockProfileSample(LockProfile* prof, bool contended, uint64_t wait, uint64_t hold);
+
+//! Copy, and optionally zero, statistics of all named locks
+PVXS_API
+std::map<std::string, LockStats> lockProfileSnapshot(bool zero=false);
+
+struct Report;
+//! Append lockProfileSnapshot() to Report::locks
+PVXS_API
+void lockProfileReport(Report& report, bool zero=false);
+
+/* Drop-in replacement for epicsMutex, for use with epicsGuard<>,
+ * which maybe accumulates LockStats.
+ * Adds a predictable branch to lock()/unlock() when profiling is disabled.
+ */
+class ProfiledMutex
+{
+    epicsMutex mutex;
+    LockProfile* const prof;
+    // remaining members guarded by mutex
+    unsigned depth = 0u;
+    bool contended = false;
+    uint64_t waited = 0u;
+    uint64_t acquired = 0u;
+
+    inline void acquire(bool cont, uint64_t wait) {
+        if(!depth++) {
+            contended = cont;
+            waited = wait;
+            acquired = monotonicNS();
+        }
+    }
+public:
+    explicit ProfiledMutex(const char* name) :prof(lockProfileFor(name)) {}
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    inline void lock() {
+        if(!prof) {
+            mutex.lock();
+
+        } else if(mutex.tryLock()) {
+            acquire(false, 0u);
+
+        } else {
+            auto start(monotonicNS());
+            mutex.lock();
+            acquire(true, monotonicNS() - start);
+        }
+    }
+    inline bool tryLock() {
+        if(!mutex.tryLock())
+            return false;
+        if(prof)
+            acquire(false, 0u);
+        return true;
+    }
+    inline void unlock() {
+        if(prof && !--depth)
+            lockProfileSample(prof, contended, waited, monotonicNS() - acquired);
+        mutex.unlock();
+    }
+    inline void show(unsigned level) const { mutex.show(level); }
+};
+
 #ifdef _WIN32
 #  define RWLOCK_TYPE SRWLOCK
 #  define RWLOCK_INIT(PLOCK)    InitializeSRWLock(PLOCK)
 #  define RWLOCK_DTOR(PLOCK)    do{(void)(PLOCK);}while(0)
 #  define RWLOCK_WLOCK(PLOCK)   AcquireSRWLockExclusive(PLOCK)
+#  define RWLOCK_TRYWLOCK(PLOCK) (TryAcquireSRWLockExclusive(PLOCK)!=0)
 #  define RWLOCK_WUNLOCK(PLOCK) ReleaseSRWLockExclusive(PLOCK)
 #  define RWLOCK_RLOCK(PLOCK)   AcquireSRWLockShared(PLOCK)
+#  define RWLOCK_TRYRLOCK(PLOCK) (TryAcquireSRWLockShared(PLOCK)!=0)
 #  define RWLOCK_RUNLOCK(PLOCK) ReleaseSRWLockShared(PLOCK)
 #else
 #  define RWLOCK_TYPE pthread_rwlock_t
 #  define RWLOCK_INIT(PLOCK)    pthread_rwlock_init(PLOCK, nullptr)
 #  define RWLOCK_DTOR(PLOCK)    pthread_rwlock_destroy(PLOCK)
 #  define RWLOCK_WLOCK(PLOCK)   pthread_rwlock_wrlock(PLOCK)
+#  define RWLOCK_TRYWLOCK(PLOCK) (pthread_rwlock_trywrlock(PLOCK)==0)
 #  define RWLOCK_WUNLOCK(PLOCK) pthread_rwlock_unlock(PLOCK)
 #  define RWLOCK_RLOCK(PLOCK)   pthread_rwlock_rdlock(PLOCK)
+#  define RWLOCK_TRYRLOCK(PLOCK) (pthread_rwlock_tryrdlock(PLOCK)==0)
 #  define RWLOCK_RUNLOCK(PLOCK) pthread_rwlock_unlock(PLOCK)
 #endif
 
 class RWLock
 {
     RWLOCK_TYPE lock;
+    LockProfile* const prof = nullptr;
+
+    // state of one (profiled) reader or writer
+    struct Held {
+        bool contended = false;
+        uint64_t wait = 0u;
+        uint64_t acquired = 0u;
+        inline void release(LockProfile* prof) {
+            if(prof)
+                lockProfileSample(prof, contended, wait, monotonicNS() - acquired);
+        }
+    };
 public:
     inline RWLock() { RWLOCK_INIT(&lock); }
+    //! Profiled when enabled.  cf. ProfiledMutex
+    inline explicit RWLock(const char* name) :prof(lockProfileFor(name)) { RWLOCK_INIT(&lock); }
     inline ~RWLock() { RWLOCK_DTOR(&lock); }
 
     RWLock(const RWLock&) = delete;
@@ -186,19 +296,47 @@ public:
     RWLock& operator=(RWLock&&) = delete;
 
     struct UnlockReader {
-        inline void operator()(RWLock *plock) { RWLOCK_RUNLOCK(&plock->lock); }
+        Held held;
+        inline void operator()(RWLock *plock) {
+            held.release(plock->prof);
+            RWLOCK_RUNLOCK(&plock->lock);
+        }
     };
     inline std::unique_ptr<RWLock, UnlockReader> lockReader() {
-        RWLOCK_RLOCK(&lock);
-        return std::unique_ptr<RWLock, UnlockReader>{this};
+        UnlockReader U;
+        if(!prof) {
+            RWLOCK_RLOCK(&lock);
+        } else if(!RWLOCK_TRYRLOCK(&lock)) {
+            U.held.contended = true;
+            auto start(monotonicNS());
+            RWLOCK_RLOCK(&lock);
+            U.held.wait = monotonicNS() - start;
+        }
+        if(prof)
+            U.held.acquired = monotonicNS();
+        return std::unique_ptr<RWLock, UnlockReader>{this, U};
     }
 
     struct UnlockWriter {
-        inline void operator()(RWLock *plock) { RWLOCK_WUNLOCK(&plock->lock); }
+        Held held;
+        inline void operator()(RWLock *plock) {
+            held.release(plock->prof);
+            RWLOCK_WUNLOCK(&plock->lock);
+        }
     };
     inline std::unique_ptr<RWLock, UnlockWriter> lockWriter() {
-        RWLOCK_WLOCK(&lock);
-        return std::unique_ptr<RWLock, UnlockWriter>{this};
+        UnlockWriter U;
+        if(!prof) {
+            RWLOCK_WLOCK(&lock);
+        } else if(!RWLOCK_TRYWLOCK(&lock)) {
+            U.held.contended = true;
+            auto start(monotonicNS());
+            RWLOCK_WLOCK(&lock);
+            U.held.wait = monotonicNS() - start;
+        }
+        if(prof)
+            U.held.acquired = monotonicNS();
+        return std::unique_ptr<RWLock, UnlockWriter>{this, U};
     }
 };
 
@@ -206,12 +344,62 @@ public:
 #undef RWLOCK_INIT
 #undef RWLOCK_DTOR
 #undef RWLOCK_WLOCK
+#undef RWLOCK_TRYWLOCK
 #undef RWLOCK_WUNLOCK
 #undef RWLOCK_RLOCK
+#undef RWLOCK_TRYRLOCK
 #undef RWLOCK_RUNLOCK
 
+//! @returns false if the account is not known, in which case roles includes only the account name.
+PVXS_API
+bool osdGetRoles(const std::string& account, std::set<std::string>& roles);
+
+//! Name of the local account with this numeric user ID.  @returns false if not known.
+PVXS_API
+bool osdGetAccount(int64_t uid, std::string& account);
+
+/* Process wide cache of osdGetRoles(), with lookups made by a worker thread.
+ * Entries expire after $PVXS_ROLE_CACHE_TTL seconds (default 300),
+ * or $PVXS_ROLE_CACHE_NEGATIVE_TTL (default 30) for unknown accounts.
+ * Expired entries are used for up to another TTL while being refreshed.
+ * A TTL of zero disables the cache.
+ */
+struct RoleCacheStats {
+    //! roleCacheGet() answered from cache
+    uint64_t hits = 0u;
+    //! hits answered from an expired entry, while it is refreshed
+    uint64_t stale = 0u;
+    //! roleCacheGet() which waited for a lookup
+    uint64_t misses = 0u;
+    //! lookups which did not find the account
+    uint64_t unknown = 0u;
+    //! current number of cache entries
+    size_t entries = 0u;
+    //! time spent in osdGetRoles()
+    TimeHistogram lookup;
+};
+
+//! Begin lookup if not cached.  Does not wait.
+PVXS_API
+void roleCachePrefetch(const std::string& account);
+
+//! Add cached roles, waiting for lookup if necessary.
+PVXS_API
+void roleCacheGet(const std::string& account, std::set<std::string>& roles);
+
+PVXS_API
+RoleCacheStats roleCacheSnapshot(bool zero=false);
+
+//! Counters of asynchronous logging.  cf. $PVXS_LOG_ASYNC
+struct LogAsyncStats {
+    //! messages moved to errlog
+    uint64_t written = 0u;
+    //! messages discarded while the ring buffer of the logging thread was full
+    uint64_t dropped = 0u;
+};
+
 PVXS_API
-void osdGetRoles(const std::string& account, std::set<std::string>& roles);
+LogAsyncStats logAsyncSnapshot();
 
 void logger_shutdown();
 
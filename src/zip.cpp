@@ -0,0 +1,238 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <string.h>
+
+#include <pvxs/log.h>
+
+#include "zip.h"
+
+namespace pvxs {
+namespace impl {
+
+DEFINE_LOGGER(logzip, "pvxs.zip");
+
+namespace {
+
+constexpr size_t minMatch = 4u;
+constexpr unsigned tableBits = 14u;
+
+// evaluate CPU budget after this interval
+constexpr uint64_t periodNS = 1000000000u;
+// after exceeding, stop compressing for this interval
+constexpr uint64_t suspendNS = 10000000000u;
+
+inline
+uint32_t hash4(const uint8_t* p)
+{
+    uint32_t v;
+    memcpy(&v, p, 4u);
+    return (v*2654435761u)>>(32u-tableBits);
+}
+
+inline
+void putVar(std::vector<uint8_t>& out, size_t v)
+{
+    while(v>=0x80u) {
+        out.push_back(uint8_t(v|0x80u));
+        v >>= 7u;
+    }
+    out.push_back(uint8_t(v));
+}
+
+inline
+size_t getVar(const uint8_t* in, size_t nin, size_t& ip)
+{
+    size_t ret = 0u;
+    for(unsigned shift=0u; shift<8u*sizeof(size_t); shift+=7u) {
+        if(ip>=nin)
+            break;
+        auto b = in[ip++];
+        ret |= size_t(b&0x7fu)<<shift;
+        if(!(b&0x80u))
+            return ret;
+    }
+    throw std::runtime_error("Truncated varint");
+}
+
+void putSeq(std::vector<uint8_t>& out, const uint8_t* lit, size_t nlit, size_t offset, size_t mlen)
+{
+    size_t mcode = mlen ? mlen-minMatch : 0u;
+    out.push_back(uint8_t((std::min(nlit, size_t(15u))<<4u) | std::min(mcode, size_t(15u))));
+    if(nlit>=15u)
+        putVar(out, nlit-15u);
+    out.insert(out.end(), lit, lit+nlit);
+    if(mlen) {
+        putVar(out, offset);
+        if(mcode>=15u)
+            putVar(out, mcode-15u);
+    }
+}
+
+} // namespace
+
+ZipEncoder::ZipEncoder(size_t threshold, double budget)
+    :threshold(threshold)
+    ,budget(budget)
+    ,table(size_t(1u)<<tableBits, 0u)
+{}
+
+bool ZipEncoder::encode(std::vector<uint8_t>& out, const uint8_t* in, size_t nin)
+{
+    if(nin < threshold || nin < 2u*minMatch)
+        return false;
+
+    const auto T0 = monotonicNS();
+    if(T0 < suspendUntil)
+        return false;
+
+    // Only trim once past twice the window, to amortize moving the history.
+    if(hist.size() > 2u*window) {
+        auto excess = hist.size() - window;
+        hist.erase(hist.begin(), hist.begin()+excess);
+        histBase += excess;
+    }
+    const size_t start = hist.size();
+    // matches may not reach further back than the decoder is sure to keep
+    const size_t low = start > window ? start - window : 0u;
+    hist.insert(hist.end(), in, in+nin);
+
+    const uint8_t * const base = hist.data();
+    const size_t end = hist.size();
+
+    out.clear();
+    out.reserve(nin);
+
+    bool ok = true;
+    size_t ip = start, anchor = start;
+    while(ip + minMatch <= end) {
+        // table entries are stream position+1.  Zero for empty.
+        // Stale, or aliased, entries are caught by comparison.
+        auto& ent = table[hash4(base+ip)];
+        const uint32_t dist = uint32_t(histBase + ip + 1u) - ent;
+        const bool valid = ent && dist && dist<=ip-low;
+        ent = uint32_t(histBase + ip + 1u);
+
+        if(valid && memcmp(base+ip-dist, base+ip, minMatch)==0) {
+            size_t len = minMatch;
+            while(ip+len<end && base[ip-dist+len]==base[ip+len])
+                len++;
+
+            putSeq(out, base+anchor, ip-anchor, dist, len);
+            ip += len;
+            anchor = ip;
+
+            if(out.size() >= nin) {
+                ok = false;
+                break;
+            }
+
+        } else {
+            // step faster through incompressible regions
+            ip += 1u + ((ip-anchor)>>5u);
+        }
+    }
+    if(ok) {
+        putSeq(out, base+anchor, end-anchor, 0u, 0u);
+        ok = out.size() < nin;
+    }
+
+    if(!ok) {
+        // not compressible by itself.  Send as literals so that this body
+        // is still part of the history, and a repeat will compress.
+        out.clear();
+        putSeq(out, base+start, nin, 0u, 0u);
+    }
+
+    const auto T1 = monotonicNS();
+    nTime += T1-T0;
+    nIn += nin;
+    nOut += out.size();
+
+    // adapt
+    if(!periodStart)
+        periodStart = T0;
+    periodTime += T1-T0;
+    periodIn += nin;
+    periodOut += out.size();
+
+    if(T1 - periodStart >= periodNS) {
+        const bool overBudget = double(periodTime) > budget*double(T1 - periodStart);
+        const bool poorRatio = periodOut*10u > periodIn*9u; // saves less than 10%
+        if(overBudget || poorRatio) {
+            suspendUntil = T1 + suspendNS;
+            nSuspend++;
+            log_debug_printf(logzip, "Suspend compression%s%s\n",
+                             overBudget ? " over CPU budget" : "",
+                             poorRatio ? " poor ratio" : "");
+        }
+        periodStart = T1;
+        periodTime = periodIn = periodOut = 0u;
+    }
+
+    return true;
+}
+
+const uint8_t* ZipDecoder::decode(const uint8_t* in, size_t nin, size_t nout)
+{
+    // Keep at least window bytes.  Only trim once twice that, so that the
+    // cost of moving the remaining history is amortized over many messages.
+    if(hist.size() > 2u*ZipEncoder::window)
+        hist.erase(hist.begin(), hist.end()-ZipEncoder::window);
+
+    const size_t start = hist.size();
+    // do not trust nout for allocation
+    hist.reserve(start + std::min(nout, nin*16u));
+
+    size_t ip = 0u;
+    while(ip < nin) {
+        const auto token = in[ip++];
+
+        size_t nlit = token>>4u;
+        if(nlit==15u)
+            nlit += getVar(in, nin, ip);
+        if(nlit > nin-ip || nlit > nout-(hist.size()-start))
+            throw std::runtime_error("Literal overflow");
+        hist.insert(hist.end(), in+ip, in+ip+nlit);
+        ip += nlit;
+
+        if(ip==nin)
+            break; // final literals
+
+        const size_t offset = getVar(in, nin, ip);
+        size_t mlen = (token&0xfu);
+        if(mlen==15u)
+            mlen += getVar(in, nin, ip);
+        mlen += minMatch;
+
+        if(offset==0u || offset > hist.size())
+            throw std::runtime_error("Invalid match offset");
+        if(mlen > nout-(hist.size()-start))
+            throw std::runtime_error("Match overflow");
+
+        const size_t to = hist.size();
+        const size_t from = to-offset;
+        hist.resize(to+mlen);
+        auto p = hist.data();
+        // An overlapping match (offset < mlen) repeats the last offset bytes.
+        // Copy in pieces of at most offset bytes, which never overlap.
+        for(size_t n=0u; n<mlen;) {
+            auto piece = std::min(mlen-n, offset);
+            memcpy(p+to+n, p+from+n, piece);
+            n += piece;
+        }
+    }
+
+    if(hist.size()-start != nout)
+        throw std::runtime_error("Length mismatch");
+
+    return hist.data()+start;
+}
+
+}} // namespace pvxs::impl
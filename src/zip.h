@@ -0,0 +1,91 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+#ifndef ZIP_H
+#define ZIP_H
+
+#include <vector>
+
+#include "utilpvt.h"
+
+namespace pvxs {
+namespace impl {
+
+/* Compression of server to client message bodies.
+ *
+ * Negotiated per connection when both peers are pvxs.
+ *   - Server includes "x-pvxs-zip" in its CONNECTION_VALIDATION auth list (ignored by others)
+ *   - Client prepares to decode, and sends CMD_PVXS_ZIP ZipRequest
+ *   - Server may now send any message body as CMD_PVXS_ZIPPED
+ *
+ * CMD_PVXS_ZIPPED body is uint8_t original command, uint32_t original body length,
+ * followed by a sequence of LZ77 style tokens.
+ *
+ *   uint8_t (literal count)<<4 | (match length-4), either nibble 15 continued as varint
+ *   [varint literal count-15]
+ *   literal bytes
+ *   varint match offset           (omitted for final literals)
+ *   [varint match length-4-15]
+ *
+ * Match offsets may reach back into previous compressed message bodies
+ * on the same connection, up to window bytes.  So successive updates of
+ * slowly changing values compress well.  Both peers maintain an identical
+ * history of the original bodies of all CMD_PVXS_ZIPPED messages.
+ */
+
+struct PVXS_API ZipEncoder {
+    enum op_t : uint8_t {
+        ZipRequest = 0,
+    };
+
+    //! History of previous message bodies which may be referenced
+    static constexpr size_t window = 256u*1024u;
+
+    //! Bodies with fewer bytes than this are sent as is
+    const size_t threshold;
+    //! Fraction of wall time which may be spent compressing
+    const double budget;
+
+    // cumulative statistics of compressed messages
+    uint64_t nIn = 0u, nOut = 0u; // bytes
+    uint64_t nTime = 0u; // ns spent in encode(), including unsuccessful
+    uint64_t nSuspend = 0u; // number of times budget exceeded
+
+private:
+    std::vector<uint8_t> hist;
+    uint64_t histBase = 0u; // stream position of hist[0]
+    std::vector<uint32_t> table;
+
+    // adaptive state
+    uint64_t periodStart = 0u, periodTime = 0u, periodIn = 0u, periodOut = 0u;
+    uint64_t suspendUntil = 0u;
+public:
+
+    ZipEncoder(size_t threshold, double budget);
+
+    /** Compress nin bytes to out.
+     *
+     * @returns false if the body should be sent as is.  Too small, or compression
+     *          is currently suspended after exceeding the CPU budget or for poor ratio.
+     *          out may be slightly larger than nin for an incompressible body.
+     */
+    bool encode(std::vector<uint8_t>& out, const uint8_t* in, size_t nin);
+};
+
+struct PVXS_API ZipDecoder {
+private:
+    std::vector<uint8_t> hist;
+public:
+    /** Expand nin bytes, which must decode to exactly nout bytes.
+     *
+     * @returns pointer to nout bytes valid until the next call.
+     * @throws std::runtime_error if the input is not valid.
+     */
+    const uint8_t* decode(const uint8_t* in, size_t nin, size_t nout);
+};
+
+}} // namespace pvxs::impl
+
+#endif // ZIP_H
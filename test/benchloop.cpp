@@ -0,0 +1,335 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+/* Loopback end-to-end monitor benchmark.
+ *
+ * Runs an isolated Server and some client Contexts in this process,
+ * and measures monitor update throughput and post() to pop() latency
+ * while sweeping over some parameters.  Results are printed as JSON.
+ *
+ *   benchloop -p 1,10 -s 1,4 -n 1,1024,65536 -P 0,1 -B 0,1 -T 2 -o result.json
+ */
+#define PVXS_ENABLE_EXPERT_API
+
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <atomic>
+
+#include <epicsTime.h>
+#include <epicsThread.h>
+#include <epicsEvent.h>
+#include <epicsGetopt.h>
+
+#include <pvxs/client.h>
+#include <pvxs/server.h>
+#include <pvxs/sharedpv.h>
+#include <pvxs/log.h>
+#include <pvxs/util.h>
+
+#include <utilpvt.h>
+
+using namespace pvxs;
+
+DEFINE_LOGGER(app, "benchloop");
+
+namespace {
+
+struct Case {
+    size_t npv = 1u;
+    size_t nsub = 1u;
+    size_t nelem = 1u;
+    bool pipeline = false;
+    bool serverBE = false;
+};
+
+struct Result {
+    uint64_t updates = 0u;
+    uint64_t bytes = 0u;
+    double seconds = 0.0;
+    TimeHistogram latency;
+};
+
+// per client Context.  Only accessed from that Context's worker while running
+struct Subscriber {
+    client::Context ctxt;
+    std::vector<std::shared_ptr<client::Subscription>> subs;
+    uint64_t updates = 0u;
+    uint64_t bytes = 0u;
+    TimeHistogram latency;
+};
+
+Value buildProto()
+{
+    using namespace pvxs::members;
+    return TypeDef(TypeCode::Struct, {
+                       UInt64("posted"), // epicsMonotonicGet() at post()
+                       UInt32A("value"),
+                   }).create();
+}
+
+Result runCase(const Case& c, double duration)
+{
+    auto proto(buildProto());
+
+    std::vector<server::SharedPV> pvs;
+    auto src(server::StaticSource::build());
+    for(auto i : range(c.npv)) {
+        pvs.push_back(server::SharedPV::buildReadonly());
+        pvs.back().open(proto.cloneEmpty());
+        src.add(SB()<<"bench:"<<i, pvs.back());
+    }
+
+    auto serv(server::Config::isolated()
+              .overrideSendBE(c.serverBE)
+              .build()
+              .addSource("bench", src.source())
+              .start());
+
+    std::atomic<bool> measuring{false};
+    std::atomic<size_t> nready{0u};
+    const size_t nexpect = c.npv*c.nsub;
+    epicsEvent ready;
+
+    std::vector<std::unique_ptr<Subscriber>> subscribers;
+    for(auto s : range(c.nsub)) {
+        (void)s;
+        subscribers.emplace_back(new Subscriber);
+        auto sub = subscribers.back().get();
+        sub->ctxt = serv.clientConfig().build();
+
+        for(auto i : range(c.npv)) {
+            auto first(std::make_shared<bool>(true));
+            sub->subs.push_back(sub->ctxt.monitor(SB()<<"bench:"<<i)
+                                .record("pipeline", c.pipeline)
+                                .record("queueSize", 4)
+                                .maskConnected(true)
+                                .maskDisconnected(true)
+                                .event([sub, first, &measuring, &nready, &ready, nexpect](client::Subscription& mon) {
+                while(true) {
+                    Value val;
+                    try {
+                        val = mon.pop();
+                    }catch(std::exception& e){
+                        log_warn_printf(app, "%s error %s\n", mon.name().c_str(), e.what());
+                        continue;
+                    }
+                    if(!val)
+                        break;
+
+                    if(*first) {
+                        *first = false;
+                        if(++nready==nexpect)
+                            ready.signal();
+                    }
+
+                    if(!measuring.load(std::memory_order_relaxed))
+                        continue;
+
+                    auto now(epicsMonotonicGet());
+                    auto posted(val["posted"].as<uint64_t>());
+                    sub->updates++;
+                    sub->bytes += val["value"].as<shared_array<const uint32_t>>().size()*4u;
+                    if(posted && now>=posted)
+                        sub->latency.sample(now - posted);
+                }
+            })
+                                .exec());
+        }
+    }
+
+    uint32_t count = 0u;
+    auto post = [&pvs, &proto, &count, &c]() {
+        for(auto& pv : pvs) {
+            shared_array<uint32_t> arr(c.nelem, count++);
+            auto update(proto.cloneEmpty());
+            update["value"] = arr.freeze();
+            update["posted"] = epicsMonotonicGet();
+            pv.post(update);
+        }
+    };
+
+    // initial update to each subscription
+    post();
+    if(!ready.wait(10.0))
+        throw std::runtime_error(SB()<<"Timeout waiting for "<<nexpect<<" subscriptions, have "<<nready.load());
+
+    Result ret;
+    measuring = true;
+    auto start(epicsMonotonicGet());
+    auto end = start + uint64_t(duration*1e9);
+    uint64_t now;
+    while((now = epicsMonotonicGet()) < end) {
+        post();
+        epicsThreadSleep(0.0); // yield
+    }
+    measuring = false;
+    ret.seconds = double(now - start)*1e-9;
+
+    for(auto& sub : subscribers) {
+        // cancel() waits for any in-progress callback
+        for(auto& mon : sub->subs)
+            mon->cancel();
+        ret.updates += sub->updates;
+        ret.bytes += sub->bytes;
+        ret.latency += sub->latency;
+    }
+
+    return ret;
+}
+
+template<typename T>
+bool parse_list(std::vector<T>& out, const char *s)
+{
+    out.clear();
+    std::istringstream strm(s);
+    std::string ent;
+    while(std::getline(strm, ent, ',')) {
+        std::istringstream estrm(ent);
+        T val;
+        if((estrm>>val).fail() || !estrm.eof())
+            return true;
+        out.push_back(val);
+    }
+    return out.empty();
+}
+
+int help(int ret, const char* argv0)
+{
+    std::cerr<<
+    "Usage: "<<argv0<<" [-h] [-T <sec>] [-p <#pv,...>] [-s <#sub,...>] [-n <#elem,...>] [-P <0|1,...>] [-B <0|1,...>] [-o <file.json>]\n"
+    "\n"
+    "    -h             Show this message\n"
+    "    -T <sec>       Duration of each case.  (default 1.0)\n"
+    "    -p <#pv,...>   List of PV counts.  (default 1,10)\n"
+    "    -s <#sub,...>  List of subscriber (client Context) counts.  (default 1,4)\n"
+    "    -n <#elem,...> List of array lengths.  (default 1,1024,65536)\n"
+    "    -P <0|1,...>   List of monitor pipeline settings.  (default 0,1)\n"
+    "    -B <0|1,...>   List of server send byte order.  1 for big endian.  (default 0,1)\n"
+    "    -o <file>      Write JSON results to file instead of stdout.\n"
+    ;
+    std::cerr.flush();
+    return ret;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    logger_config_env();
+
+    double duration = 1.0;
+    std::vector<size_t> npvs{1u, 10u}, nsubs{1u, 4u}, nelems{1u, 1024u, 65536u};
+    std::vector<unsigned> pipelines{0u, 1u}, orders{0u, 1u};
+    std::string outfile;
+
+    int opt;
+    while((opt = getopt(argc, argv, "hT:p:s:n:P:B:o:")) != -1) {
+        bool bad = false;
+        switch (opt) {
+        case 'h':
+            return help(0, argv[0]);
+        default:
+            std::cerr<<"Unknown argument -"<<char(opt)<<std::endl;
+            return 1;
+        case 'T':
+            duration = std::atof(optarg);
+            bad = !(duration > 0.0);
+            break;
+        case 'p':
+            bad = parse_list(npvs, optarg);
+            break;
+        case 's':
+            bad = parse_list(nsubs, optarg);
+            break;
+        case 'n':
+            bad = parse_list(nelems, optarg);
+            break;
+        case 'P':
+            bad = parse_list(pipelines, optarg);
+            break;
+        case 'B':
+            bad = parse_list(orders, optarg);
+            break;
+        case 'o':
+            outfile = optarg;
+            break;
+        }
+        if(bad) {
+            std::cerr<<"Unable to parse -"<<char(opt)<<" "<<optarg<<std::endl;
+            return 1;
+        }
+    }
+
+    std::ofstream fout;
+    if(!outfile.empty()) {
+        fout.open(outfile);
+        if(!fout.is_open()) {
+            std::cerr<<"Unable to open "<<outfile<<std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = outfile.empty() ? std::cout : fout;
+
+    out<<"{\n"
+         "  \"version\": \""<<version_str()<<"\",\n"
+         "  \"duration\": "<<duration<<",\n"
+         "  \"results\": [";
+
+    bool first = true;
+    int ret = 0;
+    for(auto npv : npvs) {
+        for(auto nsub : nsubs) {
+            for(auto nelem : nelems) {
+                for(auto pipeline : pipelines) {
+                    for(auto order : orders) {
+                        Case c;
+                        c.npv = npv;
+                        c.nsub = nsub;
+                        c.nelem = nelem;
+                        c.pipeline = pipeline;
+                        c.serverBE = order;
+
+                        log_info_printf(app, "Case npv=%zu nsub=%zu nelem=%zu pipeline=%u BE=%u\n",
+                                        npv, nsub, nelem, pipeline, order);
+
+                        Result R;
+                        try {
+                            R = runCase(c, duration);
+                        }catch(std::exception& e){
+                            log_err_printf(app, "Case error: %s\n", e.what());
+                            ret = 2;
+                            continue;
+                        }
+
+                        out<<(first ? "\n" : ",\n")
+                           <<"    {\"npv\": "<<npv
+                           <<", \"nsub\": "<<nsub
+                           <<", \"nelem\": "<<nelem
+                           <<", \"pipeline\": "<<(pipeline ? "true" : "false")
+                           <<", \"serverBE\": "<<(order ? "true" : "false")
+                           <<",\n     \"updates\": "<<R.updates
+                           <<", \"seconds\": "<<R.seconds
+                           <<", \"updatesPerSec\": "<<(double(R.updates)/R.seconds)
+                           <<", \"MBPerSec\": "<<(double(R.bytes)/R.seconds*1e-6)
+                           <<",\n     \"latency\": {\"mean\": "<<R.latency.mean()
+                           <<", \"p50\": "<<R.latency.quantile(0.5)
+                           <<", \"p99\": "<<R.latency.quantile(0.99)
+                           <<", \"max\": "<<(double(R.latency.longest)*1e-9)
+                           <<"}}";
+                        out.flush();
+                        first = false;
+                    }
+                }
+            }
+        }
+    }
+
+    out<<"\n  ]\n}\n";
+
+    return ret;
+}
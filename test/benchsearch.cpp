@@ -0,0 +1,196 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+/* Loopback name server search benchmark.
+ *
+ * Runs an isolated Server with many PVs, and a client Context which
+ * searches only through that Server as a name server (search over TCP).
+ * Measures the time to connect all channels.  Results are printed as JSON.
+ *
+ *   benchsearch -n 1000,100000 -o result.json
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <atomic>
+
+#include <epicsTime.h>
+#include <epicsEvent.h>
+#include <epicsGetopt.h>
+
+#include <pvxs/client.h>
+#include <pvxs/server.h>
+#include <pvxs/sharedpv.h>
+#include <pvxs/nt.h>
+#include <pvxs/log.h>
+
+#include <utilpvt.h>
+
+using namespace pvxs;
+
+DEFINE_LOGGER(app, "benchsearch");
+
+namespace {
+
+double runCase(size_t npv, double timeout)
+{
+    auto pv(server::SharedPV::buildReadonly());
+    pv.open(nt::NTScalar{TypeCode::UInt32}.create());
+
+    // every name maps to the same PV
+    auto src(server::StaticSource::build());
+    for(auto i : range(npv))
+        src.add(SB()<<"bench:search:"<<i, pv);
+
+    auto serv(server::Config::isolated()
+              .build()
+              .addSource("bench", src.source())
+              .start());
+
+    auto cliconf(serv.clientConfig());
+    for(auto& addr : cliconf.addressList)
+        cliconf.nameServers.push_back(SB()<<addr<<':'<<cliconf.tcp_port);
+    cliconf.autoAddrList = false;
+    cliconf.addressList.clear();
+
+    auto cli(cliconf.build());
+
+    std::atomic<size_t> nconn{0u};
+    epicsEvent done;
+
+    std::vector<std::shared_ptr<client::Connect>> conns;
+    conns.reserve(npv);
+
+    auto start(epicsMonotonicGet());
+
+    for(auto i : range(npv)) {
+        conns.push_back(cli.connect(SB()<<"bench:search:"<<i)
+                        .onConnect([&nconn, &done, npv]() {
+                            if(++nconn==npv)
+                                done.signal();
+                        })
+                        .exec());
+    }
+    cli.hurryUp();
+
+    if(!done.wait(timeout))
+        throw std::runtime_error(SB()<<"Timeout with "<<nconn.load()<<" of "<<npv<<" connected");
+
+    auto seconds = double(epicsMonotonicGet() - start)*1e-9;
+
+    conns.clear();
+    return seconds;
+}
+
+template<typename T>
+bool parse_list(std::vector<T>& out, const char *s)
+{
+    out.clear();
+    std::istringstream strm(s);
+    std::string ent;
+    while(std::getline(strm, ent, ',')) {
+        std::istringstream estrm(ent);
+        T val;
+        if((estrm>>val).fail() || !estrm.eof())
+            return true;
+        out.push_back(val);
+    }
+    return out.empty();
+}
+
+int help(int ret, const char* argv0)
+{
+    std::cerr<<
+    "Usage: "<<argv0<<" [-h] [-w <sec>] [-n <#pv,...>] [-o <file.json>]\n"
+    "\n"
+    "    -h             Show this message\n"
+    "    -w <sec>       Timeout for each case.  (default 60.0)\n"
+    "    -n <#pv,...>   List of PV counts.  (default 1000,10000,100000)\n"
+    "    -o <file>      Write JSON results to file instead of stdout.\n"
+    ;
+    std::cerr.flush();
+    return ret;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    logger_config_env();
+
+    double timeout = 60.0;
+    std::vector<size_t> npvs{1000u, 10000u, 100000u};
+    std::string outfile;
+
+    int opt;
+    while((opt = getopt(argc, argv, "hw:n:o:")) != -1) {
+        bool bad = false;
+        switch (opt) {
+        case 'h':
+            return help(0, argv[0]);
+        default:
+            std::cerr<<"Unknown argument -"<<char(opt)<<std::endl;
+            return 1;
+        case 'w':
+            timeout = std::atof(optarg);
+            bad = !(timeout > 0.0);
+            break;
+        case 'n':
+            bad = parse_list(npvs, optarg);
+            break;
+        case 'o':
+            outfile = optarg;
+            break;
+        }
+        if(bad) {
+            std::cerr<<"Unable to parse -"<<char(opt)<<" "<<optarg<<std::endl;
+            return 1;
+        }
+    }
+
+    std::ofstream fout;
+    if(!outfile.empty()) {
+        fout.open(outfile);
+        if(!fout.is_open()) {
+            std::cerr<<"Unable to open "<<outfile<<std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = outfile.empty() ? std::cout : fout;
+
+    out<<"{\n"
+         "  \"version\": \""<<version_str()<<"\",\n"
+         "  \"results\": [";
+
+    bool first = true;
+    int ret = 0;
+    for(auto npv : npvs) {
+        log_info_printf(app, "Case npv=%zu\n", npv);
+
+        double seconds;
+        try {
+            seconds = runCase(npv, timeout);
+        }catch(std::exception& e){
+            log_err_printf(app, "Case error: %s\n", e.what());
+            ret = 2;
+            continue;
+        }
+
+        out<<(first ? "\n" : ",\n")
+           <<"    {\"npv\": "<<npv
+           <<", \"seconds\": "<<seconds
+           <<", \"namesPerSec\": "<<(double(npv)/seconds)
+           <<"}";
+        out.flush();
+        first = false;
+    }
+
+    out<<"\n  ]\n}\n";
+
+    return ret;
+}
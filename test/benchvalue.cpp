@@ -0,0 +1,370 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+/* Microbenchmarks of Value operations.
+ *
+ * Each case is calibrated to run a batch of iterations lasting at least ~100us,
+ * then warmed up, then timed for a number of repetitions.  The distribution
+ * of per-iteration time over these repetitions is reported.
+ *
+ *   benchvalue -o baseline.txt           # save results
+ *   ... change something, rebuild ...
+ *   benchvalue -c baseline.txt -t 0.1    # compare medians, fail on >10% regression
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <functional>
+
+#include <epicsTime.h>
+#include <epicsGetopt.h>
+
+#include <pvxs/data.h>
+#include <pvxs/nt.h>
+
+#include "pvaproto.h"
+#include "dataimpl.h"
+#include <utilpvt.h>
+
+using namespace pvxs;
+
+namespace {
+
+struct Stats {
+    size_t batch = 0u;
+    // nanoseconds per iteration
+    double min = 0.0, median = 0.0, p90 = 0.0, p99 = 0.0;
+};
+
+struct Bench {
+    size_t reps = 50u;
+    size_t warmup = 10u;
+    std::string filter;
+    std::map<std::string, Stats> results;
+
+    static
+    uint64_t timeBatch(const std::function<void()>& fn, size_t batch)
+    {
+        auto start(epicsMonotonicGet());
+        for(size_t i=0; i<batch; i++)
+            fn();
+        return epicsMonotonicGet() - start;
+    }
+
+    void run(const std::string& name, const std::function<void()>& fn)
+    {
+        if(!filter.empty() && name.find(filter)==std::string::npos)
+            return;
+
+        Stats S;
+
+        // calibrate batch size to amortize clock overhead
+        S.batch = 1u;
+        while(timeBatch(fn, S.batch) < 100000u && S.batch < (1u<<24u))
+            S.batch *= 2u;
+
+        for(size_t i=0; i<warmup; i++)
+            (void)timeBatch(fn, S.batch);
+
+        std::vector<double> samples(reps);
+        for(auto& samp : samples)
+            samp = double(timeBatch(fn, S.batch))/S.batch;
+
+        std::sort(samples.begin(), samples.end());
+        auto at = [&samples](double q) -> double {
+            return samples[std::min(samples.size()-1u, size_t(q*samples.size()))];
+        };
+        S.min = samples.front();
+        S.median = at(0.5);
+        S.p90 = at(0.9);
+        S.p99 = at(0.99);
+
+        {
+            Restore R(std::cout);
+            std::cout<<std::left<<std::setw(32)<<name<<std::right<<std::fixed<<std::setprecision(1)
+                     <<" min="<<std::setw(10)<<S.min
+                     <<" median="<<std::setw(10)<<S.median
+                     <<" p90="<<std::setw(10)<<S.p90
+                     <<" p99="<<std::setw(10)<<S.p99
+                     <<" ns  (batch "<<S.batch<<")\n";
+        }
+
+        results[name] = S;
+    }
+};
+
+// serialize as a monitor update
+std::vector<uint8_t> encodeValid(const Value& val)
+{
+    std::vector<uint8_t> wire(0x1000);
+    VectorOutBuf S(true, wire);
+    to_wire_valid(S, val);
+    if(!S.good())
+        throw std::logic_error("to_wire_valid() fails");
+    wire.resize(S.consumed());
+    return wire;
+}
+
+// Exercise common operations on a Value of some shape.
+// "full" should have some fields marked, which are assumed to be sent in a monitor update.
+void benchShape(Bench& B, const std::string& shape, const Value& full, const char* lookup)
+{
+    {
+        Value val(full);
+        B.run(shape+"/lookup", [&val, lookup]() {
+            (void)val[lookup];
+        });
+    }
+
+    B.run(shape+"/cloneEmpty", [&full]() {
+        (void)full.cloneEmpty();
+    });
+
+    B.run(shape+"/clone", [&full]() {
+        (void)full.clone();
+    });
+
+    {
+        auto dest(full.cloneEmpty());
+        B.run(shape+"/assign", [&dest, &full]() {
+            dest.assign(full);
+        });
+    }
+
+    {
+        auto val(full.clone());
+        B.run(shape+"/mark_unmark", [&val]() {
+            val.mark();
+            val.unmark(false, true);
+        });
+    }
+
+    B.run(shape+"/to_wire_valid", [&full]() {
+        (void)encodeValid(full);
+    });
+
+    {
+        // independent of the to_wire_valid case, which may be filtered out
+        auto wire(encodeValid(full));
+        TypeStore ctxt;
+        auto val(full.cloneEmpty());
+        B.run(shape+"/from_wire_valid", [&wire, &ctxt, &val]() {
+            FixedBuf S(true, wire);
+            from_wire_valid(S, ctxt, val);
+            if(!S.good())
+                throw std::logic_error("from_wire_valid() fails");
+        });
+    }
+
+    {
+        auto cache(full.clone());
+        auto delta(full.cloneEmpty());
+        delta["timeStamp.nanoseconds"] = 1234;
+        B.run(shape+"/cache_sync", [&cache, &delta]() {
+            cache_sync(cache, delta);
+        });
+    }
+}
+
+void benchAll(Bench& B)
+{
+    {
+        auto val(nt::NTScalar{TypeCode::Float64, true, true, true}.create());
+        val["value"] = 42.0;
+        val["alarm.severity"] = 1;
+        val["alarm.message"] = "High";
+        val["timeStamp.secondsPastEpoch"] = 1234567890;
+        val["display.units"] = "mm";
+        benchShape(B, "NTScalar", val, "display.units");
+    }
+
+    {
+        auto val(nt::NTEnum{}.create());
+        shared_array<std::string> choices(16u);
+        for(auto i : range(choices.size()))
+            choices[i] = SB()<<"State"<<i;
+        val["value.index"] = 3;
+        val["value.choices"] = choices.freeze();
+        val["timeStamp.secondsPastEpoch"] = 1234567890;
+        benchShape(B, "NTEnum", val, "value.index");
+    }
+
+    {
+        constexpr size_t nrow = 100u;
+        auto val(nt::NTTable{}
+                 .add_column(TypeCode::String, "name")
+                 .add_column(TypeCode::Float64, "x")
+                 .add_column(TypeCode::Float64, "y")
+                 .add_column(TypeCode::Int32, "flags")
+                 .create());
+        shared_array<std::string> name(nrow);
+        shared_array<double> x(nrow), y(nrow);
+        shared_array<int32_t> flags(nrow);
+        for(auto i : range(nrow)) {
+            name[i] = SB()<<"row"<<i;
+            x[i] = i;
+            y[i] = -double(i);
+            flags[i] = i;
+        }
+        val["value.name"] = name.freeze();
+        val["value.x"] = x.freeze();
+        val["value.y"] = y.freeze();
+        val["value.flags"] = flags.freeze();
+        val["timeStamp.secondsPastEpoch"] = 1234567890;
+        benchShape(B, "NTTable", val, "value.flags");
+    }
+
+    {
+        auto val(nt::NTNDArray{}.create());
+        shared_array<uint16_t> pixels(256u*256u);
+        for(auto i : range(pixels.size()))
+            pixels[i] = i;
+        val["value"] = pixels.freeze().castTo<const void>();
+        shared_array<Value> dims(2u);
+        for(auto& dim : dims) {
+            dim = val["dimension"].allocMember();
+            dim["size"] = 256;
+        }
+        val["dimension"] = dims.freeze();
+        val["uniqueId"] = 1;
+        val["timeStamp.secondsPastEpoch"] = 1234567890;
+        benchShape(B, "NTNDArray", val, "codec.name");
+    }
+}
+
+bool saveResults(const std::string& fname, const std::map<std::string, Stats>& results)
+{
+    std::ofstream out(fname);
+    if(!out.is_open())
+        return false;
+    out<<"# name median_ns\n";
+    for(auto& pair : results)
+        out<<pair.first<<' '<<pair.second.median<<'\n';
+    return out.good();
+}
+
+// returns number of regressions
+size_t compareResults(const std::string& fname, const std::map<std::string, Stats>& results, double threshold)
+{
+    std::ifstream inp(fname);
+    if(!inp.is_open())
+        throw std::runtime_error(SB()<<"Unable to open baseline "<<fname);
+
+    size_t nregress = 0u;
+    std::string line;
+    while(std::getline(inp, line)) {
+        if(line.empty() || line[0]=='#')
+            continue;
+        std::istringstream strm(line);
+        std::string name;
+        double base;
+        if((strm>>name>>base).fail()) {
+            std::cerr<<"Ignoring invalid baseline line: "<<line<<"\n";
+            continue;
+        }
+
+        auto it(results.find(name));
+        if(it==results.end())
+            continue;
+
+        double ratio = it->second.median/base;
+        bool regress = ratio > 1.0+threshold;
+        if(regress)
+            nregress++;
+
+        Restore R(std::cout);
+        std::cout<<std::left<<std::setw(32)<<name<<std::right<<std::fixed<<std::setprecision(1)
+                 <<" baseline="<<std::setw(10)<<base
+                 <<" now="<<std::setw(10)<<it->second.median
+                 <<std::setprecision(2)<<" ratio="<<ratio
+                 <<(regress ? "  REGRESSION" : "")<<"\n";
+    }
+    return nregress;
+}
+
+int help(int ret, const char* argv0)
+{
+    std::cerr<<
+    "Usage: "<<argv0<<" [-h] [-r <reps>] [-w <warmup>] [-f <filter>] [-o <save.txt>] [-c <baseline.txt>] [-t <threshold>]\n"
+    "\n"
+    "    -h               Show this message\n"
+    "    -r <reps>        Number of timed repetitions of each case.  (default 50)\n"
+    "    -w <warmup>      Number of untimed repetitions before timing.  (default 10)\n"
+    "    -f <filter>      Only run cases with names containing this string.\n"
+    "    -o <save.txt>    Save median times to file for later comparison.\n"
+    "    -c <baseline>    Compare median times with previously saved file.\n"
+    "    -t <threshold>   Fractional increase in median time flagged as a regression.  (default 0.1)\n"
+    "\n"
+    "Exit code 1 when a regression is found.\n"
+    ;
+    std::cerr.flush();
+    return ret;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Bench B;
+    std::string savefile, basefile;
+    double threshold = 0.1;
+
+    int opt;
+    while((opt = getopt(argc, argv, "hr:w:f:o:c:t:")) != -1) {
+        switch (opt) {
+        case 'h':
+            return help(0, argv[0]);
+        default:
+            std::cerr<<"Unknown argument -"<<char(opt)<<std::endl;
+            return 2;
+        case 'r':
+            B.reps = std::max(1, std::atoi(optarg));
+            break;
+        case 'w':
+            B.warmup = std::max(0, std::atoi(optarg));
+            break;
+        case 'f':
+            B.filter = optarg;
+            break;
+        case 'o':
+            savefile = optarg;
+            break;
+        case 'c':
+            basefile = optarg;
+            break;
+        case 't':
+            threshold = std::atof(optarg);
+            break;
+        }
+    }
+
+    try {
+        benchAll(B);
+
+        if(!savefile.empty() && !saveResults(savefile, B.results)) {
+            std::cerr<<"Error writing "<<savefile<<std::endl;
+            return 2;
+        }
+
+        if(!basefile.empty()) {
+            auto nregress = compareResults(basefile, B.results, threshold);
+            if(nregress) {
+                std::cerr<<nregress<<" regression(s) exceed threshold "<<threshold<<std::endl;
+                return 1;
+            }
+        }
+    }catch(std::exception& e){
+        std::cerr<<"Error: "<<e.what()<<std::endl;
+        return 2;
+    }
+
+    return 0;
+}
@@ -24,12 +24,15 @@
 namespace {
 using namespace pvxs;
 
-void dotest()
+void dotest(double searchReplyHold)
 {
+    testDiag("%s(%g)", __func__, searchReplyHold);
+
     auto proto(nt::NTScalar{}.create());
 
-    auto server(server::Config::isolated()
-                .build());
+    auto conf(server::Config::isolated());
+    conf.searchReplyHold = searchReplyHold;
+    auto server(conf.build());
 
     std::vector<server::SharedPV> pvs(1000u);
 
@@ -72,10 +75,11 @@ void dotest()
 
 MAIN(test1000)
 {
-    testPlan(1000);
+    testPlan(2000);
     testSetup();
     logger_config_env();
-    dotest();
+    dotest(0.0);
+    dotest(0.05); // aggregate search replies
     cleanup_for_valgrind();
     return testDone();
 }
@@ -4,9 +4,13 @@
  * in file LICENSE that is included with this distribution.
  */
 
+#define PVXS_ENABLE_EXPERT_API
+
 #include <testMain.h>
 
 #include <epicsUnitTest.h>
+#include <epicsEnv.h>
+#include <epicsThread.h>
 
 #include <pvxs/unittest.h>
 #include <pvxs/log.h>
@@ -98,6 +102,28 @@ void test_call()
     testFalse(internal.tryCall([](){}));
 }
 
+void test_stall()
+{
+    testDiag("%s", __func__);
+
+    evbase base("TESTSTALL");
+    testEq(base.name(), "TESTSTALL");
+
+    base.call([](){
+        epicsThreadSleep(0.1);
+    });
+    base.call([](){});
+
+    TimeHistogram callbacks;
+    uint64_t stalls = 0u;
+    testTrue(base.stats(callbacks, stalls, true));
+    testEq(callbacks.count, 2u);
+    testEq(stalls, 1u);
+
+    testTrue(base.stats(callbacks, stalls, false));
+    testEq(callbacks.count, 0u);
+}
+
 void test_fill_evbuf()
 {
     testDiag("%s", __func__);
@@ -146,10 +172,13 @@ void test_fill_evbuf()
 
 MAIN(testev)
 {
+    // must be set before first evbase is created
+    epicsEnvSet("PVXS_LOOP_STALL_THRESHOLD", "0.05");
     SockAttach attach;
-    testPlan(20);
+    testPlan(26);
     testSetup();
     test_call();
+    test_stall();
     test_fill_evbuf();
     cleanup_for_valgrind();
     return testDone();
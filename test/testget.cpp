@@ -6,6 +6,7 @@
 #define PVXS_ENABLE_EXPERT_API
 
 #include <atomic>
+#include <vector>
 
 #include <testMain.h>
 
@@ -22,6 +23,11 @@
 #include <pvxs/nt.h>
 #include "evhelper.h"
 
+#ifdef PVXS_HAVE_AF_UNIX
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
 namespace {
 using namespace pvxs;
 
@@ -142,6 +148,14 @@ struct Tester {
         };
         checkReport(sreport);
         checkReport(creport);
+
+        if(!creport.connections.empty() && !creport.connections.front().channels.empty()) {
+            auto& timing = creport.connections.front().channels.front().timing;
+            testEq(timing.connect.count, 1u);
+            testEq(timing.rtt.count, 1u);
+        } else {
+            testSkip(2, "No client channel report");
+        }
     }
 
     void testWaiter()
@@ -478,6 +492,66 @@ struct ErrorSource : public server::Source
     }
 };
 
+// counts GET executions
+struct CountSource : public server::Source
+{
+    const Value type;
+    std::atomic<unsigned> nget{0u};
+    CountSource()
+        :type(nt::NTScalar{TypeCode::Int32}.create().update("value", 42))
+    {}
+
+    virtual void onSearch(Search &op) override final
+    {
+        for(auto& name : op) {
+            name.claim();
+        }
+    }
+    virtual void onCreate(std::unique_ptr<server::ChannelControl> &&op) override final
+    {
+        auto chan = std::move(op);
+
+        chan->onOp([this](std::unique_ptr<server::ConnectOp>&& op) {
+            op->onGet([this](std::unique_ptr<server::ExecOp>&& op) {
+                nget++;
+                op->reply(type.clone());
+            });
+            op->connect(type);
+        });
+    }
+};
+
+void testCoalesce()
+{
+    testShow()<<__func__;
+
+    auto src(std::make_shared<CountSource>());
+    auto serv = server::Config::isolated()
+            .build()
+            .addSource("count", src)
+            .start();
+
+    auto cli = serv.clientConfig().build();
+
+    // issued before the channel connects, so all join the first
+    std::vector<std::shared_ptr<client::Operation>> ops;
+    for(size_t i=0u; i<4u; i++)
+        ops.push_back(cli.get("pv").exec());
+    auto solo(cli.get("pv").coalesce(false).exec());
+
+    cli.hurryUp();
+
+    std::vector<Value> vals;
+    for(auto& op : ops)
+        vals.push_back(op->wait(5.0));
+
+    testEq(solo->wait(5.0)["value"].as<int32_t>(), 42);
+    testEq(vals.front()["value"].as<int32_t>(), 42);
+    testEq(vals.back()["value"].as<int32_t>(), 42);
+    testTrue(!vals[0].equalInst(vals[1]))<<" each GET has its own Value";
+    testEq(src->nget.load(), 2u)<<" one shared GET, and one not";
+}
+
 void testError(bool phase)
 {
     testShow()<<__func__<<" phase="<<phase;
@@ -512,11 +586,60 @@ void testError(bool phase)
     }
 }
 
+void testUnix()
+{
+    testShow()<<__func__;
+#ifdef PVXS_HAVE_AF_UNIX
+    const char path[] = "testget.sock";
+
+    {
+        auto mbox(server::SharedPV::buildReadonly());
+        mbox.open(nt::NTScalar{TypeCode::Int32}.create().update("value", 42));
+
+        auto conf(server::Config::isolated());
+        conf.unixPath = path;
+        auto serv(conf.build()
+                  .addPV("mailbox", mbox)
+                  .start());
+
+        auto cli(serv.clientConfig().build());
+
+        auto val(cli.get("mailbox")
+                 .server(SB()<<"unix:"<<path)
+                 .exec()->wait(5.0));
+        testEq(val["value"].as<int32_t>(), 42);
+
+        // identified by client process, not by claimed credentials
+        auto report(serv.report(false));
+        std::shared_ptr<const server::ClientCredentials> cred;
+        if(report.connections.size()==1u)
+            cred = report.connections.front().credentials;
+        testTrue(!!cred);
+#ifdef __linux__
+        if(cred) {
+            testTrue(cred->peer.find(SB()<<",pid="<<getpid()<<",uid="<<getuid())!=std::string::npos)
+                    <<" "<<cred->peer;
+            testEq(cred->method, "ca");
+        } else {
+            testSkip(2, "No connection");
+        }
+#else
+        testSkip(2, "No peer credentials");
+#endif
+    }
+
+    struct stat info;
+    testTrue(stat(path, &info)!=0)<<" socket removed";
+#else
+    testSkip(5, "No AF_UNIX");
+#endif
+}
+
 } // namespace
 
 MAIN(testget)
 {
-    testPlan(62);
+    testPlan(74);
     testSetup();
     logger_config_env();
     const bool canIPv6 = pvxs::impl::evsocket::canIPv6;
@@ -537,8 +660,10 @@ MAIN(testget)
     Tester().badRequest();
     Tester().delayExec();
     Tester().ordering();
+    testCoalesce();
     testError(false);
     testError(true);
+    testUnix();
     cleanup_for_valgrind();
     return testDone();
 }
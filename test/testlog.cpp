@@ -4,14 +4,20 @@
  * in file LICENSE that is included with this distribution.
  */
 
+// elide log_debug_printf() in this file
+#define PVXS_LOG_MAX_LEVEL 40
+
 #include <ostream>
 
 #include <testMain.h>
 #include <epicsUnitTest.h>
+#include <epicsThread.h>
 #include <envDefs.h>
+#include <errlog.h>
 
 #include <pvxs/unittest.h>
 #include <pvxs/log.h>
+#include "utilpvt.h"
 
 namespace pvxs {
 
@@ -100,13 +106,84 @@ void testEnv()
     testEq(envc.lvl.load(), Level::Debug);
 }
 
+DEFINE_LOGGER(elide, "test.elide");
+
+void testElide()
+{
+    testDiag("%s", __func__);
+
+    logger_level_set("test.elide", Level::Debug);
+    testTrue(elide.test(Level::Debug));
+
+    unsigned count = 0u;
+    eltc(0);
+    log_debug_printf(elide, "compiled out %u\n", ++count);
+    testEq(count, 0u);
+    log_info_printf(elide, "not compiled out %u\n", ++count);
+    eltc(1);
+    testEq(count, 1u);
+}
+
+DEFINE_LOGGER(logasync, "test.async");
+
+// each thread logs into its own ring
+struct LogSpammer : public epicsThreadRunable
+{
+    // much larger than one ring
+    static constexpr unsigned count = 10000u;
+    epicsThread worker;
+    LogSpammer()
+        :worker(*this, "logspammer", epicsThreadGetStackSize(epicsThreadStackBig))
+    {
+        worker.start();
+    }
+
+    void run() override final {
+        for(auto i : range(count))
+            log_info_printf(logasync, "message %u\n", i);
+    }
+};
+
+// must be last, as this shuts down logging
+void testAsync()
+{
+    testDiag("%s", __func__);
+
+    logger_level_set("test.async", Level::Info);
+
+    // let the worker move any earlier messages
+    epicsThreadSleep(0.2);
+    auto before(impl::logAsyncSnapshot());
+
+    eltc(0);
+    {
+        // more producers than the one worker can keep up with
+        LogSpammer A, B, C, D;
+    }
+
+    // flush on exit
+    cleanup_for_valgrind();
+    errlogFlush();
+    eltc(1);
+
+    auto after(impl::logAsyncSnapshot());
+    auto written = after.written - before.written;
+    auto dropped = after.dropped - before.dropped;
+    testEq(written + dropped, uint64_t(4u*LogSpammer::count))<<" written "<<written<<" dropped "<<dropped;
+    testTrue(dropped > 0u)<<" overflowed ring counted";
+}
+
 } // namespace
 
 MAIN(testlog)
 {
-    testPlan(16);
+    testPlan(21);
     testSetup();
+    // before the first logger is initialized
+    epicsEnvSet("PVXS_LOG_ASYNC", "YES");
     testLog();
     testEnv();
+    testElide();
+    testAsync();
     return testDone();
 }
@@ -13,6 +13,7 @@
 #include <epicsUnitTest.h>
 
 #include <epicsEvent.h>
+#include <epicsThread.h>
 
 #include <pvxs/unittest.h>
 #include <pvxs/log.h>
@@ -25,6 +26,17 @@
 namespace {
 using namespace pvxs;
 
+server::Config isolatedConf(bool latencyStats, const char* statsPV)
+{
+    auto conf(server::Config::isolated());
+    conf.latencyStats = latencyStats;
+    if(statsPV) {
+        conf.statsPV = statsPV;
+        conf.statsPeriod = 0.1;
+    }
+    return conf;
+}
+
 struct BasicTest {
     Value initial;
     server::SharedPV mbox;
@@ -34,10 +46,10 @@ struct BasicTest {
     epicsEvent evt;
     std::shared_ptr<client::Subscription> sub;
 
-    BasicTest()
+    explicit BasicTest(bool latencyStats=false, const char* statsPV=nullptr)
         :initial(nt::NTScalar{TypeCode::Int32}.create())
         ,mbox(server::SharedPV::buildReadonly())
-        ,serv(server::Config::isolated()
+        ,serv(isolatedConf(latencyStats, statsPV)
               .build()
               .addPV("mailbox", mbox))
         ,cli(serv.clientConfig().build())
@@ -359,11 +371,105 @@ struct TestReconn : public BasicTest
     }
 };
 
+struct TestLatency : public BasicTest
+{
+    TestLatency() :BasicTest(true) {}
+
+    void testReport()
+    {
+        testShow()<<__func__;
+
+        serv.start();
+        mbox.open(initial);
+        subscribe("mailbox");
+
+        cli.hurryUp();
+
+        testThrows<client::Connected>([this](){
+            pop(sub, evt);
+        });
+
+        if(auto val = pop(sub, evt)) {
+            testEq(val["value"].as<int32_t>(), 42);
+        } else {
+            testFail("Missing data update");
+        }
+
+        post(123);
+
+        if(auto val = pop(sub, evt)) {
+            testEq(val["value"].as<int32_t>(), 123);
+        } else {
+            testFail("Missing data update 2");
+        }
+
+        // both updates have been received, so both have been sent
+        auto report(serv.report());
+        testShow()<<"Queue "<<report.latency.queue<<"\nSend "<<report.latency.send;
+
+        testOk(report.latency.queue.count>=2u, "queue count %u", unsigned(report.latency.queue.count));
+        testOk(report.latency.send.count>=2u, "send count %u", unsigned(report.latency.send.count));
+
+        if(testEq(report.connections.size(), 1u)) {
+            auto& conn = report.connections.front();
+            testEq(conn.latency.queue.count, report.latency.queue.count);
+            if(testEq(conn.channels.size(), 1u)) {
+                auto& chan = conn.channels.front();
+                testEq(chan.latency.queue.count, report.latency.queue.count);
+            }
+        }
+
+        // previous report() zeroed counters
+        testEq(serv.report().latency.queue.count, 0u);
+
+        client::SubscriptionStat stat;
+        sub->stats(stat);
+        testEq(stat.decode.count, 2u);
+        testEq(stat.interArrival.count, 1u);
+    }
+};
+
+struct TestStats : public BasicTest
+{
+    TestStats() :BasicTest(false, "TEST:stats") {}
+
+    void testPV()
+    {
+        testShow()<<__func__;
+
+        serv.start();
+        mbox.open(initial);
+        subscribe("mailbox");
+
+        cli.hurryUp();
+
+        testThrows<client::Connected>([this](){
+            pop(sub, evt);
+        });
+        (void)pop(sub, evt);
+
+        // allow a few updates with the subscription in place
+        epicsThreadSleep(0.5);
+
+        auto val(cli.get("TEST:stats").exec()->wait(5.0));
+        testShow()<<val;
+
+        auto peer(val["value.peer"].as<shared_array<const std::string>>());
+        auto nmon(val["value.monitor"].as<shared_array<const uint64_t>>());
+        if(testEq(peer.size(), 2u) && testEq(nmon.size(), 2u)) {
+            testEq(peer[1], "*");
+            testEq(nmon[0], 1u);
+            testEq(nmon[1], 1u);
+        }
+        testTrue(val["instances.name"].as<shared_array<const std::string>>().size()>0u);
+    }
+};
+
 } // namespace
 
 MAIN(testmon)
 {
-    testPlan(41);
+    testPlan(60);
     testSetup();
     try{
         logger_config_env();
@@ -377,6 +483,8 @@ MAIN(testmon)
         TestLifeCycle().testDelta();
         TestReconn().testReconn(false);
         TestReconn().testReconn(true);
+        TestLatency().testReport();
+        TestStats().testPV();
     }catch(std::exception& e) {
         testFail("Unhandled exception %s : %s", typeid(e).name(), e.what());
         throw;
@@ -4,12 +4,15 @@
  * in file LICENSE that is included with this distribution.
  */
 
+#include <cstring>
+
 #include <testMain.h>
 
 #include <epicsUnitTest.h>
 
 #include <pvxs/unittest.h>
 #include <pvxs/nt.h>
+#include "utilpvt.h"
 
 namespace {
 
@@ -55,6 +58,75 @@ void testNTNDArray()
     testTrue(top.idStartsWith("epics:nt/NTNDArray:"))<<"\n"<<top;
 }
 
+void testNTNDArrayCodec()
+{
+    testDiag("In %s", __func__);
+
+    // large enough to be divided between threads
+    shared_array<uint16_t> pixels(1024u*1024u);
+    for(auto i : range(pixels.size()))
+        pixels[i] = uint16_t(1000u + (i%1024u)/4u + (i/1024u)%3u);
+    auto expect(pixels.freeze());
+
+    auto img(nt::NTNDArray{}.create());
+    img["value->ushortValue"] = expect;
+
+    nt::NTNDArray::compress(img, "lz4", 4u);
+
+    testEq(img["codec.name"].as<std::string>(), "lz4");
+    testEq(img["codec.parameters"].as<int32_t>(), 3); // NDUInt16
+    testEq(img["uncompressedSize"].as<uint64_t>(), expect.size()*2u);
+    testTrue(img["compressedSize"].as<uint64_t>() < expect.size())
+            <<" compressed to "<<img["compressedSize"].as<uint64_t>();
+    testEq(img["value"].as<shared_array<const void>>().original_type(), ArrayType::UInt8);
+
+    nt::NTNDArray::decompress(img);
+
+    testEq(img["codec.name"].as<std::string>(), "");
+    auto actual(img["value"].as<shared_array<const void>>());
+    testEq(actual.original_type(), ArrayType::UInt16);
+    testArrEq(actual.castTo<const uint16_t>(), expect);
+
+    shared_array<double> values(1000u);
+    for(auto i : range(values.size()))
+        values[i] = i/8.0;
+    auto dexpect(values.freeze());
+
+    img["value->doubleValue"] = dexpect;
+    nt::NTNDArray::compress(img, "lz4", 1u);
+    nt::NTNDArray::decompress(img);
+
+    actual = img["value"].as<shared_array<const void>>();
+    testEq(actual.original_type(), ArrayType::Float64);
+    testArrEq(actual.castTo<const double>(), dexpect);
+
+    // from reference implementation
+    const uint8_t ref[] = "\xaf\x4e\x54\x4e\x44\x41\x72\x72\x61\x79\x20\x0a\x00\x33\xf0\x01"
+                          "\x00\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0a\x0b\x0c\x0d\x0e\x0f";
+    img["value->ubyteValue"] = shared_array<const uint8_t>(ref, ref+sizeof(ref)-1u);
+    img["codec.name"] = "lz4";
+    img["codec.parameters"] = 1; // NDUInt8
+    img["uncompressedSize"] = 96u;
+
+    nt::NTNDArray::decompress(img);
+    auto bytes(img["value"].as<shared_array<const uint8_t>>());
+    testEq(bytes.size(), 96u);
+    testTrue(bytes.size()==96u
+             && std::memcmp(bytes.data(), "NTNDArray NTNDArray NTNDArray NTNDArray "
+                                          "NTNDArray NTNDArray NTNDArray NTNDArray ", 80u)==0
+             && bytes[80]==0u && bytes[95]==15u);
+
+    img["value->ubyteValue"] = shared_array<const uint8_t>(ref, ref+16u);
+    img["codec.name"] = "lz4";
+    testThrows<std::runtime_error>([&img]() {
+        nt::NTNDArray::decompress(img);
+    })<<" truncated";
+
+    testThrows<std::logic_error>([&img]() {
+        nt::NTNDArray::compress(img, "jpeg");
+    })<<" unsupported codec";
+}
+
 void testNTURI()
 {
     testDiag("In %s", __func__);
@@ -108,9 +180,10 @@ void testNTTable()
 } // namespace
 
 MAIN(testnt) {
-    testPlan(22);
+    testPlan(36);
     testNTScalar();
     testNTNDArray();
+    testNTNDArrayCodec();
     testNTURI();
     testNTEnum();
     testNTTable();
@@ -0,0 +1,198 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+
+#include <testMain.h>
+
+#include <epicsUnitTest.h>
+#include <epicsThread.h>
+
+#include <pvxs/unittest.h>
+#include <pvxs/log.h>
+#include <pvxs/client.h>
+#include <pvxs/server.h>
+#include <pvxs/sharedpv.h>
+#include <pvxs/nt.h>
+#include "utilpvt.h"
+
+namespace {
+using namespace pvxs;
+
+// proxy updates are asynchronous.  Poll for expected value
+int32_t getUntil(client::Context& ctxt, const char *name, int32_t expect)
+{
+    int32_t actual = -1;
+    for(auto i : range(50)) {
+        (void)i;
+        actual = ctxt.get(name).exec()->wait(5.0)["value"].as<int32_t>();
+        if(actual==expect)
+            break;
+        epicsThreadSleep(0.1);
+    }
+    return actual;
+}
+
+void testProxy()
+{
+    testDiag("%s", __func__);
+
+    auto pva(server::SharedPV::buildMailbox());
+    auto pvb(server::SharedPV::buildMailbox());
+    {
+        auto initial(nt::NTScalar{TypeCode::Int32}.create());
+        initial["value"] = 1;
+        pva.open(initial);
+        pvb.open(initial);
+    }
+
+    auto upstream(server::Config::isolated().build()
+                  .addPV("pv:a", pva)
+                  .addPV("pv:b", pvb)
+                  .start());
+
+    auto proxy(server::ProxySource::build(upstream.clientConfig().build(), 1u));
+
+    auto srv(server::Config::isolated().build()
+             .addSource("proxy", proxy.source())
+             .start());
+
+    auto cli1(srv.clientConfig().build());
+    auto cli2(srv.clientConfig().build());
+
+    testEq(getUntil(cli1, "pv:a", 1), 1);
+
+    {
+        auto initial(nt::NTScalar{TypeCode::Int32}.create());
+        initial["value"] = 2;
+        pva.post(initial);
+    }
+
+    testEq(getUntil(cli1, "pv:a", 2), 2);
+    testEq(getUntil(cli2, "pv:a", 2), 2);
+
+    {
+        // two downstream clients, one upstream channel
+        auto report(upstream.report());
+        if(testEq(report.connections.size(), 1u)) {
+            testEq(report.connections.front().channels.size(), 1u);
+        } else {
+            testSkip(1, "No upstream connection");
+        }
+    }
+
+    cli2.put("pv:a").set("value", 5).exec()->wait(5.0);
+    testEq(pva.fetch()["value"].as<int32_t>(), 5);
+
+    testEq(getUntil(cli1, "pv:b", 1), 1);
+
+    {
+        auto list(proxy.list());
+        testTrue(list.size()==2u && list["pv:a"] && list["pv:b"]);
+    }
+
+    // downstream disconnect leaves two idle entries.  One is evicted.
+    cli1 = client::Context();
+    cli2 = client::Context();
+
+    size_t nentries = 0u;
+    for(auto i : range(50)) {
+        (void)i;
+        nentries = proxy.list().size();
+        if(nentries==1u)
+            break;
+        epicsThreadSleep(0.1);
+    }
+    testEq(nentries, 1u);
+}
+
+// More names than maxIdle, found concurrently, and names which are never found.
+void testManyNames()
+{
+    testDiag("%s", __func__);
+
+    constexpr size_t npvs = 6u;
+    auto upconf(server::Config::isolated());
+    auto upbuild(upconf.build());
+    std::vector<server::SharedPV> pvs;
+    for(auto i : range(npvs)) {
+        auto pv(server::SharedPV::buildReadonly());
+        auto initial(nt::NTScalar{TypeCode::Int32}.create());
+        initial["value"] = int32_t(i);
+        pv.open(initial);
+        upbuild.addPV(SB()<<"many:"<<i, pv);
+        pvs.push_back(pv);
+    }
+    auto upstream(upbuild.start());
+
+    auto proxy(server::ProxySource::build(upstream.clientConfig().build(), 1u, 8u));
+
+    auto srv(server::Config::isolated().build()
+             .addSource("proxy", proxy.source())
+             .start());
+
+    {
+        auto cli(srv.clientConfig().build());
+
+        // all searching at once.  Connecting entries do not count against maxIdle
+        std::vector<std::shared_ptr<client::Operation>> ops;
+        for(auto i : range(npvs))
+            ops.push_back(cli.get(SB()<<"many:"<<i).exec());
+
+        bool ok = true;
+        for(auto i : range(npvs)) {
+            try {
+                ok &= ops[i]->wait(5.0)["value"].as<int32_t>()==int32_t(i);
+            }catch(std::exception& e){
+                testDiag("many:%u error %s", unsigned(i), e.what());
+                ok = false;
+            }
+        }
+        testTrue(ok)<<" concurrent GET of "<<npvs<<" names with maxIdle=1";
+
+        // search for names which upstream does not have
+        std::vector<std::shared_ptr<client::Connect>> conns;
+        for(auto i : range(20u))
+            conns.push_back(cli.connect(SB()<<"missing:"<<i).exec());
+
+        size_t nentries = 0u;
+        for(auto i : range(50)) {
+            (void)i;
+            nentries = proxy.list().size();
+            if(nentries >= 8u)
+                break;
+            epicsThreadSleep(0.1);
+        }
+        // 6 in use, plus at most 8 pending
+        testTrue(nentries >= 8u && nentries <= npvs + 8u)<<" entries "<<nentries;
+    }
+
+    // downstream disconnect.  One idle entry remains, plus any pending
+    size_t nready = 0u;
+    for(auto i : range(50)) {
+        (void)i;
+        nready = 0u;
+        for(auto& pair : proxy.list()) {
+            if(pair.first.compare(0u, 5u, "many:")==0)
+                nready++;
+        }
+        if(nready==1u)
+            break;
+        epicsThreadSleep(0.1);
+    }
+    testEq(nready, 1u);
+}
+
+} // namespace
+
+MAIN(testproxy)
+{
+    testPlan(12);
+    testSetup();
+    logger_config_env();
+    testProxy();
+    testManyNames();
+    cleanup_for_valgrind();
+    return testDone();
+}
@@ -267,6 +267,55 @@ struct Tester : public TesterBase
         testOk1(done.wait(5.0));
         testEq(mbox.fetch()["value"].as<uint32_t>(), 124u);
     }
+
+    void pipelineExec()
+    {
+        testShow()<<__func__;
+
+        epicsEvent initd;
+        epicsEvent done;
+        Value top;
+
+        mbox.open(initial);
+        serv.start();
+
+        auto op = cli.put("mailbox")
+                .autoExec(false)
+                .onInit([&initd, &top](const Value& prototype) {
+                    top = prototype;
+                    initd.signal();
+                })
+                .exec();
+
+        testOk1(initd.wait(5.0));
+
+        // several PUTs outstanding, then a GET which must see the last
+        constexpr uint32_t N = 20u;
+        uint32_t nok = 0u;
+
+        for(uint32_t i=0u; i<N; i++) {
+            auto val(top.cloneEmpty());
+            val["value"] = 10u + i;
+            op->reExecPut(val, [&nok](client::Result&& result) {
+                if(!result.error())
+                    nok++;
+            });
+        }
+
+        uint32_t last = 0u;
+        op->reExecGet([&done, &last](client::Result&& result) {
+            if(!result.error())
+                last = result()["value"].as<uint32_t>();
+            done.signal();
+        });
+
+        if(testOk1(done.wait(5.0))) {
+            testEq(nok, N);
+            testEq(last, 10u + N - 1u);
+        } else {
+            testSkip(2, "timeout");
+        }
+    }
 };
 
 struct TestPutBuilder : public TesterBase
@@ -411,7 +460,7 @@ void testError()
 
 MAIN(testput)
 {
-    testPlan(40);
+    testPlan(44);
     testSetup();
     logger_config_env();
     Tester().loopback(false);
@@ -421,6 +470,7 @@ MAIN(testput)
     Tester().cancel();
     Tester().orphan();
     Tester().manualExec();
+    Tester().pipelineExec();
     TestPutBuilder().testSet();
     testRO();
     testError();
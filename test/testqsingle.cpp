@@ -19,6 +19,7 @@
 #include <generalTimeSup.h>
 
 #include "testioc.h"
+#include "qsrvpvt.h"
 #include "utilpvt.h"
 
 #if EPICS_VERSION_INT >= VERSION_INT(3, 15, 0, 2)
@@ -501,6 +502,36 @@ void testPut()
     }catch(pvxs::client::RemoteError& e){
         testStrMatch(".*Field Disabled.*", e.what());
     }
+
+    // later operations through the same connection re-use cached security clients
+    long hits0, misses0;
+    ioc::testqsrvSecurityCacheCounts(hits0, misses0);
+
+    ctxt.put("test:ai").set("value", 54.2).exec()->wait(5.0);
+    testdbGetFieldEqual("test:ai", DBF_DOUBLE, 54.2);
+
+    try{
+        ctxt.put("test:ro").set("value", 43).exec()->wait(5.0);
+        testFail("test:ro was writable");
+    }catch(pvxs::client::RemoteError& e){
+        testStrEq(e.what(), "Put not permitted");
+    }
+
+    long hits1, misses1;
+    ioc::testqsrvSecurityCacheCounts(hits1, misses1);
+    testEq(hits1 - hits0, 2)<<" cached security clients re-used";
+    testEq(misses1 - misses0, 0)<<" no new security clients";
+
+    // (re)loading the ACF discards cached security clients
+    testOk1(!asInit());
+
+    ctxt.put("test:ai").set("value", 55.2).exec()->wait(5.0);
+    testdbGetFieldEqual("test:ai", DBF_DOUBLE, 55.2);
+
+    long hits2, misses2;
+    ioc::testqsrvSecurityCacheCounts(hits2, misses2);
+    testEq(hits2 - hits1, 0)<<" after ACF reload";
+    testEq(misses2 - misses1, 1)<<" security client re-created after ACF reload";
 }
 
 void testGetPut64()
@@ -766,6 +797,52 @@ void testMonitorAI(TestClient& ctxt)
               "valueAlarm.highAlarmLimit double = 100\n"
             )<<" fetch VAL w/ meta-data.  delta output";
 
+    {
+        auto hits = ioc::testqsrvGetCacheHits();
+
+        // answered from the active subscription
+        auto cached(ctxt.get("test:ai").pvRequest("record[cache=true,cacheAge=60]").exec()->wait(5.0));
+        testEq(cached["value"].as<double>(), 5.0);
+        testEq(cached["valueAlarm.highWarningLimit"].as<double>(), 7.0);
+        testEq(ioc::testqsrvGetCacheHits(), hits+1)<<" answered from subscription";
+
+        // zero cacheAge never accepts a subscription update
+        auto uncached(ctxt.get("test:ai").pvRequest("record[cache=true,cacheAge=0]").exec()->wait(5.0));
+        testEq(uncached["value"].as<double>(), 5.0);
+        testEq(ioc::testqsrvGetCacheHits(), hits+1)<<" stale subscription not used";
+
+        // subscription may lag VAL by up to MDEL
+        testdbPutFieldOk("test:ai.MDEL", DBR_DOUBLE, 1.0);
+        uncached = ctxt.get("test:ai").pvRequest("record[cache=true,cacheAge=60]").exec()->wait(5.0);
+        testEq(uncached["value"].as<double>(), 5.0);
+        testEq(ioc::testqsrvGetCacheHits(), hits+1)<<" deadband record not answered from subscription";
+        testdbPutFieldOk("test:ai.MDEL", DBR_DOUBLE, 0.0);
+    }
+
+    sub.testEmpty();
+}
+
+void testMonitorLIDeadband(TestClient& ctxt)
+{
+    testDiag("%s", __func__);
+
+    TestSubscription sub(ctxt.monitor("test:li:mdel")
+                         .maskConnected(true)
+                         .maskDisconnected(true));
+    (void)sub.waitForUpdate();
+
+    auto hits = ioc::testqsrvGetCacheHits();
+
+    // longin MDEL is DBF_LONG
+    auto val(ctxt.get("test:li:mdel").pvRequest("record[cache=true,cacheAge=60]").exec()->wait(5.0));
+    testEq(val["value"].as<int32_t>(), 0);
+    testEq(ioc::testqsrvGetCacheHits(), hits)<<" deadband longin not answered from subscription";
+
+    testdbPutFieldOk("test:li:mdel.MDEL", DBR_LONG, 0);
+    val = ctxt.get("test:li:mdel").pvRequest("record[cache=true,cacheAge=60]").exec()->wait(5.0);
+    testEq(val["value"].as<int32_t>(), 0);
+    testEq(ioc::testqsrvGetCacheHits(), hits+1)<<" answered from subscription";
+
     sub.testEmpty();
 }
 
@@ -874,11 +951,34 @@ void testMonitorAIFilt(TestClient& ctxt)
     sub2.testEmpty();
 }
 
+void testSharedChannel()
+{
+    testDiag("%s", __func__);
+
+    const char unfiltered[] = "test:ai2";
+    const char filtered[] = "test:ai2.VAL{\"dbnd\":{\"d\":1.0}}";
+
+    TestClient ctxt1, ctxt2;
+    std::vector<std::shared_ptr<client::Connect>> conns;
+    for(auto name : {unfiltered, filtered}) {
+        for(auto ctxt : {&ctxt1, &ctxt2}) {
+            // server channel stays open while connected
+            (void)ctxt->get(name).exec()->wait(5.0);
+            conns.push_back(ctxt->connect(name).exec());
+        }
+    }
+
+    // one dbChannel for both clients
+    testEq(ioc::testqsrvSharedChannelUsers(unfiltered), 2);
+    // may have per-channel filter state.  Never shared
+    testEq(ioc::testqsrvSharedChannelUsers(filtered), 0);
+}
+
 } // namespace
 
 MAIN(testqsingle)
 {
-    testPlan(88);
+    testPlan(113);
     testSetup();
     pvxs::logger_config_env();
     generalTimeRegisterCurrentProvider("test", 1, &testTimeCurrent);
@@ -916,9 +1016,11 @@ MAIN(testqsingle)
         testGetPut64();
         testPutProc();
         testPutLog();
+        testSharedChannel();
         {
             TestClient mctxt;
             testMonitorAI(mctxt);
+            testMonitorLIDeadband(mctxt);
             testMonitorBO(mctxt);
             testMonitorAIFilt(mctxt);
         }
@@ -8,6 +8,7 @@
 
 #include <atomic>
 #include <sstream>
+#include <vector>
 
 #include <testMain.h>
 
@@ -228,6 +229,50 @@ struct Tester {
         testEq(result["query.b"].as<std::string>(), "hello");
     }
 
+    void pipeline()
+    {
+        testShow()<<__func__;
+
+        mbox.open(initial);
+        serv.start();
+
+        auto op = cli.rpc("mailbox")
+                .autoExec(false)
+                .exec();
+
+        // queued until INIT completes, then more than maxPipelineExec outstanding
+        constexpr int32_t N = 20;
+        std::vector<int32_t> order;
+        epicsEvent alldone;
+
+        for(auto i : range(N)) {
+            auto arg(initial.cloneEmpty());
+            arg["value"] = i;
+            // callbacks are serialized on the client worker
+            op->reExecRPC(arg, [&order, &alldone](client::Result&& result) {
+                int32_t v = -1;
+                try {
+                    v = result()["value"].as<int32_t>();
+                }catch(std::exception& e){
+                    testDiag("RPC error %s", e.what());
+                }
+                order.push_back(v);
+                if(order.size()==size_t(N))
+                    alldone.signal();
+            });
+        }
+        cli.hurryUp();
+
+        if(testOk1(alldone.wait(5.0))) {
+            bool inorder = true;
+            for(auto i : range(N))
+                inorder &= order[i]==i;
+            testTrue(inorder)<<" results in request order";
+        } else {
+            testSkip(1, "timeout");
+        }
+    }
+
     void orphan()
     {
         testShow()<<__func__;
@@ -276,7 +321,7 @@ struct Tester {
 
 MAIN(testrpc)
 {
-    testPlan(23);
+    testPlan(25);
     testSetup();
     Tester().echo();
     Tester().lazy();
@@ -286,6 +331,7 @@ MAIN(testrpc)
     Tester().error();
     Tester().builder();
     Tester().orphan();
+    Tester().pipeline();
     Tester().serversrc();
     cleanup_for_valgrind();
     return testDone();
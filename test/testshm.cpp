@@ -0,0 +1,240 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+#define PVXS_ENABLE_EXPERT_API
+
+#include <cstring>
+#include <cstdio>
+
+#ifndef _WIN32
+#  include <unistd.h>
+#endif
+
+#include <testMain.h>
+
+#include <epicsUnitTest.h>
+#include <epicsEvent.h>
+
+#include <pvxs/unittest.h>
+#include <pvxs/log.h>
+#include <pvxs/client.h>
+#include <pvxs/server.h>
+#include <pvxs/sharedpv.h>
+#include <pvxs/nt.h>
+
+#include "evhelper.h"
+#include "shm.h"
+
+namespace {
+using namespace pvxs;
+using impl::ShmSegment;
+
+void testSegment()
+{
+    testDiag("%s", __func__);
+#ifndef _WIN32
+    auto seg(ShmSegment::create(1u<<20u));
+    if(!seg) {
+        testSkip(13, "shared memory not supported");
+        return;
+    }
+
+    auto peer(ShmSegment::open(seg->path, seg->size, getpid(), getuid()));
+    testTrue(!!peer)<<" "<<seg->path;
+    if(!peer) {
+        testSkip(12, "Unable to open");
+        return;
+    }
+
+    std::vector<uint8_t> small(16u), large(256u*1024u);
+    for(auto i : range(large.size()))
+        large[i] = uint8_t(i);
+
+    testEq(seg->put(small.data(), small.size()), size_t(-1));
+
+    // first block follows the reference count table
+    auto off1(seg->put(large.data(), large.size()));
+    testEq(off1, seg->ctrlSize);
+
+    // held until the end
+    auto view1(peer->get(off1, large.size()));
+    testTrue(view1 && std::memcmp(view1.get(), large.data(), large.size())==0);
+
+    auto off2(seg->put(large.data(), large.size()));
+    testNotEq(off2, size_t(-1));
+    auto view2(peer->get(off2, large.size()));
+    testTrue(!!view2);
+
+    // never released
+    testNotEq(seg->put(large.data(), large.size()), size_t(-1));
+    testEq(seg->put(large.data(), large.size()), size_t(-1))<<" full";
+
+    // second block is reclaimed while the first is still held
+    view2.reset();
+    testEq(seg->put(large.data(), large.size()), off2)<<" reuse while an earlier block is held";
+
+    testFalse(peer->get(off1 + 8u, large.size()))<<" misaligned";
+    testFalse(peer->get(0u, large.size()))<<" reference count table";
+
+    testFalse(ShmSegment::open(seg->path, seg->size, 1, getuid()))<<" not our peer";
+
+    // a file opened by our peer, but not a memfd
+    std::unique_ptr<FILE, int(*)(FILE*)> regular(tmpfile(), &fclose);
+    if(regular) {
+        if(ftruncate(fileno(regular.get()), off_t(seg->size))!=0)
+            testDiag("ftruncate() error %d", errno);
+        std::string path(SB()<<"/proc/"<<getpid()<<"/fd/"<<fileno(regular.get()));
+        testFalse(ShmSegment::open(path, seg->size, getpid(), getuid()))<<" "<<path;
+    } else {
+        testSkip(1, "no tmpfile()");
+    }
+#else
+    testSkip(13, "shared memory not supported");
+#endif
+}
+
+void testTransport()
+{
+    testDiag("%s", __func__);
+#ifdef PVXS_HAVE_AF_UNIX
+    auto pv(server::SharedPV::buildReadonly());
+    auto initial(nt::NTScalar{TypeCode::UInt32A}.create());
+    shared_array<uint32_t> arr(100000u);
+    for(auto i : range(arr.size()))
+        arr[i] = i;
+    initial["value"] = arr.freeze();
+    pv.open(initial);
+
+    const char path[] = "testshm.sock";
+
+    auto conf(server::Config::isolated());
+    conf.shmSize = 1u<<20u;
+    conf.unixPath = path;
+    auto srv(conf.build()
+             .addPV("arr", pv)
+             .start());
+
+    auto cli(srv.clientConfig().build());
+
+    Value held;
+    for(auto pass : range(4u)) {
+        // check that blocks are reclaimed as replies are dropped, while the first is held
+        // only offered through a local socket
+        auto val(cli.get("arr")
+                 .server(SB()<<"unix:"<<path)
+                 .exec()->wait(5.0));
+        auto result(val["value"].as<shared_array<const uint32_t>>());
+
+        bool match = result.size()==100000u;
+        for(auto i : range(result.size()))
+            match &= result[i]==i;
+        testTrue(match)<<" pass "<<pass;
+
+        if(!held)
+            held = val;
+    }
+
+    // arrays were actually sent through shared memory
+    auto report(srv.report(false));
+    testEq(report.connections.size(), 1u);
+    if(!report.connections.empty()) {
+        testEq(report.connections.front().shmBlocks, 4u);
+    } else {
+        testSkip(1, "No connection");
+    }
+#else
+    testSkip(6, "No local sockets");
+#endif
+}
+
+// cancel subscriptions while updates are in flight.  Their blocks must still be released.
+void testCancelInFlight()
+{
+    testDiag("%s", __func__);
+#ifdef PVXS_HAVE_AF_UNIX
+    auto pv(server::SharedPV::buildReadonly());
+    auto initial(nt::NTScalar{TypeCode::UInt32A}.create());
+    shared_array<uint32_t> arr(100000u);
+    for(auto i : range(arr.size()))
+        arr[i] = i;
+    const auto frozen(arr.freeze());
+    initial["value"] = frozen;
+    pv.open(initial);
+
+    const char path[] = "testshmcancel.sock";
+    const std::string server(SB()<<"unix:"<<path);
+
+    auto conf(server::Config::isolated());
+    // room for only two arrays.  Any leaked blocks soon force inline transfer.
+    conf.shmSize = 1u<<20u;
+    conf.unixPath = path;
+    auto srv(conf.build()
+             .addPV("arr", pv)
+             .start());
+
+    auto cli(srv.clientConfig().build());
+
+    size_t nstarted = 0u;
+    for(auto round : range(8u)) {
+        epicsEvent ready;
+        auto sub(cli.monitor("arr")
+                 .server(server)
+                 .maskConnected(true)
+                 .event([&ready](client::Subscription&) {
+                     ready.signal();
+                 })
+                 .exec());
+
+        Value first;
+        while(!first && ready.wait(5.0))
+            first = sub->pop();
+        if(first)
+            nstarted++;
+        first = Value();
+
+        for(auto i : range(2u)) {
+            (void)i;
+            auto update(initial.cloneEmpty());
+            update["value"] = frozen;
+            pv.post(update);
+        }
+        testDiag("cancel round %u", unsigned(round));
+        sub->cancel();
+    }
+    testEq(nstarted, 8u);
+
+    // replies are ordered after any update still in flight
+    auto before(srv.report(false));
+    for(auto i : range(4u)) {
+        (void)i;
+        (void)cli.get("arr")
+                .server(server)
+                .exec()->wait(5.0);
+    }
+    auto after(srv.report(false));
+
+    if(before.connections.size()==1u && after.connections.size()==1u) {
+        testEq(after.connections.front().shmBlocks - before.connections.front().shmBlocks, 4u);
+    } else {
+        testSkip(1, "No connection");
+    }
+#else
+    testSkip(2, "No local sockets");
+#endif
+}
+
+} // namespace
+
+MAIN(testshm)
+{
+    testPlan(21);
+    testSetup();
+    logger_config_env();
+    testSegment();
+    testTransport();
+    testCancelInFlight();
+    cleanup_for_valgrind();
+    return testDone();
+}
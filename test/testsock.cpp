@@ -92,6 +92,24 @@ void testEndPoint()
     }
 }
 
+void testUnixAddr()
+{
+    testDiag("Enter %s", __func__);
+#ifdef PVXS_HAVE_AF_UNIX
+    SockAddr A("unix:/tmp/a.sock", 5075);
+    testEq(int(A.family()), AF_UNIX);
+    testEq(A.tostring(), "unix:/tmp/a.sock");
+    testTrue(A.isLO());
+
+    SockEndpoint ep("unix:/tmp/b,1@c");
+    testEq(ep.addr.path(), "/tmp/b,1@c");
+
+    testTrue(A < ep.addr && A!=ep.addr && A==SockAddr("unix:/tmp/a.sock"));
+#else
+    testSkip(5, "No AF_UNIX");
+#endif
+}
+
 bool waitReadable(const evsocket& sock, double timeout=5.0)
 {
     pollfd pfd{};
@@ -166,7 +184,7 @@ void test_ifacemap()
 
     auto& ifs = IfaceMap::instance();
 
-    epicsGuard<epicsMutex> G(ifs.lock); // since we are playing around with the internals...
+    epicsGuard<ProfiledMutex> G(ifs.lock); // since we are playing around with the internals...
 
     ifs.refresh(true);
 
@@ -494,9 +512,10 @@ MAIN(testsock)
 {
     SockAttach attach;
     logger_config_env();
-    testPlan(92);
+    testPlan(97);
     testSetup();
     testEndPoint();
+    testUnixAddr();
     // check for behavior when binding ipv4 and ipv6 to the same socket
     // as a function of socket type and order.
     if(evsocket::canIPv6) {
@@ -0,0 +1,129 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+#define PVXS_ENABLE_EXPERT_API
+
+#include <testMain.h>
+
+#include <epicsUnitTest.h>
+#include <epicsEnv.h>
+#include <epicsEvent.h>
+
+#include <pvxs/unittest.h>
+#include <pvxs/log.h>
+#include <pvxs/client.h>
+#include <pvxs/server.h>
+#include <pvxs/sharedpv.h>
+#include <pvxs/nt.h>
+
+#include "evhelper.h"
+#include "iouring.h"
+
+namespace {
+using namespace pvxs;
+
+// larger than the receive buffers and socket buffers, so each reply spans many completions
+constexpr size_t nelem = 1000000u;
+
+shared_array<const uint32_t> makeArray(uint32_t offset)
+{
+    shared_array<uint32_t> arr(nelem);
+    for(auto i : range(arr.size()))
+        arr[i] = uint32_t(i) + offset;
+    return arr.freeze();
+}
+
+bool checkArray(const Value& val, uint32_t offset)
+{
+    auto result(val["value"].as<shared_array<const uint32_t>>());
+    bool match = result.size()==nelem;
+    for(auto i : range(result.size()))
+        match &= result[i]==uint32_t(i) + offset;
+    return match;
+}
+
+bool haveRing()
+{
+    impl::evbase loop("testuring");
+    std::shared_ptr<impl::IOURing> ring;
+    loop.call([&loop, &ring]() {
+        ring = loop.uring();
+    });
+    return !!ring;
+}
+
+void testGetMonitor()
+{
+    testDiag("%s", __func__);
+
+    auto initial(nt::NTScalar{TypeCode::UInt32A}.create());
+    initial["value"] = makeArray(0u);
+    auto pv(server::SharedPV::buildReadonly());
+    pv.open(initial);
+
+    auto srv(server::Config::isolated()
+             .build()
+             .addPV("arr", pv)
+             .start());
+
+    auto cli(srv.clientConfig().build());
+
+    for(auto pass : range(2u)) {
+        auto val(cli.get("arr").exec()->wait(5.0));
+        testTrue(checkArray(val, 0u))<<" get pass "<<pass;
+    }
+
+    epicsEvent evt;
+    auto sub(cli.monitor("arr")
+             .maskConnected(true)
+             .maskDisconnected(false)
+             .event([&evt](client::Subscription&) {
+                 evt.signal();
+             })
+             .exec());
+
+    auto pop = [&sub, &evt]() -> Value {
+        while(true) {
+            if(auto ret = sub->pop())
+                return ret;
+            else if(!evt.wait(5.0))
+                testAbort("timeout waiting for event");
+        }
+    };
+
+    testTrue(checkArray(pop(), 0u))<<" initial update";
+
+    for(auto i : range(1u, 4u)) {
+        auto update(initial.cloneEmpty());
+        update["value"] = makeArray(i);
+        pv.post(update);
+        testTrue(checkArray(pop(), i))<<" update "<<i;
+    }
+
+    // server side close is seen as EOF
+    srv.stop();
+    testThrows<client::Disconnect>([&pop]() {
+        pop();
+    })<<" after server stop";
+}
+
+} // namespace
+
+MAIN(testuring)
+{
+    // must be set before first evbase is created
+    epicsEnvSet("PVXS_EVENT_BACKEND", "io_uring");
+    testPlan(8);
+    testSetup();
+    logger_config_env();
+    if(haveRing()) {
+        testPass("Using io_uring");
+        testGetMonitor();
+    } else {
+        testSkip(8, "io_uring not supported");
+    }
+    cleanup_for_valgrind();
+    return testDone();
+}
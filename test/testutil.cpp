@@ -4,7 +4,10 @@
  * in file LICENSE that is included with this distribution.
  */
 
+#define PVXS_ENABLE_EXPERT_API
+
 #include <vector>
+#include <functional>
 #include <ostream>
 #include <sstream>
 
@@ -13,9 +16,12 @@
 #include <osiProcess.h>
 
 #include <epicsThread.h>
+#include <epicsEvent.h>
+#include <envDefs.h>
 
 #include <pvxs/unittest.h>
 #include <pvxs/util.h>
+#include <pvxs/server.h>
 #include <utilpvt.h>
 
 namespace {
@@ -183,6 +189,44 @@ void testAccount()
     }
 }
 
+void testRoleCache()
+{
+    testShow()<<__func__;
+
+    std::string account;
+    {
+        std::vector<char> buf(128);
+        (void)osiGetUserName(buf.data(), buf.size()-1u);
+        buf.back() = '\0';
+        account = buf.data();
+    }
+
+    std::set<std::string> expect;
+    osdGetRoles(account, expect);
+
+    auto before(roleCacheSnapshot());
+
+    std::set<std::string> first, second;
+    roleCacheGet(account, first);
+    roleCacheGet(account, second);
+
+    testTrue(first==expect)<<" roles of "<<account;
+    testTrue(second==expect);
+
+    auto after(roleCacheSnapshot());
+    testTrue(after.hits > before.hits)<<" hits "<<before.hits<<" -> "<<after.hits;
+
+    // negative caching
+    std::set<std::string> unknown;
+    roleCacheGet("pvxs-no-such-account", unknown);
+    testTrue(unknown==std::set<std::string>{"pvxs-no-such-account"});
+#if !defined(__rtems__) && !defined(vxWorks)
+    testTrue(roleCacheSnapshot().unknown > after.unknown);
+#else
+    testSkip(1, "No account lookup");
+#endif
+}
+
 void testTestEq()
 {
     testShow()<<__func__;
@@ -287,19 +331,134 @@ void testOnce()
     testEq(onceCount[1], 1u);
 }
 
+void testTimeHistogram()
+{
+    testShow()<<__func__;
+
+    TimeHistogram H;
+    testEq(H.quantile(0.5), 0.0);
+    testEq(H.mean(), 0.0);
+
+    H.sample(500u);       // 0.5 us -> [0, 1) us
+    H.sample(1000u);      // 1 us   -> [1, 2) us
+    H.sample(3000u);      // 3 us   -> [2, 4) us
+    H.sample(3500u);      // 3.5 us -> [2, 4) us
+    H.sample(uint64_t(-1)); // overflows into last bucket
+
+    testEq(H.count, 5u);
+    testEq(H.buckets[0], 1u);
+    testEq(H.buckets[1], 1u);
+    testEq(H.buckets[2], 2u);
+    testEq(H.buckets[TimeHistogram::nbuckets-1u], 1u);
+    testEq(H.longest, uint64_t(-1));
+
+    testEq(H.quantile(0.0), 1e-6);
+    testEq(H.quantile(0.5), 4e-6);
+    testEq(H.quantile(1.0), TimeHistogram::limit(TimeHistogram::nbuckets-1u));
+
+    TimeHistogram H2;
+    H2.sample(3000u);
+    H2 += H;
+    testEq(H2.count, 6u);
+    testEq(H2.buckets[2], 3u);
+
+    H2.clear();
+    testEq(H2.count, 0u);
+    testEq(H2.buckets[2], 0u);
+}
+
+// acquire a lock for a while on another thread
+struct LockHolder : public epicsThreadRunable
+{
+    std::function<void()> fn;
+    epicsEvent locked;
+    epicsThread worker;
+    template<typename Lock>
+    explicit LockHolder(Lock&& lock)
+        :fn([this, lock]() {
+            auto G(lock());
+            locked.signal();
+            epicsThreadSleep(0.1);
+        })
+        ,worker(*this, "lockholder", epicsThreadGetStackSize(epicsThreadStackSmall))
+    {
+        worker.start();
+        locked.wait();
+    }
+
+    void run() override final { fn(); }
+};
+
+void testLockProfile()
+{
+    testShow()<<__func__;
+
+    ProfiledMutex mutex("testutil.mutex");
+    {
+        epicsGuard<ProfiledMutex> G(mutex);
+        epicsGuard<ProfiledMutex> R(mutex); // recursive, counted once
+    }
+    {
+        LockHolder H([&mutex]() { return std::unique_ptr<epicsGuard<ProfiledMutex>>(new epicsGuard<ProfiledMutex>(mutex)); });
+        epicsGuard<ProfiledMutex> G(mutex); // waits for holder
+    }
+
+    RWLock rwlock("testutil.rwlock");
+    {
+        LockHolder H([&rwlock]() { return rwlock.lockWriter(); });
+        auto G(rwlock.lockReader()); // waits for writer
+    }
+
+    auto snap(lockProfileSnapshot());
+    {
+        auto& stats = snap["testutil.mutex"];
+        testEq(stats.acquisitions, 3u);
+        testEq(stats.contended, 1u);
+        testEq(stats.wait.count, 1u);
+        testTrue(stats.wait.longest >= 10000000u)<<" waited "<<stats.wait.longest<<" ns";
+    }
+    {
+        auto& stats = snap["testutil.rwlock"];
+        testEq(stats.acquisitions, 2u);
+        testEq(stats.contended, 1u);
+    }
+
+    impl::Report report;
+    lockProfileReport(report, true);
+    uint64_t acquisitions = 0u;
+    for(auto& lock : report.locks) {
+        if(lock.name=="testutil.mutex")
+            acquisitions = lock.acquisitions;
+    }
+    testEq(acquisitions, 3u)<<" in Report::locks";
+    testEq(lockProfileSnapshot()["testutil.mutex"].acquisitions, 0u)<<" after zero";
+
+    auto serv(server::Config::isolated().build());
+    std::ostringstream strm;
+    Detailed D(strm, 2);
+    strm<<serv;
+    testTrue(strm.str().find("Lock testutil.mutex acquired=0 contended=0\n")!=std::string::npos)
+            <<" in show output\n"<<strm.str();
+}
+
 } // namespace
 
 MAIN(testutil)
 {
-    testPlan(35);
+    testPlan(64);
+    // before any lock is created
+    epicsEnvSet("PVXS_LOCK_PROFILE", "YES");
     testTrue(version_abi_check())<<" 0x"<<std::hex<<PVXS_VERSION<<" ~= 0x"<<std::hex<<PVXS_ABI_VERSION;
     testServerGUID();
     testFill();
     testSpam();
     testSpamMany();
     testAccount();
+    testRoleCache();
     testTestEq();
     testStrDiff();
     testOnce();
+    testTimeHistogram();
+    testLockProfile();
     return testDone();
 }
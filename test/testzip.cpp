@@ -0,0 +1,152 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+#define PVXS_ENABLE_EXPERT_API
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <testMain.h>
+
+#include <epicsUnitTest.h>
+
+#include <pvxs/unittest.h>
+#include <pvxs/log.h>
+#include <pvxs/client.h>
+#include <pvxs/server.h>
+#include <pvxs/sharedpv.h>
+#include <pvxs/nt.h>
+
+#include "zip.h"
+
+namespace {
+using namespace pvxs;
+using impl::ZipEncoder;
+using impl::ZipDecoder;
+
+void testCodec()
+{
+    testDiag("%s", __func__);
+
+    ZipEncoder enc(64u, 1.0);
+    ZipDecoder dec;
+    std::vector<uint8_t> out;
+
+    std::vector<uint8_t> small(16u);
+    testFalse(enc.encode(out, small.data(), small.size()))<<" below threshold";
+
+    // pseudo-random, so not compressible by itself
+    std::vector<uint8_t> noise(100000u);
+    uint32_t x = 1u;
+    for(auto& b : noise) {
+        x = x*1103515245u + 12345u;
+        b = uint8_t(x>>24u);
+    }
+
+    for(auto pass : range(3u)) {
+        noise[pass*1000u] ^= 1u;
+
+        testTrue(enc.encode(out, noise.data(), noise.size()))<<" pass "<<pass;
+        auto result(dec.decode(out.data(), out.size(), noise.size()));
+        testTrue(std::memcmp(result, noise.data(), noise.size())==0)<<" pass "<<pass;
+
+        if(pass==0u)
+            testTrue(out.size() <= noise.size()+16u)<<" literal "<<out.size();
+        else // mostly a reference to the previous pass
+            testTrue(out.size() < 1000u)<<" repeat "<<out.size();
+    }
+
+    std::vector<uint8_t> bad({0xf0, 0xff});
+    testThrows<std::runtime_error>([&dec, &bad]() {
+        dec.decode(bad.data(), bad.size(), 100u);
+    })<<" truncated";
+}
+
+// stream well past twice the history window, so both sides trim
+void testLongStream()
+{
+    testDiag("%s", __func__);
+
+    ZipEncoder enc(64u, 1.0);
+    ZipDecoder dec;
+    std::vector<uint8_t> out;
+
+    std::vector<uint8_t> msg(60000u);
+    uint32_t x = 1u;
+    size_t nbad = 0u, nzip = 0u;
+    for(auto i : range(20u)) {
+        // new noise, a run (overlapping match), then a repeat of the noise
+        for(auto j : range(20000u)) {
+            x = x*1103515245u + 12345u;
+            msg[j] = uint8_t(x>>24u);
+        }
+        std::fill(msg.begin()+20000u, msg.begin()+40000u, uint8_t(i));
+        std::copy(msg.begin(), msg.begin()+20000u, msg.begin()+40000u);
+
+        if(!enc.encode(out, msg.data(), msg.size()))
+            continue;
+        nzip++;
+        auto result(dec.decode(out.data(), out.size(), msg.size()));
+        if(std::memcmp(result, msg.data(), msg.size())!=0 || out.size() > 21000u)
+            nbad++;
+    }
+    testEq(nzip, size_t(20u));
+    testEq(nbad, size_t(0u));
+}
+
+void testTransport()
+{
+    testDiag("%s", __func__);
+
+    auto pv(server::SharedPV::buildReadonly());
+    auto initial(nt::NTScalar{TypeCode::Float64A}.create());
+    shared_array<double> arr(20000u);
+    for(auto i : range(arr.size()))
+        arr[i] = std::floor(100.0*std::sin(i*0.01))/8.0;
+    initial["value"] = arr.freeze();
+    pv.open(initial);
+
+    auto conf(server::Config::isolated());
+    conf.compressThreshold = 1024u;
+    auto srv(conf.build()
+             .addPV("arr", pv)
+             .start());
+
+    auto cli(srv.clientConfig().build());
+
+    for(auto pass : range(2u)) {
+        auto val(cli.get("arr").exec()->wait(5.0));
+        auto result(val["value"].as<shared_array<const double>>());
+
+        bool match = result.size()==20000u;
+        for(auto i : range(result.size()))
+            match &= result[i]==std::floor(100.0*std::sin(i*0.01))/8.0;
+        testTrue(match)<<" pass "<<pass;
+    }
+
+    auto report(srv.report());
+    if(testEq(report.connections.size(), 1u)) {
+        auto& conn = report.connections.front();
+        testTrue(conn.zipIn >= 2u*20000u*8u)<<" in="<<conn.zipIn;
+        testTrue(conn.zipOut < conn.zipIn/2u)<<" out="<<conn.zipOut;
+    } else {
+        testSkip(2, "No connection");
+    }
+}
+
+} // namespace
+
+MAIN(testzip)
+{
+    testPlan(18);
+    testSetup();
+    logger_config_env();
+    testCodec();
+    testLongStream();
+    testTransport();
+    cleanup_for_valgrind();
+    return testDone();
+}
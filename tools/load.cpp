@@ -0,0 +1,527 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <limits>
+#include <algorithm>
+
+#include <epicsVersion.h>
+#include <epicsGetopt.h>
+#include <epicsEvent.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
+#include <epicsTime.h>
+
+#include <pvxs/client.h>
+#include <pvxs/server.h>
+#include <pvxs/sharedpv.h>
+#include <pvxs/nt.h>
+#include <pvxs/log.h>
+#include "utilpvt.h"
+
+using namespace pvxs;
+
+namespace {
+
+DEFINE_LOGGER(app, "app");
+
+typedef epicsGuard<epicsMutex> Guard;
+
+void usage(const char* argv0)
+{
+    std::cerr<<"Usage: "<<argv0<<" <opts> <scenario.txt>\n"
+               "\n"
+               "  -h        Show this message.\n"
+               "  -V        Print version and exit.\n"
+               "  -S        Producer.  Serve the PVs described by the scenario.\n"
+               "  -C        Consumer.  Subscribe to the PVs described by the scenario.\n"
+               "            With both -S and -C, the consumer connects only to this process.\n"
+               "  -T <sec>  Run time.  Default: until interrupted.\n"
+               "  -i <sec>  Consumer progress report interval.  Zero to disable.  Default: 5\n"
+               "  -Q <cnt>  Consumer queueSize.\n"
+               "  -p        Consumer requests pipeline=false\n"
+               "  -P        Consumer requests pipeline=true\n"
+               "  -v        Make more noise.\n"
+               "  -d        Shorthand for $PVXS_LOG=\"pvxs.*=DEBUG\".  Make a lot of noise.\n"
+               "\n"
+               "  Each non-blank line of a scenario file describes a group of PVs.\n"
+               "  Lines beginning with '#' are ignored.\n"
+               "\n"
+               "    <prefix> <count> <rate> [<nelem> [<burst> [<nsub>]]]\n"
+               "\n"
+               "  Names are '<prefix>0' through '<prefix><count-1>'.  Each PV posts <rate> updates\n"
+               "  per second, in bursts of <burst> back to back updates.  <nelem> greater than one\n"
+               "  makes .value a UInt32 array.  The consumer creates <nsub> subscriptions to each PV.\n"
+               "\n"
+               "    # prefix   count rate  nelem  burst nsub\n"
+               "    load:slow: 1000  1\n"
+               "    load:fast: 10    100   1      1     4\n"
+               "    load:wave: 4     10    100000 5\n"
+               "\n"
+               "  Latency is measured from .timeStamp to arrival,\n"
+               "  so producer and consumer clocks must be synchronized.\n"
+               ;
+}
+
+struct Group {
+    std::string prefix;
+    size_t count = 1u;
+    double rate = 1.0;
+    size_t nelem = 1u;
+    size_t burst = 1u;
+    size_t nsub = 1u;
+
+    std::string name(size_t i) const { return SB()<<prefix<<i; }
+};
+
+std::vector<Group> parseScenario(const std::string& fname)
+{
+    std::ifstream inp(fname);
+    if(!inp.is_open())
+        throw std::runtime_error(SB()<<"Unable to open scenario "<<fname);
+
+    std::vector<Group> ret;
+    std::string line;
+    for(size_t lineno = 1u; std::getline(inp, line); lineno++) {
+        auto first(line.find_first_not_of(" \t\r"));
+        if(first==std::string::npos || line[first]=='#')
+            continue;
+
+        std::istringstream strm(line);
+        Group grp;
+        if((strm>>grp.prefix>>grp.count>>grp.rate).fail())
+            throw std::runtime_error(SB()<<fname<<':'<<lineno<<" expected: <prefix> <count> <rate>");
+        if(!(strm>>std::ws).eof() && (strm>>grp.nelem).fail())
+            throw std::runtime_error(SB()<<fname<<':'<<lineno<<" invalid <nelem>");
+        if(!(strm>>std::ws).eof() && (strm>>grp.burst).fail())
+            throw std::runtime_error(SB()<<fname<<':'<<lineno<<" invalid <burst>");
+        if(!(strm>>std::ws).eof() && (strm>>grp.nsub).fail())
+            throw std::runtime_error(SB()<<fname<<':'<<lineno<<" invalid <nsub>");
+        if(!(strm>>std::ws).eof())
+            throw std::runtime_error(SB()<<fname<<':'<<lineno<<" unexpected trailing characters");
+
+        if(!grp.count || !(grp.rate > 0.0) || !grp.nelem || !grp.burst)
+            throw std::runtime_error(SB()<<fname<<':'<<lineno<<" <count>, <rate>, <nelem>, and <burst> must be positive");
+
+        ret.push_back(grp);
+    }
+    if(ret.empty())
+        throw std::runtime_error(SB()<<"Scenario "<<fname<<" describes no PVs");
+    return ret;
+}
+
+struct Producer {
+    struct PV {
+        server::SharedPV pv;
+        uint32_t counter = 0u;
+    };
+    struct Gen {
+        const Group* group;
+        Value proto;
+        std::vector<PV> pvs;
+        uint64_t period; // ns between bursts
+        uint64_t next;   // monotonic time of next burst
+        uint64_t nposted = 0u;
+        uint64_t nlate = 0u;
+    };
+    std::vector<Gen> gens;
+    server::StaticSource src;
+
+    Producer(const std::vector<Group>& groups, uint64_t now)
+        :src(server::StaticSource::build())
+    {
+        gens.reserve(groups.size());
+        for(auto& grp : groups) {
+            gens.emplace_back();
+            auto& gen = gens.back();
+            gen.group = &grp;
+            gen.proto = nt::NTScalar{grp.nelem>1u ? TypeCode::UInt32A : TypeCode::UInt32}.create();
+            gen.period = uint64_t(1e9*grp.burst/grp.rate);
+            gen.next = now;
+
+            gen.pvs.resize(grp.count);
+            for(auto i : range(grp.count)) {
+                auto& pv = gen.pvs[i];
+                pv.pv = server::SharedPV::buildReadonly();
+                pv.pv.open(update(gen, pv));
+                src.add(grp.name(i), pv.pv);
+            }
+        }
+    }
+
+    static
+    Value update(Gen& gen, PV& pv)
+    {
+        auto val(gen.proto.cloneEmpty());
+        auto cnt(pv.counter++);
+        if(gen.group->nelem > 1u) {
+            shared_array<uint32_t> arr(gen.group->nelem, cnt);
+            val["value"] = arr.freeze();
+        } else {
+            val["value"] = cnt;
+        }
+        epicsTimeStamp now;
+        if(!epicsTimeGetCurrent(&now)) {
+            val["timeStamp.secondsPastEpoch"] = now.secPastEpoch + POSIX_TIME_AT_EPICS_EPOCH;
+            val["timeStamp.nanoseconds"] = now.nsec;
+        }
+        return val;
+    }
+
+    // post any bursts which are due.  Returns time of next due burst
+    uint64_t tick(uint64_t now)
+    {
+        auto due(std::numeric_limits<uint64_t>::max());
+        for(auto& gen : gens) {
+            if(gen.next <= now) {
+                for(auto& pv : gen.pvs) {
+                    for(auto n : range(gen.group->burst)) {
+                        (void)n;
+                        pv.pv.post(update(gen, pv));
+                    }
+                }
+                gen.nposted += gen.pvs.size()*gen.group->burst;
+                gen.next += gen.period;
+                if(gen.next <= now) {
+                    // can't keep up.  skip ahead rather than accumulate a backlog
+                    gen.nlate++;
+                    gen.next = now + gen.period;
+                }
+            }
+            due = std::min(due, gen.next);
+        }
+        return due;
+    }
+
+    void report(std::ostream& strm, double dT) const
+    {
+        strm<<"# Producer\n";
+        for(auto& gen : gens) {
+            auto offered(gen.group->count*gen.group->rate);
+            strm<<gen.group->prefix
+                <<" posted "<<gen.nposted<<" "<<(gen.nposted/dT)<<"/s of "<<offered<<"/s"
+                <<" late bursts "<<gen.nlate<<"\n";
+        }
+    }
+};
+
+struct Consumer {
+    // per Group counters
+    struct Tally {
+        const Group* group;
+        epicsMutex lock;
+        uint64_t updates = 0u;
+        uint64_t drops = 0u;
+        uint64_t disconnects = 0u;
+        TimeHistogram latency;
+        // at previous progress report
+        uint64_t prevUpdates = 0u;
+    };
+    // per Subscription.  Only accessed from event callback
+    struct Sub {
+        Tally* tally;
+        uint32_t prev = 0u;
+        bool first = true;
+        std::shared_ptr<client::Subscription> op;
+    };
+
+    client::Context ctxt;
+    std::vector<std::unique_ptr<Tally>> tallies;
+    std::vector<std::unique_ptr<Sub>> subs;
+
+    Consumer(const std::vector<Group>& groups, const client::Context& ctxt, const std::string& pvRequest)
+        :ctxt(ctxt)
+    {
+        for(auto& grp : groups) {
+            tallies.emplace_back(new Tally);
+            auto tally = tallies.back().get();
+            tally->group = &grp;
+
+            for(auto i : range(grp.count)) {
+                for(auto n : range(grp.nsub)) {
+                    (void)n;
+                    subs.emplace_back(new Sub);
+                    auto sub = subs.back().get();
+                    sub->tally = tally;
+                    sub->op = this->ctxt.monitor(grp.name(i))
+                            .pvRequest(pvRequest)
+                            .maskDisconnected(false)
+                            .event([sub](client::Subscription& mon) {
+                                onEvent(*sub, mon);
+                            })
+                            .exec();
+                }
+            }
+        }
+        this->ctxt.hurryUp();
+    }
+
+    ~Consumer() {
+        for(auto& sub : subs)
+            sub->op->cancel();
+    }
+
+    static
+    void onEvent(Sub& sub, client::Subscription& mon)
+    {
+        while(true) {
+            Value val;
+            try {
+                val = mon.pop();
+            }catch(client::Disconnect&) {
+                sub.first = true;
+                Guard G(sub.tally->lock);
+                sub.tally->disconnects++;
+                continue;
+            }catch(std::exception& e) {
+                log_warn_printf(app, "%s error %s\n", mon.name().c_str(), e.what());
+                continue;
+            }
+            if(!val)
+                break;
+
+            epicsTimeStamp now;
+            (void)epicsTimeGetCurrent(&now);
+
+            auto fld(val["value"]);
+            uint32_t cnt;
+            if(fld.type().isarray()) {
+                auto arr(fld.as<shared_array<const uint32_t>>());
+                if(arr.empty())
+                    continue;
+                cnt = arr[0];
+            } else {
+                cnt = fld.as<uint32_t>();
+            }
+
+            // a backwards step (eg. producer restart) is not counted as a drop
+            uint32_t dropped = 0u;
+            auto diff(int32_t(cnt - sub.prev));
+            if(!sub.first && diff > 1)
+                dropped = uint32_t(diff - 1);
+            sub.first = false;
+            sub.prev = cnt;
+
+            int64_t sec = int64_t(now.secPastEpoch) + POSIX_TIME_AT_EPICS_EPOCH;
+            int64_t lat = (sec - val["timeStamp.secondsPastEpoch"].as<int64_t>())*1000000000
+                    + int64_t(now.nsec) - val["timeStamp.nanoseconds"].as<int64_t>();
+
+            Guard G(sub.tally->lock);
+            sub.tally->updates++;
+            sub.tally->drops += dropped;
+            if(lat >= 0)
+                sub.tally->latency.sample(uint64_t(lat));
+        }
+    }
+
+    void progress(std::ostream& strm, double dT)
+    {
+        for(auto& tally : tallies) {
+            auto& grp = *tally->group;
+            uint64_t updates, drops;
+            {
+                Guard G(tally->lock);
+                updates = tally->updates;
+                drops = tally->drops;
+            }
+            strm<<grp.prefix<<" "<<((updates - tally->prevUpdates)/dT)<<"/s of "
+                <<(grp.count*grp.nsub*grp.rate)<<"/s drops "<<drops<<"\n";
+            tally->prevUpdates = updates;
+        }
+    }
+
+    void report(std::ostream& strm, double dT)
+    {
+        strm<<"# Consumer\n";
+        for(auto& tally : tallies) {
+            size_t srvSquash = 0u, cliSquash = 0u, maxQueue = 0u, limitQueue = 0u;
+            for(auto& sub : subs) {
+                if(sub->tally!=tally.get())
+                    continue;
+                client::SubscriptionStat stats;
+                sub->op->stats(stats);
+                srvSquash += stats.nSrvSquash;
+                cliSquash += stats.nCliSquash;
+                maxQueue = std::max(maxQueue, stats.maxQueue);
+                limitQueue = std::max(limitQueue, stats.limitQueue);
+            }
+
+            auto& grp = *tally->group;
+            Guard G(tally->lock);
+            strm<<grp.prefix<<" "<<grp.count<<" PVs x "<<grp.nsub<<" subscriptions\n";
+            Indented I(strm);
+            strm<<indent{}<<"received "<<tally->updates<<" "<<(tally->updates/dT)
+                <<"/s of "<<(grp.count*grp.nsub*grp.rate)<<"/s\n"
+                <<indent{}<<"drops "<<tally->drops
+                <<" server squash "<<srvSquash<<" client squash "<<cliSquash
+                <<" disconnects "<<tally->disconnects<<"\n"
+                <<indent{}<<"queue high water "<<maxQueue<<"/"<<limitQueue<<"\n"
+                <<indent{}<<"latency "<<tally->latency<<"\n";
+        }
+    }
+};
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    try {
+        logger_level_set("app", Level::Info);
+        logger_config_env(); // from $PVXS_LOG
+        bool verbose = false;
+        bool produce = false, consume = false;
+        double duration = 0.0, interval = 5.0;
+        uint64_t queueSize = 0u;
+        int pipeline = 0; // tri-bool
+
+        {
+            int opt;
+            while ((opt = getopt(argc, argv, "hVvdSCT:i:Q:pP")) != -1) {
+                switch(opt) {
+                case 'h':
+                    usage(argv[0]);
+                    return 0;
+                case 'V':
+                    std::cout<<pvxs::version_information;
+                    return 0;
+                case 'v':
+                    verbose = true;
+                    logger_level_set("app", Level::Debug);
+                    break;
+                case 'd':
+                    logger_level_set("pvxs.*", Level::Debug);
+                    break;
+                case 'S':
+                    produce = true;
+                    break;
+                case 'C':
+                    consume = true;
+                    break;
+                case 'T':
+                    duration = parseTo<double>(optarg);
+                    break;
+                case 'i':
+                    interval = parseTo<double>(optarg);
+                    break;
+                case 'Q':
+                    queueSize = parseTo<uint64_t>(optarg);
+                    break;
+                case 'p':
+                    pipeline = -1;
+                    break;
+                case 'P':
+                    pipeline = 1;
+                    break;
+                default:
+                    usage(argv[0]);
+                    std::cerr<<"\nUnknown argument: "<<char(opt)<<std::endl;
+                    return 1;
+                }
+            }
+        }
+
+        if(argc-optind!=1 || (!produce && !consume)) {
+            usage(argv[0]);
+            std::cerr<<"\nExpected one scenario file, and at least one of -S or -C"<<std::endl;
+            return 1;
+        }
+
+        auto groups(parseScenario(argv[optind]));
+
+        std::string pvRequest;
+        {
+            std::ostringstream strm;
+            strm<<"record[";
+            if(pipeline==1)
+                strm<<"pipeline=true";
+            if(pipeline==-1)
+                strm<<"pipeline=false";
+            if(queueSize) {
+                if(pipeline!=0)
+                    strm<<',';
+                strm<<"queueSize="<<queueSize;
+            }
+            strm<<']';
+            pvRequest = strm.str();
+        }
+
+        auto start(monotonicNS());
+
+        std::unique_ptr<Producer> producer;
+        server::Server serv;
+        if(produce) {
+            producer.reset(new Producer(groups, start));
+
+            // with only this process as consumer, avoid disturbing any other servers
+            serv = (consume ? server::Config::isolated() : server::Config::fromEnv())
+                    .build()
+                    .addSource("load", producer->src.source());
+            if(verbose)
+                std::cout<<"Effective server config\n"<<serv.config();
+            serv.start();
+        }
+
+        std::unique_ptr<Consumer> consumer;
+        if(consume) {
+            auto ctxt(produce ? serv.clientConfig().build() : client::Context::fromEnv());
+            if(verbose)
+                std::cout<<"Effective client config\n"<<ctxt.config();
+            consumer.reset(new Consumer(groups, ctxt, pvRequest));
+        }
+
+        std::atomic<bool> run{true};
+        epicsEvent wakeup;
+        SigInt sig([&run, &wakeup]() {
+            run = false;
+            wakeup.signal();
+        });
+
+        const auto never(std::numeric_limits<uint64_t>::max());
+        const uint64_t end = duration > 0.0 ? start + uint64_t(duration*1e9) : never;
+        const uint64_t period = interval > 0.0 && consumer ? uint64_t(interval*1e9) : 0u;
+        uint64_t nextReport = period ? start + period : never;
+        auto prevReport(start);
+
+        uint64_t now;
+        while(run.load() && (now = monotonicNS()) < end) {
+            auto due(end);
+
+            if(producer)
+                due = std::min(due, producer->tick(now));
+
+            if(now >= nextReport) {
+                std::cout<<"# "<<double(now - start)*1e-9<<" sec.\n";
+                consumer->progress(std::cout, double(now - prevReport)*1e-9);
+                std::cout.flush();
+                prevReport = now;
+                nextReport += period;
+            }
+            due = std::min(due, nextReport);
+
+            now = monotonicNS();
+            if(due > now)
+                wakeup.wait(double(due - now)*1e-9);
+        }
+
+        double dT = double(monotonicNS() - start)*1e-9;
+        std::cout<<"# run time "<<dT<<" sec.\n";
+        if(producer)
+            producer->report(std::cout, dT);
+        if(consumer)
+            consumer->report(std::cout, dT);
+
+        return 0;
+
+    }catch(std::exception& e){
+        std::cerr<<"Error: "<<e.what()<<"\n";
+        return 1;
+    }
+}
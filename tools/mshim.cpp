@@ -5,11 +5,19 @@
  */
 
 #include <map>
+#include <deque>
 #include <vector>
 #include <iostream>
 #include <string>
 #include <exception>
 
+#include <string.h>
+
+#ifdef __linux__
+#  include <sys/socket.h>
+#  define USE_SENDMMSG
+#endif
+
 #include <epicsVersion.h>
 #include <epicsGetopt.h>
 
@@ -38,6 +46,11 @@ void usage(const char* argv0)
                 "                          Optionally override OS default TTL and outbound interface selected\n"
                 "                          by the OS.\n"
                 "  -p <port#>              Default port number.  (overrides $EPICS_PVA_BROADCAST_PORT)\n"
+                "  -D <sec>                Drop repeated searches from the same client for the same\n"
+                "                          names and channel IDs within this window.  Zero to disable.  (default 0)\n"
+                "  -R <rate>               Limit packets forwarded from each source, per second.\n"
+                "                          Zero for no limit.  (default 0)\n"
+                "  -S <sec>                Interval to print counters.  Zero to disable.  (default 0)\n"
                 "  -h                      Show this message.\n"
                 "  -V                      Show versions.\n"
                 "\n"
@@ -77,23 +90,269 @@ SockEndpoint parseEP(const char* optarg, const server::Config& conf)
 struct App {
     const SockAttach attach;
     IfaceMap& ifmap;
+    const evbase loop;
     const evsocket sockTx{AF_INET, SOCK_DGRAM, 0};
     std::vector<SockEndpoint> destinations;
 
+    // options
+    double dedupWindow = 0.0; // seconds
+    double rateLimit = 0.0; // packets per second, per source
+    double statsInterval = 0.0; // seconds
+
     // effectively local to UDPManager worker
     std::vector<uint8_t> scratch;
-
-    App()
+    // copy of search with Unicast flag cleared
+    std::vector<uint8_t> scratchBcast;
+
+    // destinations grouped by multicast TTL and interface, which are socket options.
+    struct Batch {
+        const SockEndpoint* mcast = nullptr;
+        std::vector<const SockEndpoint*> dests;
+    };
+    std::vector<Batch> batches;
+#ifdef USE_SENDMMSG
+    std::vector<mmsghdr> msgs;
+    std::vector<iovec> iovs;
+#endif
+
+    // recently forwarded searches.  expiry time by client and hash of names and channel IDs.
+    // Not the searchID, which some clients (eg. pvxs) never change.
+    typedef std::pair<SockAddr, uint64_t> searchKey;
+    std::map<searchKey, uint64_t> seen;
+    std::deque<std::pair<uint64_t, searchKey>> seenOrder;
+
+    struct Bucket {
+        double tokens;
+        uint64_t last;
+    };
+    std::map<SockAddr, Bucket> buckets;
+
+    struct Counters {
+        uint64_t rx = 0u;      // packets received
+        uint64_t dup = 0u;     // duplicate searches dropped
+        uint64_t limited = 0u; // dropped by rate limit
+        uint64_t tx = 0u;      // datagrams sent
+        uint64_t txerr = 0u;   // datagrams not sent
+        uint64_t calls = 0u;   // send syscalls
+    } cnt;
+    uint64_t lastStats = 0u;
+
+    evevent tick;
+
+    explicit App(const evbase& loop)
         :ifmap(IfaceMap::instance())
+        ,loop(loop)
         ,scratch(0x10000)
+        ,scratchBcast(0x10000)
+        ,tick(__FILE__, __LINE__,
+              event_new(loop.base, -1, EV_TIMEOUT|EV_PERSIST, &App::onTickS, this))
     {
         auto bind_addr(SockAddr::any(sockTx.af));
         sockTx.bind(bind_addr);
         sockTx.mcast_loop(true);
     }
 
+    ~App()
+    {
+        loop.call([this]() {
+            (void)event_del(tick.get());
+        });
+    }
+
+    void start()
+    {
+        for(auto& dest : destinations) {
+            Batch* batch = nullptr;
+            for(auto& B : batches) {
+                if(dest.addr.isMCast()
+                        ? (B.mcast && B.mcast->ttl==dest.ttl && B.mcast->iface==dest.iface)
+                        : !B.mcast)
+                {
+                    batch = &B;
+                    break;
+                }
+            }
+            if(!batch) {
+                batches.emplace_back();
+                batch = &batches.back();
+                if(dest.addr.isMCast())
+                    batch->mcast = &dest;
+            }
+            batch->dests.push_back(&dest);
+        }
+
+        loop.call([this]() {
+            lastStats = monotonicNS();
+            timeval interval{1, 0};
+            if(event_add(tick.get(), &interval))
+                log_err_printf(applog, "Error enabling timer\n%s", "");
+        });
+    }
+
+    // apply per source rate limit
+    bool admit(const SockAddr& src, uint64_t now)
+    {
+        cnt.rx++;
+
+        if(rateLimit<=0.0)
+            return true;
+
+        auto it(buckets.find(src));
+        if(it==buckets.end()) {
+            it = buckets.emplace(src, Bucket{rateLimit, now}).first;
+        } else {
+            auto& B = it->second;
+            B.tokens = std::min(rateLimit, B.tokens + rateLimit*double(now - B.last)*1e-9);
+            B.last = now;
+        }
+
+        if(it->second.tokens < 1.0) {
+            cnt.limited++;
+            return false;
+        }
+        it->second.tokens -= 1.0;
+        return true;
+    }
+
+    // test, and remember, (client, names and channel IDs)
+    bool duplicate(const UDPManager::Search& msg, uint64_t now)
+    {
+        if(dedupWindow<=0.0)
+            return false;
+
+        // FNV-1a
+        uint64_t hash = 0xcbf29ce484222325ull;
+        auto mix = [&hash](const void* raw, size_t len) {
+            auto bytes = static_cast<const uint8_t*>(raw);
+            for(size_t i=0u; i<len; i++) {
+                hash ^= bytes[i];
+                hash *= 0x100000001b3ull;
+            }
+        };
+        for(auto& name : msg.names) {
+            mix(&name.id, sizeof(name.id));
+            mix(name.name, strlen(name.name)+1u); // include nil as separator
+        }
+
+        while(!seenOrder.empty() && seenOrder.front().first <= now) {
+            auto it(seen.find(seenOrder.front().second));
+            if(it!=seen.end() && it->second <= now)
+                seen.erase(it);
+            seenOrder.pop_front();
+        }
+
+        searchKey key(msg.src, hash);
+        auto expire = now + uint64_t(dedupWindow*1e9);
+
+        auto it(seen.find(key));
+        if(it!=seen.end()) {
+            cnt.dup++;
+            return true;
+        }
+
+        seen.emplace(key, expire);
+        seenOrder.emplace_back(expire, key);
+        return false;
+    }
+
+    // send bufsize bytes of scratch to all destinations.
+    // For searches, flags points to the search flags in scratch.
+    void forward(size_t bufsize, uint8_t* flags, const char* what)
+    {
+        if(flags) {
+            // multicast and broadcast destinations get a copy without the unicast flag
+            *flags |= pva_search_flags::Unicast;
+            memcpy(scratchBcast.data(), scratch.data(), bufsize);
+            scratchBcast[flags - scratch.data()] &= ~pva_search_flags::Unicast;
+        }
+
+        for(auto& batch : batches) {
+            if(batch.mcast)
+                sockTx.mcast_prep_sendto(*batch.mcast);
+
+            auto bufFor = [this, flags](const SockEndpoint* dest) -> uint8_t* {
+                return flags && (dest->addr.isMCast() || ifmap.is_broadcast(dest->addr))
+                        ? scratchBcast.data() : scratch.data();
+            };
+
+#ifdef USE_SENDMMSG
+            const size_t n = batch.dests.size();
+            msgs.resize(n);
+            iovs.resize(n);
+            for(size_t i=0u; i<n; i++) {
+                auto dest = batch.dests[i];
+                iovs[i].iov_base = bufFor(dest);
+                iovs[i].iov_len = bufsize;
+                memset(&msgs[i], 0, sizeof(msgs[i]));
+                msgs[i].msg_hdr.msg_name = const_cast<sockaddr*>(&dest->addr->sa);
+                msgs[i].msg_hdr.msg_namelen = dest->addr.size();
+                msgs[i].msg_hdr.msg_iov = &iovs[i];
+                msgs[i].msg_hdr.msg_iovlen = 1u;
+            }
+
+            size_t done = 0u;
+            while(done < n) {
+                cnt.calls++;
+                int ret = sendmmsg(sockTx.sock, msgs.data()+done, unsigned(n-done), 0);
+                if(ret < 0) {
+                    int err = evutil_socket_geterror(sockTx.sock);
+                    if(err==SOCK_EWOULDBLOCK || err==EAGAIN || err==SOCK_EINTR) {
+                        cnt.txerr += n-done;
+                        break; // too bad, better luck next time
+                    }
+                    log_warn_printf(applog, "Unable to send %s to %s, skip.  (%d) %s\n",
+                                    what, std::string(SB()<<*batch.dests[done]).c_str(),
+                                    err, evutil_socket_error_to_string(err));
+                    cnt.txerr++;
+                    done++;
+
+                } else {
+                    for(auto i : range(size_t(ret))) {
+                        if(msgs[done+i].msg_len!=bufsize) {
+                            log_warn_printf(applog, "Sent truncated %s to %s?\n",
+                                            what, std::string(SB()<<*batch.dests[done+i]).c_str());
+                        }
+                    }
+                    cnt.tx += ret;
+                    done += ret;
+                }
+            }
+#else
+            for(auto dest : batch.dests) {
+                cnt.calls++;
+                auto ret = sendto(sockTx.sock, (char*)bufFor(dest), bufsize, 0,
+                                  &dest->addr->sa, dest->addr.size());
+
+                if(ret < 0) {
+                    cnt.txerr++;
+                    int err = evutil_socket_geterror(sockTx.sock);
+                    if(err==SOCK_EWOULDBLOCK || err==EAGAIN || err==SOCK_EINTR) {
+                        break; // too bad, better luck next time
+
+                    } else {
+                        log_warn_printf(applog, "Unable to send %s to %s, skip.  (%d) %s\n",
+                                        what, std::string(SB()<<*dest).c_str(),
+                                        err, evutil_socket_error_to_string(err));
+                    }
+
+                } else if(size_t(ret)!=bufsize) {
+                    log_warn_printf(applog, "Sent truncated %s to %s?\n",
+                                    what, std::string(SB()<<*dest).c_str());
+
+                } else {
+                    cnt.tx++;
+                }
+            }
+#endif
+        }
+    }
+
     void onSearch(const UDPManager::Search& msg)
     {
+        auto now(monotonicNS());
+        if(!admit(msg.src, now) || duplicate(msg, now))
+            return;
+
         FixedBuf buf(true, scratch);
         auto save_header = buf.save();
         buf._skip(8);
@@ -137,44 +396,18 @@ struct App {
             to_wire(buf, Header{CMD_SEARCH, 0, uint32_t(bufsize-8u)});
         }
 
-        for(auto& dest : destinations) {
-            if(dest.addr.isMCast() || ifmap.is_broadcast(dest.addr)) {
-                *save_flags &= ~pva_search_flags::Unicast;
-
-            } else {
-                *save_flags |= pva_search_flags::Unicast;
-            }
-
-            sockTx.mcast_prep_sendto(dest);
-
-            auto ret = sendto(sockTx.sock, (char*)scratch.data(), bufsize, 0,
-                              &dest.addr->sa, dest.addr.size());
-
-            if(ret < 0) {
-                int err = evutil_socket_geterror(sockTx.sock);
-                if(err==SOCK_EWOULDBLOCK || err==EAGAIN || err==SOCK_EINTR) {
-                    break; // too bad, better luck next time
-
-                } else {
-                    log_warn_printf(applog, "Unable to send search to %s, skip.  (%d) %s\n",
-                                    std::string(SB()<<dest).c_str(), err, evutil_socket_error_to_string(err));
-                }
-
-            } else if(ret!=bufsize) {
-                log_warn_printf(applog, "Sent truncated search to %s?\n",
-                                std::string(SB()<<dest).c_str());
+        forward(bufsize, save_flags, "search");
 
-            } else {
-                log_debug_printf(applog, "Forwarded search to %s -> %s -> %s?\n",
-                                 msg.src.tostring().c_str(),
-                                 msg.server.tostring().c_str(),
-                                 std::string(SB()<<dest).c_str());
-            }
-        }
+        log_debug_printf(applog, "Forwarded search %s -> %s\n",
+                         msg.src.tostring().c_str(),
+                         msg.server.tostring().c_str());
     }
 
     void onBeacon(const UDPManager::Beacon& msg)
     {
+        if(!admit(msg.src, monotonicNS()))
+            return;
+
         FixedBuf buf(true, scratch);
         auto save_header = buf.save();
         buf._skip(8);
@@ -199,32 +432,44 @@ struct App {
             to_wire(buf, Header{CMD_SEARCH, 0, uint32_t(bufsize-8u)});
         }
 
-        for(auto& dest : destinations) {
-            sockTx.mcast_prep_sendto(dest);
-
-            auto ret = sendto(sockTx.sock, (char*)scratch.data(), bufsize, 0,
-                              &dest.addr->sa, dest.addr.size());
+        forward(bufsize, nullptr, "beacon");
 
-            if(ret < 0) {
-                int err = evutil_socket_geterror(sockTx.sock);
-                if(err==SOCK_EWOULDBLOCK || err==EAGAIN || err==SOCK_EINTR) {
-                    break; // too bad, better luck next time
+        log_debug_printf(applog, "Forwarded beacon %s -> %s\n",
+                         msg.src.tostring().c_str(),
+                         msg.server.tostring().c_str());
+    }
 
-                } else {
-                    log_warn_printf(applog, "Unable to send beacon to %s, skip.  (%d) %s\n",
-                                    std::string(SB()<<dest).c_str(), err, evutil_socket_error_to_string(err));
-                }
+    void onTick()
+    {
+        auto now(monotonicNS());
 
-            } else if(ret!=bufsize) {
-                log_warn_printf(applog, "Sent truncated beacon to %s?\n",
-                                std::string(SB()<<dest).c_str());
+        // forget sources idle long enough (1 second) to have a full bucket
+        for(auto it = buckets.begin(); it!=buckets.end();) {
+            auto cur = it++;
+            if(now - cur->second.last >= 1000000000u)
+                buckets.erase(cur);
+        }
 
-            } else {
-                log_debug_printf(applog, "Forwarded beacon to %s -> %s -> %s?\n",
-                                 msg.src.tostring().c_str(),
-                                 msg.server.tostring().c_str(),
-                                 std::string(SB()<<dest).c_str());
-            }
+        if(statsInterval > 0.0 && double(now - lastStats)*1e-9 >= statsInterval) {
+            lastStats = now;
+            std::cout<<"mshim rx="<<cnt.rx
+                     <<" dup="<<cnt.dup
+                     <<" limited="<<cnt.limited
+                     <<" tx="<<cnt.tx
+                     <<" txerr="<<cnt.txerr
+                     <<" calls="<<cnt.calls
+                     <<" sources="<<buckets.size()
+                     <<" seen="<<seen.size()
+                     <<std::endl;
+        }
+    }
+    static
+    void onTickS(evutil_socket_t fd, short evt, void *raw)
+    {
+        try {
+            static_cast<App*>(raw)->onTick();
+        }catch(std::exception& e){
+            log_exc_printf(applog, "Unhandled error in timer callback: %s\n", e.what());
         }
     }
 };
@@ -236,10 +481,10 @@ int main(int argc, char *argv[])
     try {
         SockAttach attach;
         logger_config_env();
-        App app;
 
         auto conf(server::Config::fromEnv());
         auto manager(UDPManager::instance());
+        App app(manager.loop());
         std::vector<std::unique_ptr<UDPListener>> listeners;
 
         auto onSearch = [&app](const UDPManager::Search& msg) {app.onSearch(msg);};
@@ -247,7 +492,7 @@ int main(int argc, char *argv[])
 
         {
             int opt;
-            while ((opt = getopt(argc, argv, "L:F:phV")) != -1) {
+            while ((opt = getopt(argc, argv, "L:F:p:D:R:S:hV")) != -1) {
                 switch(opt) {
                 case 'L':
                 {
@@ -262,6 +507,15 @@ int main(int argc, char *argv[])
                 case 'p':
                     conf.udp_port = parseTo<uint64_t>(optarg);
                     break;
+                case 'D':
+                    app.dedupWindow = parseTo<double>(optarg);
+                    break;
+                case 'R':
+                    app.rateLimit = parseTo<double>(optarg);
+                    break;
+                case 'S':
+                    app.statsInterval = parseTo<double>(optarg);
+                    break;
                 case 'h':
                     usage(argv[0]);
                     return 0;
@@ -282,6 +536,8 @@ int main(int argc, char *argv[])
             return 1;
         }
 
+        app.start();
+
         for(auto& listener : listeners) {
             listener->start();
         }
@@ -0,0 +1,987 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <exception>
+#include <system_error>
+
+#include <cassert>
+#include <cstring>
+
+#include <event2/event.h>
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
+#include <event2/listener.h>
+
+#include <epicsVersion.h>
+#include <epicsEvent.h>
+#include <epicsGetopt.h>
+
+#include <pvxs/log.h>
+#include <pvxs/util.h>
+#include "utilpvt.h"
+#include "evhelper.h"
+#include "pvaproto.h"
+
+using namespace pvxs;
+
+DEFINE_LOGGER(app, "pvxreplay");
+
+namespace {
+
+void usage(const char* argv0)
+{
+    std::cerr<<
+                "Usage: "<<argv0<<" -o <file> -L <[ip:]port> -S <ip[:port]> [-U <[ip:]port>] [-T <sec>]\n"
+                "       "<<argv0<<" -i <file> -S <ip[:port]> [-U <ip[:port]>] [-x <speed>] [-W <sec>]\n"
+                "\n"
+                "  Capture mode\n"
+                "  -o <file>        Write captured traffic to file.\n"
+                "  -L <[ip:]port>   Accept client TCP connections on this address, and proxy to the -S server.\n"
+                "  -S <ip[:port]>   Upstream server TCP address.\n"
+                "  -U <[ip:]port>   Also capture UDP searches received on this address.\n"
+                "  -T <sec>         Capture time.  Default: until interrupted.\n"
+                "\n"
+                "  Replay mode\n"
+                "  -i <file>        Read captured traffic from file.\n"
+                "  -S <ip[:port]>   Server TCP address to replay client messages to.\n"
+                "  -U <ip[:port]>   Server UDP address to replay searches to.  Searches are not replayed if omitted.\n"
+                "  -x <speed>       Replay speed multiplier.  0 to send as fast as possible.  Default: 1\n"
+                "  -W <sec>         Time to wait for responses after the last message is sent.  Default: 2\n"
+                "\n"
+                "  -h               Show this message.\n"
+                "  -V               Show versions.\n"
+                "  -v               Make more noise.\n"
+                "\n"
+                "  Captures client to server, and server to client, PVA messages passing through a\n"
+                "  TCP proxy, and optionally UDP search datagrams.  Replays the client side of each\n"
+                "  captured connection with the captured timing, mapping server assigned channel IDs,\n"
+                "  and reports server response times.\n"
+                "\n"
+                "    "<<argv0<<" -o cap.dat -L 15075 -S 127.0.0.1:5075 -U 15076 &\n"
+                "    EPICS_PVA_ADDR_LIST=127.0.0.1:15076 pvxget some:pv\n"
+                "    "<<argv0<<" -i cap.dat -S 127.0.0.1:5075 -U 127.0.0.1:5076 -x 10\n"
+    <<std::endl;
+}
+
+/* Capture file format.  All values little endian.
+ *
+ *   "PVXCAP01"
+ *   repeated:
+ *     uint64 time   ns since start of capture
+ *     uint32 conn   connection number.  Zero for UDP
+ *     uint8  kind   RecKind
+ *     uint32 len
+ *     uint8[len]    One complete PVA message, or for Search, one UDP datagram.
+ */
+const char fileMagic[8] = {'P', 'V', 'X', 'C', 'A', 'P', '0', '1'};
+constexpr size_t recHeaderSize = 8u + 4u + 1u + 4u;
+
+enum RecKind : uint8_t {
+    Open = 1,
+    Close = 2,
+    ToServer = 3,
+    ToClient = 4,
+    Search = 5,
+};
+
+struct Record {
+    uint64_t time = 0u;
+    uint32_t conn = 0u;
+    uint8_t kind = 0u;
+    std::vector<uint8_t> msg;
+};
+
+struct CaptureWriter {
+    std::ofstream out;
+    const uint64_t start;
+    uint64_t nrecord = 0u;
+
+    explicit CaptureWriter(const std::string& fname)
+        :out(fname, std::ios::binary)
+        ,start(monotonicNS())
+    {
+        if(!out.is_open())
+            throw std::runtime_error(SB()<<"Unable to open "<<fname);
+        out.write(fileMagic, sizeof(fileMagic));
+    }
+
+    void write(uint32_t conn, RecKind kind, const uint8_t* msg, size_t len)
+    {
+        uint8_t hbuf[recHeaderSize];
+        FixedBuf H(false, hbuf, sizeof(hbuf));
+        to_wire(H, uint64_t(monotonicNS() - start));
+        to_wire(H, conn);
+        to_wire(H, uint8_t(kind));
+        to_wire(H, uint32_t(len));
+        assert(H.good() && H.empty());
+
+        out.write((const char*)hbuf, sizeof(hbuf));
+        if(len)
+            out.write((const char*)msg, len);
+        nrecord++;
+    }
+};
+
+std::vector<Record> readCapture(const std::string& fname)
+{
+    std::ifstream inp(fname, std::ios::binary);
+    if(!inp.is_open())
+        throw std::runtime_error(SB()<<"Unable to open "<<fname);
+
+    char magic[sizeof(fileMagic)];
+    if(!inp.read(magic, sizeof(magic)) || memcmp(magic, fileMagic, sizeof(magic))!=0)
+        throw std::runtime_error(SB()<<fname<<" is not a capture file");
+
+    std::vector<Record> ret;
+    uint8_t hbuf[recHeaderSize];
+    while(inp.read((char*)hbuf, sizeof(hbuf))) {
+        Record rec;
+        uint32_t len = 0u;
+        FixedBuf H(false, hbuf, sizeof(hbuf));
+        from_wire(H, rec.time);
+        from_wire(H, rec.conn);
+        from_wire(H, rec.kind);
+        from_wire(H, len);
+        if(!H.good() || len > 0x10000000u)
+            throw std::runtime_error(SB()<<fname<<" corrupt record header at "<<ret.size());
+
+        rec.msg.resize(len);
+        if(len && !inp.read((char*)rec.msg.data(), len))
+            throw std::runtime_error(SB()<<fname<<" truncated record at "<<ret.size());
+        ret.push_back(std::move(rec));
+    }
+    return ret;
+}
+
+const char* cmdName(uint8_t cmd)
+{
+    switch(cmd) {
+#define CASE(NAME) case CMD_ ## NAME: return #NAME
+    CASE(SEARCH);
+    CASE(CREATE_CHANNEL);
+    CASE(GET);
+    CASE(PUT);
+    CASE(PUT_GET);
+    CASE(MONITOR);
+    CASE(ARRAY);
+    CASE(PROCESS);
+    CASE(GET_FIELD);
+    CASE(RPC);
+#undef CASE
+    default: return "???";
+    }
+}
+
+// Split complete messages from the front of a TCP stream.
+// Calls fn(const Header&, const uint8_t* msg, size_t len) for each, including header.
+// Returns the number of bytes consumed.
+template<typename Fn>
+size_t splitMessages(const std::vector<uint8_t>& buf, Fn&& fn)
+{
+    size_t pos = 0u;
+    while(buf.size() - pos >= 8u) {
+        FixedBuf M(false, const_cast<uint8_t*>(&buf[pos]), 8u);
+        Header H;
+        from_wire(M, H);
+        if(!M.good())
+            throw std::runtime_error("Invalid PVA message header");
+
+        // the length of a control message is a value, not a body size
+        size_t total = 8u + ((H.flags&pva_flags::Control) ? 0u : H.len);
+        if(buf.size() - pos < total)
+            break;
+
+        fn(H, &buf[pos], total);
+        pos += total;
+    }
+    return pos;
+}
+
+// A message which begins with a channel ID (sid) assigned by the server
+bool hasSID(uint8_t cmd)
+{
+    switch(cmd) {
+    case CMD_DESTROY_CHANNEL:
+    case CMD_GET:
+    case CMD_PUT:
+    case CMD_PUT_GET:
+    case CMD_MONITOR:
+    case CMD_ARRAY:
+    case CMD_DESTROY_REQUEST:
+    case CMD_PROCESS:
+    case CMD_GET_FIELD:
+    case CMD_RPC:
+    case CMD_CANCEL_REQUEST:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// An operation message which client sends as (sid, ioid, ...) and server replies to as (ioid, ...)
+bool isOp(uint8_t cmd)
+{
+    switch(cmd) {
+    case CMD_GET:
+    case CMD_PUT:
+    case CMD_PUT_GET:
+    case CMD_MONITOR:
+    case CMD_ARRAY:
+    case CMD_PROCESS:
+    case CMD_GET_FIELD:
+    case CMD_RPC:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Application message, and either unsegmented or the first segment
+bool isFirst(const Header& H)
+{
+    return !(H.flags&pva_flags::Control)
+            && ((H.flags&pva_flags::SegMask)==pva_flags::SegNone
+                || (H.flags&pva_flags::SegMask)==pva_flags::SegFirst);
+}
+
+/******** Capture ********/
+
+struct Recorder;
+
+struct ProxyConn {
+    Recorder* const rec;
+    const uint32_t id;
+    const std::string peerName;
+    evbufferevent down, up;
+    // partial messages
+    std::vector<uint8_t> toServer, toClient;
+
+    ProxyConn(Recorder* rec, uint32_t id, evutil_socket_t sock, const SockAddr& peer);
+
+    void onRead(bool fromClient);
+    void onEvent(bool client, short events);
+
+    static void readDownS(struct bufferevent *bev, void *raw);
+    static void readUpS(struct bufferevent *bev, void *raw);
+    static void eventDownS(struct bufferevent *bev, short events, void *raw);
+    static void eventUpS(struct bufferevent *bev, short events, void *raw);
+};
+
+struct Recorder {
+    evbase loop;
+    CaptureWriter out;
+    const SockAddr upstream;
+    evsocket tcpSock;
+    evlisten listener;
+    evsocket udpSock;
+    evevent udpRx;
+    std::vector<uint8_t> scratch;
+    uint32_t nextConn = 0u;
+    std::map<uint32_t, std::unique_ptr<ProxyConn>> conns;
+    uint64_t nmessages = 0u, nsearches = 0u, nconns = 0u;
+
+    Recorder(const std::string& fname, const SockAddr& bindAddr, const SockAddr& upstream, const SockAddr* udp)
+        :loop("PVXREC")
+        ,out(fname)
+        ,upstream(upstream)
+        ,tcpSock(bindAddr.family(), SOCK_STREAM, 0)
+        ,scratch(0x10000)
+    {
+        if(evutil_make_listen_socket_reuseable(tcpSock.sock))
+            log_warn_printf(app, "Unable to make socket reusable%s", "\n");
+        tcpSock.bind(bindAddr);
+
+        if(udp) {
+            udpSock = evsocket(udp->family(), SOCK_DGRAM, 0);
+            if(evutil_make_listen_socket_reuseable(udpSock.sock))
+                log_warn_printf(app, "Unable to make socket reusable%s", "\n");
+            udpSock.bind(*udp);
+        }
+
+        loop.call([this]() {
+            const int backlog = 4;
+            auto list(evconnlistener_new(loop.base, onConnS, this, LEV_OPT_CLOSE_ON_EXEC, backlog, tcpSock.sock));
+            if(!list) {
+                int err = evutil_socket_geterror(tcpSock.sock);
+                throw std::system_error(err, std::system_category());
+            }
+            listener = evlisten(__FILE__, __LINE__, list);
+
+            if(udpSock) {
+                udpRx = evevent(__FILE__, __LINE__,
+                                event_new(loop.base, udpSock.sock, EV_READ|EV_PERSIST, &onUDPS, this));
+                if(event_add(udpRx.get(), nullptr))
+                    throw std::runtime_error("Unable to begin listening for UDP");
+            }
+        });
+
+        log_info_printf(app, "Capturing connections to %s -> %s\n",
+                        tcpSock.sockname().tostring().c_str(), upstream.tostring().c_str());
+        if(udpSock)
+            log_info_printf(app, "Capturing searches to %s\n",
+                            udpSock.sockname().tostring().c_str());
+    }
+
+    ~Recorder()
+    {
+        loop.call([this]() {
+            listener.reset();
+            udpRx.reset();
+            conns.clear();
+            out.out.flush();
+        });
+    }
+
+    static void onConnS(struct evconnlistener *listener, evutil_socket_t sock, struct sockaddr *peer, int socklen, void *raw)
+    {
+        auto self = static_cast<Recorder*>(raw);
+        try {
+            auto id = ++self->nextConn;
+            std::unique_ptr<ProxyConn> conn(new ProxyConn(self, id, sock, SockAddr(peer, socklen)));
+            self->out.write(id, Open, nullptr, 0u);
+            self->conns[id] = std::move(conn);
+            self->nconns++;
+        }catch(std::exception& e){
+            log_exc_printf(app, "Unhandled error in accept callback: %s\n", e.what());
+            evutil_closesocket(sock);
+        }
+    }
+
+    static void onUDPS(evutil_socket_t sock, short evt, void *raw)
+    {
+        auto self = static_cast<Recorder*>(raw);
+        while(true) {
+            SockAddr src;
+            socklen_t alen = src.capacity();
+            auto ret = recvfrom(sock, (char*)self->scratch.data(), self->scratch.size(), 0, &src->sa, &alen);
+            if(ret < 0)
+                break; // EAGAIN, or error
+
+            // only capture datagrams containing searches
+            bool search = false;
+            std::vector<uint8_t> pkt(self->scratch.begin(), self->scratch.begin()+ret);
+            try {
+                splitMessages(pkt, [&search](const Header& H, const uint8_t*, size_t) {
+                    search |= H.cmd==CMD_SEARCH && !(H.flags&pva_flags::Control);
+                });
+            }catch(std::exception& e){
+                log_debug_printf(app, "Ignore invalid UDP from %s : %s\n", src.tostring().c_str(), e.what());
+                continue;
+            }
+            if(search) {
+                self->out.write(0u, Search, pkt.data(), pkt.size());
+                self->nsearches++;
+            }
+        }
+    }
+};
+
+ProxyConn::ProxyConn(Recorder* rec, uint32_t id, evutil_socket_t sock, const SockAddr& peer)
+    :rec(rec)
+    ,id(id)
+    ,peerName(peer.tostring())
+    ,down(__FILE__, __LINE__, bufferevent_socket_new(rec->loop.base, sock, BEV_OPT_CLOSE_ON_FREE|BEV_OPT_DEFER_CALLBACKS))
+    ,up(__FILE__, __LINE__, bufferevent_socket_new(rec->loop.base, -1, BEV_OPT_CLOSE_ON_FREE|BEV_OPT_DEFER_CALLBACKS))
+{
+    bufferevent_setcb(down.get(), &readDownS, nullptr, &eventDownS, this);
+    bufferevent_setcb(up.get(), &readUpS, nullptr, &eventUpS, this);
+
+    // output to upstream is buffered until connected
+    if(bufferevent_socket_connect(up.get(), const_cast<sockaddr*>(&rec->upstream->sa), rec->upstream.size()))
+        throw std::runtime_error(SB()<<"Unable to connect to "<<rec->upstream);
+
+    bufferevent_enable(down.get(), EV_READ|EV_WRITE);
+    bufferevent_enable(up.get(), EV_READ|EV_WRITE);
+
+    log_debug_printf(app, "%u Accept %s\n", unsigned(id), peerName.c_str());
+}
+
+void ProxyConn::onRead(bool fromClient)
+{
+    auto src = fromClient ? down.get() : up.get();
+    auto dst = fromClient ? up.get() : down.get();
+    auto& pending = fromClient ? toServer : toClient;
+
+    auto input = bufferevent_get_input(src);
+    auto n = evbuffer_get_length(input);
+    auto off = pending.size();
+    pending.resize(off + n);
+    evbuffer_copyout(input, &pending[off], n);
+    // forward unmodified
+    (void)evbuffer_add_buffer(bufferevent_get_output(dst), input);
+
+    try {
+        auto consumed = splitMessages(pending, [this, fromClient](const Header&, const uint8_t* msg, size_t len) {
+            rec->out.write(id, fromClient ? ToServer : ToClient, msg, len);
+            rec->nmessages++;
+        });
+        pending.erase(pending.begin(), pending.begin()+consumed);
+    }catch(std::exception& e){
+        log_err_printf(app, "%u %s : %s\n", unsigned(id), peerName.c_str(), e.what());
+        onEvent(fromClient, BEV_EVENT_ERROR);
+    }
+}
+
+void ProxyConn::onEvent(bool client, short events)
+{
+    if(events&BEV_EVENT_CONNECTED) {
+        log_debug_printf(app, "%u Connected upstream\n", unsigned(id));
+    }
+    if(events&(BEV_EVENT_EOF|BEV_EVENT_ERROR|BEV_EVENT_TIMEOUT)) {
+        log_debug_printf(app, "%u %s close by %s\n", unsigned(id), peerName.c_str(),
+                         client ? "client" : "server");
+        rec->out.write(id, Close, nullptr, 0u);
+        // destroys this
+        rec->conns.erase(id);
+    }
+}
+
+void ProxyConn::readDownS(struct bufferevent *bev, void *raw) { static_cast<ProxyConn*>(raw)->onRead(true); }
+void ProxyConn::readUpS(struct bufferevent *bev, void *raw) { static_cast<ProxyConn*>(raw)->onRead(false); }
+void ProxyConn::eventDownS(struct bufferevent *bev, short events, void *raw) { static_cast<ProxyConn*>(raw)->onEvent(true, events); }
+void ProxyConn::eventUpS(struct bufferevent *bev, short events, void *raw) { static_cast<ProxyConn*>(raw)->onEvent(false, events); }
+
+/******** Replay ********/
+
+struct Replayer;
+
+struct ReplayConn {
+    Replayer* const rep;
+    const uint32_t id;
+    evbufferevent bev;
+    // partial message from server
+    std::vector<uint8_t> rx;
+    // captured sid -> cid
+    std::map<uint32_t, uint32_t> capturedSID;
+    // cid -> live sid
+    std::map<uint32_t, uint32_t> liveSID;
+    // messages waiting for a live sid
+    std::deque<std::vector<uint8_t>> blocked;
+    // (cmd, cid or ioid) -> time sent
+    std::map<std::pair<uint8_t, uint32_t>, uint64_t> inflight;
+
+    ReplayConn(Replayer* rep, uint32_t id);
+
+    void send(std::vector<uint8_t>&& msg);
+    bool trySend(std::vector<uint8_t>& msg);
+    void learn(const std::vector<uint8_t>& msg);
+    void onRead();
+
+    static void readS(struct bufferevent *bev, void *raw) { static_cast<ReplayConn*>(raw)->onRead(); }
+    static void eventS(struct bufferevent *bev, short events, void *raw);
+};
+
+struct Replayer {
+    evbase loop;
+    const std::vector<Record> records;
+    const SockAddr target;
+    const double speed;
+    const uint64_t grace;
+    evsocket udpSock;
+    SockAddr udpTarget;
+    evevent timer, udpRx;
+    std::vector<uint8_t> scratch;
+
+    size_t next = 0u;
+    uint64_t start = 0u;
+    bool draining = false;
+    bool finished = false;
+    std::map<uint32_t, std::unique_ptr<ReplayConn>> conns;
+    // searchID -> time sent
+    std::map<uint32_t, uint64_t> searches;
+    // response times by command
+    std::map<uint8_t, TimeHistogram> latency;
+    uint64_t nsent = 0u, nrecv = 0u, nsearch = 0u, nerror = 0u, nunanswered = 0u;
+    double elapsed = 0.0;
+    epicsEvent done;
+
+    Replayer(std::vector<Record>&& records, const SockAddr& target, const SockAddr* udp, double speed, double grace)
+        :loop("PVXREPLAY")
+        ,records(std::move(records))
+        ,target(target)
+        ,speed(speed)
+        ,grace(uint64_t(grace*1e9))
+        ,scratch(0x10000)
+    {
+        if(udp) {
+            udpTarget = *udp;
+            udpSock = evsocket(udp->family(), SOCK_DGRAM, 0);
+            udpSock.bind(SockAddr::any(udp->family()));
+        }
+
+        loop.call([this]() {
+            timer = evevent(__FILE__, __LINE__,
+                            event_new(loop.base, -1, EV_TIMEOUT, &onTimerS, this));
+            if(udpSock) {
+                udpRx = evevent(__FILE__, __LINE__,
+                                event_new(loop.base, udpSock.sock, EV_READ|EV_PERSIST, &onUDPS, this));
+                if(event_add(udpRx.get(), nullptr))
+                    throw std::runtime_error("Unable to begin listening for UDP");
+            }
+            start = monotonicNS();
+            onTimer();
+        });
+    }
+
+    ~Replayer()
+    {
+        loop.call([this]() {
+            timer.reset();
+            udpRx.reset();
+            conns.clear();
+        });
+    }
+
+    void arm(uint64_t delay)
+    {
+        timeval tv{};
+        tv.tv_sec = delay/1000000000u;
+        tv.tv_usec = (delay%1000000000u)/1000u;
+        if(event_add(timer.get(), &tv))
+            throw std::runtime_error("Unable to arm replay timer");
+    }
+
+    void onTimer()
+    {
+        auto now(monotonicNS());
+        while(next < records.size()) {
+            auto& rec = records[next];
+            auto due = start + (speed > 0.0 ? uint64_t(rec.time/speed) : 0u);
+            if(due > now) {
+                arm(due - now);
+                return;
+            }
+            try {
+                process(rec);
+            }catch(std::exception& e){
+                log_err_printf(app, "Record %zu conn %u error: %s\n", next, unsigned(rec.conn), e.what());
+                nerror++;
+            }
+            next++;
+        }
+
+        if(!draining) {
+            draining = true;
+            elapsed = double(now - start)*1e-9;
+            log_info_printf(app, "Sent all.  Waiting %.1f sec. for responses\n", grace*1e-9);
+            arm(grace);
+            return;
+        }
+
+        finish();
+    }
+
+    void finish()
+    {
+        if(finished)
+            return;
+        finished = true;
+        if(!draining)
+            elapsed = double(monotonicNS() - start)*1e-9;
+        event_del(timer.get());
+
+        for(auto& pair : conns)
+            nunanswered += pair.second->inflight.size();
+        nunanswered += searches.size();
+        done.signal();
+    }
+
+    void process(const Record& rec)
+    {
+        switch(rec.kind) {
+        case Open: {
+            std::unique_ptr<ReplayConn> conn(new ReplayConn(this, rec.conn));
+            conns[rec.conn] = std::move(conn);
+        }
+            break;
+        case Close: {
+            auto it(conns.find(rec.conn));
+            if(it!=conns.end()) {
+                nunanswered += it->second->inflight.size();
+                conns.erase(it);
+            }
+        }
+            break;
+        case ToServer: {
+            auto it(conns.find(rec.conn));
+            if(it!=conns.end())
+                it->second->send(std::vector<uint8_t>(rec.msg));
+        }
+            break;
+        case ToClient: {
+            auto it(conns.find(rec.conn));
+            if(it!=conns.end())
+                it->second->learn(rec.msg);
+        }
+            break;
+        case Search:
+            if(udpSock)
+                sendSearch(rec.msg);
+            break;
+        default:
+            throw std::runtime_error(SB()<<"Unknown record kind "<<unsigned(rec.kind));
+        }
+    }
+
+    void sendSearch(const std::vector<uint8_t>& capture)
+    {
+        auto pkt(capture);
+        const auto replyPort = udpSock.sockname().port();
+        auto now(monotonicNS());
+
+        splitMessages(pkt, [this, replyPort, now](const Header& H, const uint8_t* cmsg, size_t len) {
+            if(H.cmd!=CMD_SEARCH || (H.flags&pva_flags::Control))
+                return;
+            auto msg = const_cast<uint8_t*>(cmsg);
+            // searchID, flags, reserved[3], responseAddress[16], responsePort
+            FixedBuf M(H.flags&pva_flags::MSB, msg+8u, len-8u);
+            uint32_t searchID = 0u;
+            from_wire(M, searchID);
+            if(!M.good() || M.size() < 4u+16u+2u)
+                return;
+            M[0] |= pva_search_flags::Unicast;
+            M._skip(4u);
+            // reply to the source address of this datagram
+            to_wire(M, SockAddr::any(AF_INET));
+            to_wire(M, uint16_t(replyPort));
+            if(M.good()) {
+                searches[searchID] = now;
+                nsearch++;
+            }
+        });
+
+        auto ret = sendto(udpSock.sock, (char*)pkt.data(), pkt.size(), 0,
+                          &udpTarget->sa, udpTarget.size());
+        if(ret!=ev_ssize_t(pkt.size()))
+            nerror++;
+    }
+
+    static void onTimerS(evutil_socket_t sock, short evt, void *raw)
+    {
+        static_cast<Replayer*>(raw)->onTimer();
+    }
+
+    static void onUDPS(evutil_socket_t sock, short evt, void *raw)
+    {
+        auto self = static_cast<Replayer*>(raw);
+        while(true) {
+            auto ret = recv(sock, (char*)self->scratch.data(), self->scratch.size(), 0);
+            if(ret < 0)
+                break;
+            auto now(monotonicNS());
+            std::vector<uint8_t> pkt(self->scratch.begin(), self->scratch.begin()+ret);
+            try {
+                splitMessages(pkt, [self, now](const Header& H, const uint8_t* msg, size_t len) {
+                    if(H.cmd!=CMD_SEARCH_RESPONSE || (H.flags&pva_flags::Control))
+                        return;
+                    // GUID, searchID, ...
+                    FixedBuf M(H.flags&pva_flags::MSB, const_cast<uint8_t*>(msg)+8u, len-8u);
+                    M.skip(12u, __FILE__, __LINE__);
+                    uint32_t searchID = 0u;
+                    from_wire(M, searchID);
+                    auto it(self->searches.find(searchID));
+                    if(M.good() && it!=self->searches.end()) {
+                        self->latency[CMD_SEARCH].sample(now - it->second);
+                        self->searches.erase(it);
+                    }
+                });
+            }catch(std::exception& e){
+                log_debug_printf(app, "Ignore invalid UDP: %s\n", e.what());
+            }
+        }
+    }
+
+    void report(std::ostream& strm) const
+    {
+        strm<<"# Replayed "<<records.size()<<" records in "<<elapsed<<" sec."
+              "  Sent "<<nsent<<" messages, "<<nsearch<<" searches.  Received "<<nrecv<<" messages.\n"
+              "# "<<nunanswered<<" requests unanswered.  "<<nerror<<" errors.\n"
+              "# Response times (sec.)\n";
+        for(auto& pair : latency)
+            strm<<cmdName(pair.first)<<" "<<pair.second<<"\n";
+    }
+};
+
+ReplayConn::ReplayConn(Replayer* rep, uint32_t id)
+    :rep(rep)
+    ,id(id)
+    ,bev(__FILE__, __LINE__, bufferevent_socket_new(rep->loop.base, -1, BEV_OPT_CLOSE_ON_FREE|BEV_OPT_DEFER_CALLBACKS))
+{
+    bufferevent_setcb(bev.get(), &readS, nullptr, &eventS, this);
+
+    if(bufferevent_socket_connect(bev.get(), const_cast<sockaddr*>(&rep->target->sa), rep->target.size()))
+        throw std::runtime_error(SB()<<"Unable to connect to "<<rep->target);
+
+    bufferevent_enable(bev.get(), EV_READ|EV_WRITE);
+}
+
+void ReplayConn::send(std::vector<uint8_t>&& msg)
+{
+    // preserve order behind any message waiting for a sid
+    if(!blocked.empty() || !trySend(msg))
+        blocked.push_back(std::move(msg));
+}
+
+// map captured sid to live sid, and send.
+// returns false if the live sid is not yet known.
+bool ReplayConn::trySend(std::vector<uint8_t>& msg)
+{
+    FixedBuf M(false, msg.data(), msg.size());
+    Header H;
+    from_wire(M, H);
+    if(!M.good())
+        throw std::runtime_error("Invalid captured message");
+
+    if(isFirst(H)) {
+        if(hasSID(H.cmd)) {
+            auto save = M.save();
+            uint32_t sid = 0u, ioid = 0u;
+            from_wire(M, sid);
+            from_wire(M, ioid);
+            uint8_t subcmd = M.good() && !M.empty() ? M[0] : 0u;
+
+            auto cid(capturedSID.find(sid));
+            if(cid!=capturedSID.end()) {
+                auto live(liveSID.find(cid->second));
+                if(live==liveSID.end())
+                    return false;
+                FixedBuf W(M.be, save, 4u);
+                to_wire(W, live->second);
+            }
+
+            // time requests which expect a reply.  Not destroy, or monitor ack/stop.
+            if(M.good() && isOp(H.cmd) && !(subcmd&uint8_t(pva_subcmd::Destroy))
+                    && (H.cmd!=CMD_MONITOR || (subcmd&(uint8_t(pva_subcmd::Init)|uint8_t(pva_subcmd::Get))))) {
+                inflight[std::make_pair(H.cmd, ioid)] = monotonicNS();
+            }
+
+        } else if(H.cmd==CMD_CREATE_CHANNEL) {
+            // count, then (cid, name) pairs
+            uint16_t count = 0u;
+            from_wire(M, count);
+            auto now(monotonicNS());
+            for(auto i : range(count)) {
+                (void)i;
+                uint32_t cid = 0u;
+                std::string name;
+                from_wire(M, cid);
+                from_wire(M, name);
+                if(M.good())
+                    inflight[std::make_pair(uint8_t(CMD_CREATE_CHANNEL), cid)] = now;
+            }
+        }
+    }
+
+    bufferevent_write(bev.get(), msg.data(), msg.size());
+    rep->nsent++;
+    return true;
+}
+
+// learn captured sid assignments from captured server messages
+void ReplayConn::learn(const std::vector<uint8_t>& msg)
+{
+    FixedBuf M(false, const_cast<uint8_t*>(msg.data()), msg.size());
+    Header H;
+    from_wire(M, H);
+    if(M.good() && isFirst(H) && H.cmd==CMD_CREATE_CHANNEL) {
+        uint32_t cid = 0u, sid = 0u;
+        from_wire(M, cid);
+        from_wire(M, sid);
+        if(M.good())
+            capturedSID[sid] = cid;
+    }
+}
+
+void ReplayConn::onRead()
+{
+    auto input = bufferevent_get_input(bev.get());
+    auto n = evbuffer_get_length(input);
+    auto off = rx.size();
+    rx.resize(off + n);
+    evbuffer_remove(input, &rx[off], n);
+    auto now(monotonicNS());
+    bool unblock = false;
+
+    try {
+        auto consumed = splitMessages(rx, [this, now, &unblock](const Header& H, const uint8_t* msg, size_t len) {
+            rep->nrecv++;
+            if(!isFirst(H))
+                return;
+
+            FixedBuf M(H.flags&pva_flags::MSB, const_cast<uint8_t*>(msg)+8u, len-8u);
+            uint32_t ioid = 0u;
+            from_wire(M, ioid);
+
+            if(H.cmd==CMD_CREATE_CHANNEL) {
+                // cid, sid, status
+                uint32_t sid = 0u;
+                from_wire(M, sid);
+                if(M.good()) {
+                    liveSID[ioid] = sid;
+                    unblock = true;
+                }
+
+            } else if(!isOp(H.cmd)) {
+                return;
+            }
+
+            auto it(inflight.find(std::make_pair(H.cmd, ioid)));
+            if(M.good() && it!=inflight.end()) {
+                rep->latency[H.cmd].sample(now - it->second);
+                inflight.erase(it);
+            }
+        });
+        rx.erase(rx.begin(), rx.begin()+consumed);
+    }catch(std::exception& e){
+        log_err_printf(app, "%u : %s\n", unsigned(id), e.what());
+        rep->nerror++;
+        rep->conns.erase(id); // destroys this
+        return;
+    }
+
+    while(unblock && !blocked.empty() && trySend(blocked.front()))
+        blocked.pop_front();
+}
+
+void ReplayConn::eventS(struct bufferevent *bev, short events, void *raw)
+{
+    auto self = static_cast<ReplayConn*>(raw);
+    if(events&(BEV_EVENT_EOF|BEV_EVENT_ERROR|BEV_EVENT_TIMEOUT)) {
+        log_warn_printf(app, "%u closed by server\n", unsigned(self->id));
+        self->rep->nunanswered += self->inflight.size();
+        self->rep->nerror++;
+        self->rep->conns.erase(self->id); // destroys self
+    }
+}
+
+SockAddr parseAddr(const char* optarg, unsigned short defport, bool allowPortOnly)
+{
+    try {
+        std::string arg(optarg);
+        if(allowPortOnly && arg.find_first_not_of("0123456789")==std::string::npos)
+            return SockAddr::any(AF_INET, parseTo<uint64_t>(arg));
+        return SockAddr(arg, defport);
+    }catch(std::exception& e){
+        throw std::runtime_error(SB()<<"Invalid address '"<<escape(optarg)<<"' : "<<e.what());
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    try {
+        SockAttach attach;
+        logger_level_set("pvxreplay", Level::Info);
+        logger_config_env();
+
+        std::string outfile, infile;
+        std::unique_ptr<SockAddr> bindAddr, server, udp;
+        double speed = 1.0, grace = 2.0, duration = 0.0;
+
+        {
+            int opt;
+            while ((opt = getopt(argc, argv, "hVvo:i:L:S:U:T:x:W:")) != -1) {
+                switch(opt) {
+                case 'h':
+                    usage(argv[0]);
+                    return 0;
+                case 'V':
+                    std::cout<<pvxs::version_information;
+                    return 0;
+                case 'v':
+                    logger_level_set("pvxreplay", Level::Debug);
+                    break;
+                case 'o':
+                    outfile = optarg;
+                    break;
+                case 'i':
+                    infile = optarg;
+                    break;
+                case 'L':
+                    bindAddr.reset(new SockAddr(parseAddr(optarg, 5075, true)));
+                    break;
+                case 'S':
+                    server.reset(new SockAddr(parseAddr(optarg, 5075, false)));
+                    break;
+                case 'U':
+                    udp.reset(new SockAddr(parseAddr(optarg, 5076, true)));
+                    break;
+                case 'T':
+                    duration = parseTo<double>(optarg);
+                    break;
+                case 'x':
+                    speed = parseTo<double>(optarg);
+                    break;
+                case 'W':
+                    grace = parseTo<double>(optarg);
+                    break;
+                default:
+                    usage(argv[0]);
+                    std::cerr<<"\nUnknown argument: "<<char(opt)<<std::endl;
+                    return 1;
+                }
+            }
+        }
+
+        if(outfile.empty()==infile.empty() || !server || (!outfile.empty() && !bindAddr) || optind!=argc) {
+            usage(argv[0]);
+            std::cerr<<"\nExpected exactly one of -o or -i, and -S.  -o requires -L."<<std::endl;
+            return 1;
+        }
+
+        epicsEvent interrupted;
+        SigInt sig([&interrupted]() {
+            interrupted.signal();
+        });
+
+        if(!outfile.empty()) {
+            Recorder rec(outfile, *bindAddr, *server, udp.get());
+
+            if(duration > 0.0)
+                interrupted.wait(duration);
+            else
+                interrupted.wait();
+
+            uint64_t nrecord = 0u, nmessages = 0u, nsearches = 0u, nconns = 0u;
+            rec.loop.call([&]() {
+                nrecord = rec.out.nrecord;
+                nmessages = rec.nmessages;
+                nsearches = rec.nsearches;
+                nconns = rec.nconns;
+            });
+            std::cout<<"# Captured "<<nconns<<" connections, "<<nmessages<<" messages, "
+                     <<nsearches<<" search datagrams.  "<<nrecord<<" records.\n";
+
+        } else {
+            auto records(readCapture(infile));
+            log_info_printf(app, "Replay %zu records from %s\n", records.size(), infile.c_str());
+
+            Replayer rep(std::move(records), *server, udp.get(), speed, grace);
+
+            // wait for completion, or SIGINT
+            while(!rep.done.wait(0.1) && !interrupted.tryWait()) {}
+
+            rep.loop.call([&rep]() {
+                rep.finish();
+                rep.report(std::cout);
+            });
+        }
+
+        return 0;
+
+    }catch(std::exception& e){
+        std::cerr<<"Error: "<<e.what()<<std::endl;
+        return 1;
+    }
+}